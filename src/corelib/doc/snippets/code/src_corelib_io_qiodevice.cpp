@@ -60,3 +60,17 @@ bool isExeFile(QFile *file)
     return file->peek(2) == "MZ";
 }
 //! [5]
+
+
+//! [6]
+void processAvailableData(QIODevice *device)
+{
+    QByteArrayView chunk;
+    while (!(chunk = device->peekChunk()).isEmpty()) {
+        const qsizetype consumed = parse(chunk);   // may use only part of the data
+        device->skip(consumed);
+        if (consumed < chunk.size())
+            break;
+    }
+}
+//! [6]
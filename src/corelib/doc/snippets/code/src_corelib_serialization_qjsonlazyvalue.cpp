@@ -0,0 +1,17 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+//! [0]
+void Router::route(const QByteArray &request)
+{
+    QJsonParseError error;
+    const QJsonLazyValue message = QJsonLazyValue::fromJson(request, &error);
+    if (error.error != QJsonParseError::NoError)
+        return reject(error.errorString());
+
+    // only the header is converted; the payload is passed on as it is
+    const QJsonLazyValue header = message["header"];
+    Backend *backend = backendFor(header["service"].toString(), header["version"].toInt());
+    backend->send(message["payload"].rawJson());
+}
+//! [0]
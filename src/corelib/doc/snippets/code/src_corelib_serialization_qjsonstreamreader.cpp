@@ -0,0 +1,23 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+//! [0]
+    // counts the failed requests in a newline-delimited JSON log
+    QJsonStreamReader reader(&logFile);
+    qint64 failures = 0;
+    while (reader.readNext() != QJsonStreamReader::NoToken) {
+        if (reader.hasError())
+            return reportError(reader.errorString(), reader.offset());
+
+        // only look at the members of the top-level objects
+        if (reader.isName() && reader.depth() == 1) {
+            if (reader.text() == u"status") {
+                reader.readNext();
+                if (reader.isNumber() && reader.toInteger() >= 500)
+                    ++failures;
+            } else {
+                reader.skipValue();
+            }
+        }
+    }
+//! [0]
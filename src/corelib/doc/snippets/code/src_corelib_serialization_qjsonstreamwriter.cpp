@@ -0,0 +1,18 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+//! [0]
+    QJsonStreamWriter writer(&file);
+    writer.setFormat(QJsonDocument::Compact);
+    for (const Measurement &m : measurements) {
+        writer.startObject();
+        writer.writeName("sensor");
+        writer.append(m.sensorName);
+        writer.writeName("values");
+        writer.startArray();
+        for (double value : m.values)
+            writer.append(value);
+        writer.endArray();
+        writer.endObject();
+    }
+//! [0]
@@ -0,0 +1,17 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+//! [0]
+    QStringPool *pool = QStringPool::globalInstance();
+    QList<QVariantMap> records;
+    for (const QByteArray &line : lines) {
+        QVariantMap record;
+        for (const QByteArray &field : line.split(';')) {
+            const qsizetype colon = field.indexOf(':');
+            // all records share the same allocation for each field name
+            const QString name = pool->intern(QString::fromUtf8(field.left(colon)));
+            record.insert(name, QString::fromUtf8(field.mid(colon + 1)));
+        }
+        records.append(record);
+    }
+//! [0]
@@ -0,0 +1,16 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+//! [0]
+    QBTreeMap<QString, QVariant> settings;
+    settings.insert("window/width", 800);
+    settings.insert("window/height", 600);
+    settings.insert("editor/font", "Monospace");
+
+    // the items are visited in ascending key order
+    for (auto it = settings.lowerBound("window/"); it != settings.cend(); ++it) {
+        if (!it.key().startsWith("window/"))
+            break;
+        qDebug() << it.key() << it.value();
+    }
+//! [0]
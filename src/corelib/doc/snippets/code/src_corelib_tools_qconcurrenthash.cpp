@@ -0,0 +1,23 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+//! [0]
+    // shared by all worker threads
+    QConcurrentHash<QString, QHostAddress> addressCache;
+
+    QHostAddress lookup(const QString &hostName)
+    {
+        QHostAddress address = addressCache.value(hostName);
+        if (address.isNull()) {
+            address = resolve(hostName);
+            addressCache.insert(hostName, address);
+        }
+        return address;
+    }
+//! [0]
+
+//! [1]
+    const auto snapshot = sessions.snapshot();
+    for (auto it = snapshot.begin(); it != snapshot.end(); ++it)
+        qDebug() << it.key() << it.value().lastActivity;
+//! [1]
@@ -578,7 +578,8 @@ uint64_t QT_MANGLE_NAMESPACE(qDetectCpuFeatures)()
         while (char *token = strtok(disable, " ")) {
             disable = nullptr;
             for (uint i = 0; i < std::size(features_indices); ++i) {
-                if (strcmp(token, features_string + features_indices[i]) == 0)
+                // skip the space that separates the names in features_string
+                if (strcmp(token, features_string + features_indices[i] + 1) == 0)
                     f &= ~(Q_UINT64_C(1) << i);
             }
         }
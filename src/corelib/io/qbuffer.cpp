@@ -22,6 +22,7 @@ public:
 
     qint64 peek(char *data, qint64 maxSize) override;
     QByteArray peek(qint64 maxSize) override;
+    QByteArrayView peekChunk() override;
 
 #ifndef QT_NO_QOBJECT
     // private slots
@@ -59,6 +60,14 @@ QByteArray QBufferPrivate::peek(qint64 maxSize)
     return QByteArray(buf->constData() + pos, readBytes);
 }
 
+QByteArrayView QBufferPrivate::peekChunk()
+{
+    // ungetChar() puts data into the QIODevice buffer
+    if ((openMode & QIODevice::Text) || !buffer.isEmpty())
+        return QIODevicePrivate::peekChunk();
+    return QByteArrayView(*buf).sliced(qMin(pos, static_cast<qint64>(buf->size())));
+}
+
 /*!
     \class QBuffer
     \inmodule QtCore
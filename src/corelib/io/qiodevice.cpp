@@ -1853,6 +1853,37 @@ QByteArray QIODevicePrivate::peek(qint64 maxSize)
     return result;
 }
 
+/*!
+    \internal
+*/
+QByteArrayView QIODevicePrivate::peekChunk()
+{
+    Q_Q(QIODevice);
+
+    // Text mode translation doesn't happen in place
+    if (openMode & QIODevice::Text)
+        return QByteArrayView();
+
+    const bool sequential = isSequential();
+    // Sequential devices keep the data read in a transaction in the buffer
+    const qint64 offset = (sequential && transactionStarted) ? transactionPos : 0;
+    if (buffer.size() <= offset && (sequential || pos == devicePos || q->seek(pos))) {
+        // Try to fill the buffer by single read, as read() would do
+        const qint64 bytesToBuffer = buffer.chunkSize();
+        const qint64 readFromDevice = q->readData(buffer.reserve(bytesToBuffer), bytesToBuffer);
+        buffer.chop(bytesToBuffer - qMax(Q_INT64_C(0), readFromDevice));
+        if (readFromDevice > 0 && !sequential)
+            devicePos += readFromDevice;
+    }
+
+    if (buffer.size() <= offset)
+        return QByteArrayView();
+
+    qint64 length;
+    const char *data = buffer.readPointerAtPosition(offset, length);
+    return QByteArrayView(data, length);
+}
+
 /*! \fn bool QIODevice::getChar(char *c)
 
     Reads one character from the device and stores it in \a c. If \a c
@@ -1923,6 +1954,43 @@ QByteArray QIODevice::peek(qint64 maxSize)
     return d->peek(maxSize);
 }
 
+/*!
+    \since 6.5
+
+    Returns a view of the next contiguous block of data available for
+    reading, without copying it and without side effects (i.e., if you call
+    read() after peekChunk(), you will get the same data). An empty view is
+    returned if no data is available, or if an error occurs, such as when
+    attempting to peek a device opened in WriteOnly mode.
+
+    If the device's read buffer is empty, this function fills it with a single
+    read from the device, without waiting for more data to arrive. The view
+    covers at most one block of the buffer; the data following it can be
+    obtained by calling skip() with the size of the view, and then calling
+    peekChunk() again:
+
+    \snippet code/src_corelib_io_qiodevice.cpp 6
+
+    Calling read() with the size of the view instead returns the same data
+    as a QByteArray that, in most cases, shares the buffer block instead of
+    copying it.
+
+    The view stays valid until the next call of a non-const function of the
+    device, or until control returns to the event loop. This function does
+    not work on devices opened in Text mode, and always returns an empty
+    view for them.
+
+    \sa peek(), skip(), read()
+*/
+QByteArrayView QIODevice::peekChunk()
+{
+    Q_D(QIODevice);
+
+    CHECK_READABLE(peekChunk, QByteArrayView());
+
+    return d->peekChunk();
+}
+
 /*!
     \since 5.10
 
@@ -1957,9 +2025,25 @@ qint64 QIODevice::skip(qint64 maxSize)
            this, maxSize, d->pos, d->buffer.size());
 #endif
 
-    if ((sequential && d->transactionStarted) || (d->openMode & QIODevice::Text) != 0)
+    if ((d->openMode & QIODevice::Text) != 0)
         return d->skipByReading(maxSize);
 
+    if (sequential && d->transactionStarted) {
+        // The buffer has to be kept for a possible rollback, so move the
+        // transaction position past the buffered data instead of discarding it.
+        const qint64 skippedInBuffer = qMin(maxSize, d->buffer.size() - d->transactionPos);
+        d->transactionPos += skippedInBuffer;
+        if (skippedInBuffer == maxSize)
+            return skippedInBuffer;
+
+        const qint64 skipResult = d->skipByReading(maxSize - skippedInBuffer);
+        if (skippedInBuffer == 0)
+            return skipResult;
+        if (skipResult == -1)
+            return skippedInBuffer;
+        return skippedInBuffer + skipResult;
+    }
+
     // First, skip over any data in the internal buffer.
     qint64 skippedSoFar = 0;
     if (!d->buffer.isEmpty()) {
@@ -91,6 +91,7 @@ public:
 
     qint64 peek(char *data, qint64 maxlen);
     QByteArray peek(qint64 maxlen);
+    QByteArrayView peekChunk();
     qint64 skip(qint64 maxSize);
 
     virtual bool waitForReadyRead(int msecs);
@@ -148,6 +148,7 @@ public:
     qint64 readLine(char *data, qint64 maxSize);
     virtual qint64 peek(char *data, qint64 maxSize);
     virtual QByteArray peek(qint64 maxSize);
+    virtual QByteArrayView peekChunk();
     qint64 skipByReading(qint64 maxSize);
     void write(const char *data, qint64 size);
 
@@ -323,7 +323,10 @@ Q_CONSTINIT bool QCoreApplicationPrivate::is_app_closing = false;
 
 qsizetype qGlobalPostedEventsCount()
 {
-    const QPostEventList &l = QThreadData::current()->postEventList;
+    QThreadData *data = QThreadData::current();
+    const auto locker = qt_scoped_lock(data->postEventList.mutex);
+    data->flushPostEventInbox();
+    const QPostEventList &l = data->postEventList;
     return l.size() - l.startOffset;
 }
 
@@ -472,6 +475,7 @@ void QCoreApplicationPrivate::cleanupThreadData()
 
         // need to clear the state of the mainData, just in case a new QCoreApplication comes along.
         const auto locker = qt_scoped_lock(thisThreadData->postEventList.mutex);
+        thisThreadData->flushPostEventInbox();
         for (const QPostEvent &pe : std::as_const(thisThreadData->postEventList)) {
             if (pe.event) {
                 --pe.receiver->d_func()->postedEvents;
@@ -1518,6 +1522,11 @@ QCoreApplicationPrivate::QPostEventListLocker QCoreApplicationPrivate::lockThrea
     details. Events with equal \a priority will be processed in the
     order posted.
 
+    Events of type QEvent::MetaCall, as posted for queued signal-slot
+    connections, are handed to the receiver's thread without locking its
+    event queue when posted with Qt::NormalEventPriority. They are not
+    subject to event compression.
+
     \threadsafe
 
     \sa sendEvent(), notify(), sendPostedEvents(), Qt::EventPriority
@@ -1535,6 +1544,29 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
         return;
     }
 
+    if (priority == Qt::NormalEventPriority && event->type() == QEvent::MetaCall) {
+        // Queued calls are never compressed, so there is nothing to look up
+        // in the queue; push the event to the inbox without taking the lock.
+        // If the receiver moves to another thread in the meantime, the event
+        // is forwarded when the inbox is flushed.
+        QThreadData *data = receiver->d_func()->threadData.loadAcquire();
+        if (!data) {
+            // posting during destruction? just delete the event to prevent a leak
+            delete event;
+            return;
+        }
+
+        Q_TRACE(QCoreApplication_postEvent_event_posted, receiver, event, event->type());
+        event->m_posted = true;
+        ++receiver->d_func()->postedEvents;
+        data->postEventList.pushToInbox(receiver, static_cast<QAbstractMetaCallEvent *>(event));
+
+        QAbstractEventDispatcher* dispatcher = data->eventDispatcher.loadAcquire();
+        if (dispatcher)
+            dispatcher->wakeUp();
+        return;
+    }
+
     auto locker = QCoreApplicationPrivate::lockThreadPostEventList(receiver);
     if (!locker.threadData) {
         // posting during destruction? just delete the event to prevent a leak
@@ -1544,6 +1576,9 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
 
     QThreadData *data = locker.threadData;
 
+    // keep the order of events with the same priority that went through the inbox
+    data->flushPostEventInbox();
+
     // if this is one of the compressible events, do compression
     if (receiver->d_func()->postedEvents
         && self && self->compressEvent(event, receiver, &data->postEventList)) {
@@ -1687,6 +1722,7 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
     ++data->postEventList.recursion;
 
     auto locker = qt_unique_lock(data->postEventList.mutex);
+    data->flushPostEventInbox();
 
     // by default, we assume that the event dispatcher can go to sleep after
     // processing all events. if any new events are posted while we send
@@ -1849,6 +1885,8 @@ void QCoreApplication::removePostedEvents(QObject *receiver, int eventType)
     if (receiver && !receiver->d_func()->postedEvents)
         return;
 
+    data->flushPostEventInbox();
+
     //we will collect all the posted events for the QObject
     //and we'll delete after the mutex was unlocked
     QVarLengthArray<QEvent*> events;
@@ -1904,6 +1942,7 @@ void QCoreApplicationPrivate::removePostedEvent(QEvent * event)
     QThreadData *data = QThreadData::current();
 
     const auto locker = qt_scoped_lock(data->postEventList.mutex);
+    data->flushPostEventInbox();
 
     if (data->postEventList.size() == 0) {
 #if defined(QT_DEBUG)
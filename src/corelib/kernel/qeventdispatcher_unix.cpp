@@ -191,13 +191,140 @@ QEventDispatcherUNIXPrivate::QEventDispatcherUNIXPrivate()
 {
     if (Q_UNLIKELY(threadPipe.init() == false))
         qFatal("QEventDispatcherUNIXPrivate(): Cannot continue without a thread pipe");
+
+#if QT_CONFIG(epoll)
+    if (qEnvironmentVariableIntValue("QT_EVENT_DISPATCHER_EPOLL") > 0)
+        initEpoll();
+#endif
 }
 
 QEventDispatcherUNIXPrivate::~QEventDispatcherUNIXPrivate()
 {
-    // cleanup timers
-    qDeleteAll(timerList);
+#if QT_CONFIG(epoll)
+    if (epollFd >= 0)
+        qt_safe_close(epollFd);
+#endif
+}
+
+#if QT_CONFIG(epoll)
+static_assert(EPOLLIN == POLLIN && EPOLLOUT == POLLOUT && EPOLLPRI == POLLPRI
+              && EPOLLERR == POLLERR && EPOLLHUP == POLLHUP,
+              "epoll and poll event flags are expected to be interchangeable");
+
+bool QEventDispatcherUNIXPrivate::initEpoll()
+{
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        qErrnoWarning("QEventDispatcherUNIX: epoll_create1() failed, falling back to poll()");
+        return false;
+    }
+
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = threadPipe.fds[0];
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, ev.data.fd, &ev) == -1) {
+        qErrnoWarning("QEventDispatcherUNIX: cannot watch the thread pipe, falling back to poll()");
+        qt_safe_close(epollFd);
+        epollFd = -1;
+        return false;
+    }
+
+    epollEvents.resize(epollEvents.capacity());
+    return true;
+}
+
+void QEventDispatcherUNIXPrivate::updateEpollInterest(int fd, short oldEvents, short newEvents)
+{
+    Q_ASSERT(epollFd >= 0);
+
+    if (epollUnsupportedFds.contains(fd)) {
+        if (!newEvents)
+            epollUnsupportedFds.removeOne(fd);
+        return;
+    }
+
+    epoll_event ev = {};
+    ev.events = quint32(newEvents);
+    ev.data.fd = fd;
+
+    const int op = !newEvents ? EPOLL_CTL_DEL : oldEvents ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    int ret = epoll_ctl(epollFd, op, fd, &ev);
+    if (ret == 0 || !newEvents) {
+        // a failed removal means the descriptor was already closed, which
+        // implicitly dropped it from the interest set
+        return;
+    }
+
+    // the descriptor may have been closed and reused behind our back
+    if (errno == EEXIST)
+        ret = epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev);
+    else if (errno == ENOENT)
+        ret = epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+
+    if (ret == 0)
+        return;
+
+    if (errno == EPERM)
+        epollUnsupportedFds.append(fd);
+    else
+        qErrnoWarning("QEventDispatcherUNIX: cannot watch socket %d", fd);
+}
+
+int QEventDispatcherUNIXPrivate::epollWait(const timespec *tm)
+{
+    Q_ASSERT(epollFd >= 0);
+
+    int timeout = -1;
+    if (!epollUnsupportedFds.isEmpty()) {
+        timeout = 0;
+    } else if (tm) {
+        // round up, so that we don't wake up before the next timer is due
+        const qint64 msecs = qint64(tm->tv_sec) * 1000 + (tm->tv_nsec + 999999) / 1000000;
+        timeout = int(qMin(msecs, qint64(std::numeric_limits<int>::max())));
+    }
+
+    // level-triggered: whatever doesn't fit is reported again on the next call
+    const qsizetype wanted = qMin(socketNotifiers.size() + 1, qsizetype(4096));
+    if (epollEvents.size() < wanted)
+        epollEvents.resize(wanted);
+
+    const int n = epoll_wait(epollFd, epollEvents.data(), int(epollEvents.size()), timeout);
+    if (n == -1) {
+        if (errno == EINTR)
+            return 0;
+        return -1;
+    }
+
+    pollfd wakeUpFd = threadPipe.prepare();
+    for (int i = 0; i < n; ++i) {
+        const epoll_event &ev = epollEvents.at(i);
+        if (ev.data.fd == wakeUpFd.fd) {
+            wakeUpFd.revents = short(ev.events);
+            continue;
+        }
+
+        auto it = socketNotifiers.constFind(ev.data.fd);
+        if (it == socketNotifiers.cend())
+            continue;
+
+        pollfd pfd = qt_make_pollfd(ev.data.fd, it.value().events());
+        pfd.revents = short(ev.events);
+        pollfds.append(pfd);
+    }
+
+    for (int fd : qAsConst(epollUnsupportedFds)) {
+        pollfd pfd = qt_make_pollfd(fd, socketNotifiers.value(fd).events());
+        pfd.revents = pfd.events & (POLLIN | POLLOUT);
+        if (pfd.revents)
+            pollfds.append(pfd);
+    }
+
+    // This must be last, as it's popped off the end by processEvents()
+    pollfds.append(wakeUpFd);
+
+    return int(pollfds.size()) - (wakeUpFd.revents ? 0 : 1);
 }
+#endif // QT_CONFIG(epoll)
 
 void QEventDispatcherUNIXPrivate::setSocketNotifierPending(QSocketNotifier *notifier)
 {
@@ -376,7 +503,16 @@ void QEventDispatcherUNIX::registerSocketNotifier(QSocketNotifier *notifier)
         qWarning("%s: Multiple socket notifiers for same socket %d and type %s",
                  Q_FUNC_INFO, sockfd, socketType(type));
 
+#if QT_CONFIG(epoll)
+    const short oldEvents = sn_set.events();
+#endif
+
     sn_set.notifiers[type] = notifier;
+
+#if QT_CONFIG(epoll)
+    if (d->epollFd >= 0 && sn_set.events() != oldEvents)
+        d->updateEpollInterest(sockfd, oldEvents, sn_set.events());
+#endif
 }
 
 void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
@@ -415,8 +551,17 @@ void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
         return;
     }
 
+#if QT_CONFIG(epoll)
+    const short oldEvents = sn_set.events();
+#endif
+
     sn_set.notifiers[type] = nullptr;
 
+#if QT_CONFIG(epoll)
+    if (d->epollFd >= 0)
+        d->updateEpollInterest(sockfd, oldEvents, sn_set.events());
+#endif
+
     if (sn_set.isEmpty())
         d->socketNotifiers.erase(i);
 }
@@ -453,18 +598,29 @@ bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
         tm = &wait_tm;
 
     d->pollfds.clear();
-    d->pollfds.reserve(1 + (include_notifiers ? d->socketNotifiers.size() : 0));
 
-    if (include_notifiers)
-        for (auto it = d->socketNotifiers.cbegin(); it != d->socketNotifiers.cend(); ++it)
-            d->pollfds.append(qt_make_pollfd(it.key(), it.value().events()));
+    int ready;
+#if QT_CONFIG(epoll)
+    if (include_notifiers && d->epollFd >= 0) {
+        ready = d->epollWait(tm);
+    } else
+#endif
+    {
+        d->pollfds.reserve(1 + (include_notifiers ? d->socketNotifiers.size() : 0));
 
-    // This must be last, as it's popped off the end below
-    d->pollfds.append(d->threadPipe.prepare());
+        if (include_notifiers)
+            for (auto it = d->socketNotifiers.cbegin(); it != d->socketNotifiers.cend(); ++it)
+                d->pollfds.append(qt_make_pollfd(it.key(), it.value().events()));
+
+        // This must be last, as it's popped off the end below
+        d->pollfds.append(d->threadPipe.prepare());
+
+        ready = qt_safe_poll(d->pollfds.data(), d->pollfds.size(), tm);
+    }
 
     int nevents = 0;
 
-    switch (qt_safe_poll(d->pollfds.data(), d->pollfds.size(), tm)) {
+    switch (ready) {
     case -1:
         perror("qt_safe_poll");
         break;
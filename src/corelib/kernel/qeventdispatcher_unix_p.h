@@ -23,6 +23,10 @@
 #include "QtCore/qhash.h"
 #include "private/qtimerinfo_unix_p.h"
 
+#if QT_CONFIG(epoll)
+#  include <sys/epoll.h>
+#endif
+
 QT_BEGIN_NAMESPACE
 
 class QEventDispatcherUNIXPrivate;
@@ -103,9 +107,24 @@ public:
     int activateSocketNotifiers();
     void setSocketNotifierPending(QSocketNotifier *notifier);
 
+#if QT_CONFIG(epoll)
+    bool initEpoll();
+    void updateEpollInterest(int fd, short oldEvents, short newEvents);
+    int epollWait(const timespec *tm);
+#endif
+
     QThreadPipe threadPipe;
     QList<pollfd> pollfds;
 
+#if QT_CONFIG(epoll)
+    // Persistent interest set, used instead of rebuilding pollfds on every
+    // iteration when enabled with QT_EVENT_DISPATCHER_EPOLL=1
+    int epollFd = -1;
+    QVarLengthArray<epoll_event, 64> epollEvents;
+    // descriptors that epoll rejects (regular files); poll() reports them as always ready
+    QList<int> epollUnsupportedFds;
+#endif
+
     QHash<int, QSocketNotifierSetUNIX> socketNotifiers;
     QList<QSocketNotifier *> pendingNotifiers;
 
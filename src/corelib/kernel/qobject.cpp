@@ -21,6 +21,7 @@
 #include <private/qthread_p.h>
 #include <qdebug.h>
 #include <qpair.h>
+#include <qpointer.h>
 #include <qvarlengtharray.h>
 #include <qscopeguard.h>
 #include <qset.h>
@@ -34,6 +35,7 @@
 #include <qtcore_tracepoints_p.h>
 
 #include <new>
+#include <utility>
 #include <mutex>
 #include <memory>
 
@@ -54,6 +56,8 @@ struct QObjectPrivate::ConnectionList
 {
     QAtomicPointer<Connection> first;
     QAtomicPointer<Connection> last;
+    // read-only copy of the list used by activate(), see ConnectionData::snapshot()
+    QAtomicPointer<ConnectionSnapshot> snapshot;
 };
 static_assert(std::is_trivially_destructible_v<QObjectPrivate::ConnectionList>);
 Q_DECLARE_TYPEINFO(QObjectPrivate::ConnectionList, Q_RELOCATABLE_TYPE);
@@ -69,16 +73,204 @@ struct QObjectPrivate::ConnectionOrSignalVector
 
     static SignalVector *asSignalVector(ConnectionOrSignalVector *c)
     {
-        if (reinterpret_cast<quintptr>(c) & 1)
-            return reinterpret_cast<SignalVector *>(reinterpret_cast<quintptr>(c) & ~quintptr(1u));
+        if ((reinterpret_cast<quintptr>(c) & 3) == 1)
+            return reinterpret_cast<SignalVector *>(reinterpret_cast<quintptr>(c) & ~quintptr(3u));
         return nullptr;
     }
     static Connection *fromSignalVector(SignalVector *v) {
         return reinterpret_cast<Connection *>(reinterpret_cast<quintptr>(v) | quintptr(1u));
     }
+    static ConnectionSnapshot *asConnectionSnapshot(ConnectionOrSignalVector *c)
+    {
+        if ((reinterpret_cast<quintptr>(c) & 3) == 2)
+            return reinterpret_cast<ConnectionSnapshot *>(reinterpret_cast<quintptr>(c) & ~quintptr(3u));
+        return nullptr;
+    }
+    static Connection *fromConnectionSnapshot(ConnectionSnapshot *s) {
+        return reinterpret_cast<Connection *>(reinterpret_cast<quintptr>(s) | quintptr(2u));
+    }
 };
 static_assert(std::is_trivial_v<QObjectPrivate::ConnectionOrSignalVector>);
 
+/*
+    Holds the arguments of emissions through a Qt::BatchedConnection or
+    Qt::CoalescedConnection that the receiver has not seen yet. The arguments
+    of one emission are copy-constructed back to back into a row; rows are
+    packed into chunks that never move, so the buffer grows without having to
+    relocate anything. At most one event per connection is posted at a time,
+    and it delivers all rows that have accumulated by then.
+
+    The mutex protects everything but the layout, which is set up once by the
+    first emission and never changes afterwards.
+*/
+class QBatchedCallBuffer
+{
+    Q_DISABLE_COPY_MOVE(QBatchedCallBuffer)
+public:
+    struct Chunk
+    {
+        Chunk *next;
+        int capacity;
+        int used;
+    };
+
+    explicit QBatchedCallBuffer(bool coalesce) : coalesce(coalesce) { }
+    ~QBatchedCallBuffer()
+    {
+        release(std::exchange(head, nullptr));
+        if (spare)
+            freeChunk(spare);
+    }
+
+    // mutex must be locked
+    void append(const int *argumentTypes, int nargs, void **argv)
+    {
+        if (!layoutReady)
+            setupLayout(argumentTypes, nargs);
+
+        char *row;
+        if (coalesce && tail && tail->used) {
+            row = rowAt(tail, 0);
+            destroyRow(row);
+        } else {
+            if (!tail || tail->used == tail->capacity)
+                addChunk();
+            row = rowAt(tail, tail->used);
+        }
+        for (qsizetype i = 0; i < types.size(); ++i)
+            types[i].construct(row + offsets[i], argv[i + 1]);
+        if (!coalesce || !tail->used)
+            ++tail->used;
+    }
+
+    // mutex must be locked
+    Chunk *takeRows()
+    {
+        tail = nullptr;
+        return std::exchange(head, nullptr);
+    }
+
+    // calls \a f with an argument vector for each row in \a rows
+    template <typename Func>
+    void forEachRow(Chunk *rows, void **args, Func f) const
+    {
+        for (Chunk *chunk = rows; chunk; chunk = chunk->next) {
+            for (int r = 0; r < chunk->used; ++r) {
+                char *row = rowAt(chunk, r);
+                for (qsizetype i = 0; i < types.size(); ++i)
+                    args[i + 1] = row + offsets[i];
+                if (!f())
+                    return;
+            }
+        }
+    }
+
+    // destroys the arguments in \a rows; mutex must not be locked
+    void release(Chunk *rows)
+    {
+        if (!rows)
+            return;
+        for (Chunk *chunk = rows; chunk; chunk = chunk->next) {
+            for (int r = 0; r < chunk->used; ++r)
+                destroyRow(rowAt(chunk, r));
+        }
+        {
+            // keep one chunk around for the next batch
+            QBasicMutexLocker locker(&mutex);
+            if (!spare) {
+                spare = rows;
+                rows = std::exchange(spare->next, nullptr);
+            }
+        }
+        while (rows)
+            freeChunk(std::exchange(rows, rows->next));
+    }
+
+    QBasicMutex mutex;
+    QEvent *pending = nullptr; // posted, but not yet delivered
+
+private:
+    void setupLayout(const int *argumentTypes, int nargs)
+    {
+        qsizetype size = 0;
+        for (int n = 1; n < nargs; ++n) {
+            const QMetaType type(argumentTypes[n - 1]);
+            const qsizetype align = qMax<qsizetype>(type.alignOf(), 1);
+            size = (size + align - 1) & ~(align - 1);
+            types.append(type);
+            offsets.append(size);
+            size += type.sizeOf();
+            rowAlign = qMax(rowAlign, align);
+        }
+        // zero-argument signals still need distinct rows
+        rowSize = qMax<qsizetype>((size + rowAlign - 1) & ~(rowAlign - 1), rowAlign);
+        headerSize = (qsizetype(sizeof(Chunk)) + rowAlign - 1) & ~(rowAlign - 1);
+        layoutReady = true;
+    }
+
+    char *rowAt(Chunk *chunk, int r) const
+    {
+        return reinterpret_cast<char *>(chunk) + headerSize + r * rowSize;
+    }
+
+    void destroyRow(char *row) const
+    {
+        for (qsizetype i = 0; i < types.size(); ++i)
+            types[i].destruct(row + offsets[i]);
+    }
+
+    void addChunk()
+    {
+        Chunk *chunk = std::exchange(spare, nullptr);
+        if (!chunk) {
+            // start small, so that rarely emitted signals don't waste memory
+            const int capacity = coalesce ? 1 : tail ? qMin(tail->capacity * 2, 1024) : 16;
+            void *memory = ::operator new(size_t(headerSize + capacity * rowSize),
+                                          std::align_val_t(rowAlign));
+            chunk = new (memory) Chunk{ nullptr, capacity, 0 };
+        }
+        chunk->used = 0;
+        if (tail)
+            tail->next = chunk;
+        else
+            head = chunk;
+        tail = chunk;
+    }
+
+    void freeChunk(Chunk *chunk) const
+    {
+        ::operator delete(chunk, std::align_val_t(rowAlign));
+    }
+
+    QVarLengthArray<QMetaType, 4> types;
+    QVarLengthArray<qsizetype, 4> offsets;
+    qsizetype rowSize = 0;
+    qsizetype rowAlign = alignof(Chunk);
+    qsizetype headerSize = 0;
+    Chunk *head = nullptr;
+    Chunk *tail = nullptr;
+    Chunk *spare = nullptr;
+    const bool coalesce;
+    bool layoutReady = false;
+};
+
+/*!
+    \internal
+
+    Returns the buffer for a connection of \a type that was requested with
+    \a batchFlags, or \nullptr if the connection doesn't batch its calls.
+    Only queued calls can be batched; single-shot connections never see a
+    second emission.
+*/
+static QBatchedCallBuffer *createBatchedCallBuffer(int type, int batchFlags, bool isSingleShot)
+{
+    if (!batchFlags || isSingleShot)
+        return nullptr;
+    if (type != Qt::AutoConnection && type != Qt::QueuedConnection)
+        return nullptr;
+    return new QBatchedCallBuffer(batchFlags & Qt::CoalescedConnection);
+}
+
 struct QObjectPrivate::Connection : public ConnectionOrSignalVector
 {
     // linked list of connections connected to slots in this object, next is in base class
@@ -96,6 +288,7 @@ struct QObjectPrivate::Connection : public ConnectionOrSignalVector
     };
     QAtomicPointer<const int> argumentTypes;
     QAtomicInt ref_{2};     //ref_ is 2 for the use in the internal lists, and for the use in QMetaObject::Connection
+    QBatchedCallBuffer *batch = nullptr; // for Qt::BatchedConnection and Qt::CoalescedConnection
     uint id = 0;
     ushort method_offset;
     ushort method_relative;
@@ -142,6 +335,48 @@ struct QObjectPrivate::SignalVector : public ConnectionOrSignalVector
 };
 static_assert(std::is_trivial_v<QObjectPrivate::SignalVector>); // it doesn't need to be, but it helps
 
+/*
+    An immutable array copy of a ConnectionList, so that emitting a signal with
+    many connections doesn't have to chase the list pointers from one
+    Connection to the next. It is built by the first emission after the list
+    changed, and replaced (not modified) when connections are added or removed.
+    Like SignalVector and Connection, it is only freed through the orphan list
+    once no activate() can be using it anymore.
+*/
+struct QObjectPrivate::ConnectionSnapshot : public ConnectionOrSignalVector
+{
+    quintptr count;
+    // Connection *connections[]
+    Connection *const *begin() const { return reinterpret_cast<Connection *const *>(this + 1); }
+    Connection *const *end() const { return begin() + count; }
+
+    // Lists shorter than this are walked directly. They are marked with the
+    // shortList sentinel, so that activate() doesn't try building them again.
+    static constexpr int MinimumCount = 2;
+    static ConnectionSnapshot shortList;
+
+    static ConnectionSnapshot *create(const ConnectionList &list)
+    {
+        quintptr n = 0;
+        for (Connection *c = list.first.loadRelaxed(); c; c = c->nextConnectionList.loadRelaxed())
+            ++n;
+        if (n < MinimumCount)
+            return &shortList;
+        void *ptr = malloc(sizeof(ConnectionSnapshot) + n * sizeof(Connection *));
+        if (!ptr)
+            return &shortList;
+        auto s = new (ptr) ConnectionSnapshot;
+        s->nextInOrphanList = nullptr;
+        s->count = n;
+        auto out = reinterpret_cast<Connection **>(s + 1);
+        for (Connection *c = list.first.loadRelaxed(); c; c = c->nextConnectionList.loadRelaxed())
+            *out++ = c;
+        return s;
+    }
+};
+static_assert(std::is_trivial_v<QObjectPrivate::ConnectionSnapshot>);
+QObjectPrivate::ConnectionSnapshot QObjectPrivate::ConnectionSnapshot::shortList = {};
+
 struct QObjectPrivate::ConnectionData
 {
     // the id below is used to avoid activating new connections. When the object gets
@@ -161,6 +396,11 @@ struct QObjectPrivate::ConnectionData
             deleteOrphaned(c);
         SignalVector *v = signalVector.loadRelaxed();
         if (v) {
+            for (int i = -1; i < v->count(); ++i) {
+                ConnectionSnapshot *s = v->at(i).snapshot.loadRelaxed();
+                if (s && s != &ConnectionSnapshot::shortList)
+                    free(s);
+            }
             v->~SignalVector();
             free(v);
         }
@@ -228,6 +468,28 @@ struct QObjectPrivate::ConnectionData
         return signalVector.loadAcquire() ? signalVector.loadRelaxed()->count() : -1;
     }
 
+    // must be called with the sender's lock held whenever \a list changes
+    void invalidateSnapshot(ConnectionList &list)
+    {
+        ConnectionSnapshot *s = list.snapshot.fetchAndStoreRelaxed(nullptr);
+        if (!s || s == &ConnectionSnapshot::shortList)
+            return;
+        // activate() might still be iterating over it, so orphan it like a SignalVector
+        Connection *o = nullptr;
+        do {
+            o = orphaned.loadRelaxed();
+            s->nextInOrphanList = o;
+        } while (!orphaned.testAndSetRelease(o, ConnectionOrSignalVector::fromConnectionSnapshot(s)));
+    }
+
+    /*
+        Returns the snapshot of \a list, which belongs to \a vector, or
+        nullptr if activate() needs to walk the list itself. Must be called
+        while holding a reference to this ConnectionData, which keeps the
+        returned snapshot alive.
+    */
+    inline const ConnectionSnapshot *snapshot(QObject *sender, SignalVector *vector, ConnectionList &list);
+
     static void deleteOrphaned(ConnectionOrSignalVector *c);
 };
 
@@ -516,6 +778,7 @@ inline void QObjectPrivate::addConnection(int signal, Connection *c)
     c->id = ++cd->currentConnectionId;
     c->prevConnectionList = connectionList.last.loadRelaxed();
     connectionList.last.storeRelaxed(c);
+    cd->invalidateSnapshot(connectionList);
 
     QObjectPrivate *rd = QObjectPrivate::get(c->receiver.loadRelaxed());
     rd->ensureConnectionData();
@@ -568,6 +831,7 @@ void QObjectPrivate::ConnectionData::removeConnection(QObjectPrivate::Connection
     if (c->prevConnectionList)
         c->prevConnectionList->nextConnectionList.storeRelaxed(n);
     c->prevConnectionList = nullptr;
+    invalidateSnapshot(connections);
 
     Q_ASSERT(c != orphaned.loadRelaxed());
     // add c to orphanedConnections
@@ -621,6 +885,28 @@ void QObjectPrivate::ConnectionData::cleanOrphanedConnectionsImpl(QObject *sende
     }
 }
 
+inline const QObjectPrivate::ConnectionSnapshot *
+QObjectPrivate::ConnectionData::snapshot(QObject *sender, SignalVector *vector, ConnectionList &list)
+{
+    ConnectionSnapshot *s = list.snapshot.loadAcquire();
+    if (Q_LIKELY(s))
+        return s != &ConnectionSnapshot::shortList ? s : nullptr;
+
+    // The list only changes with the sender's lock held, so that's what makes
+    // it safe to copy. Never wait for the lock though: the emitting thread
+    // might hold it already, and walking the list is always an option.
+    QBasicMutex *senderMutex = signalSlotLock(sender);
+    if (!senderMutex->tryLock())
+        return nullptr;
+    // a vector that has been replaced in the meantime would leak the snapshot
+    if (signalVector.loadRelaxed() == vector && !list.snapshot.loadRelaxed()) {
+        s = ConnectionSnapshot::create(list);
+        list.snapshot.storeRelease(s);
+    }
+    senderMutex->unlock();
+    return s != &ConnectionSnapshot::shortList ? s : nullptr;
+}
+
 inline void QObjectPrivate::ConnectionData::deleteOrphaned(QObjectPrivate::ConnectionOrSignalVector *o)
 {
     while (o) {
@@ -628,6 +914,9 @@ inline void QObjectPrivate::ConnectionData::deleteOrphaned(QObjectPrivate::Conne
         if (SignalVector *v = ConnectionOrSignalVector::asSignalVector(o)) {
             next = v->nextInOrphanList;
             free(v);
+        } else if (ConnectionSnapshot *s = ConnectionOrSignalVector::asConnectionSnapshot(o)) {
+            next = s->nextInOrphanList;
+            free(s);
         } else {
             QObjectPrivate::Connection *c = static_cast<Connection *>(o);
             next = c->nextInOrphanList;
@@ -709,6 +998,187 @@ QAbstractMetaCallEvent::~QAbstractMetaCallEvent()
 #endif
 }
 
+namespace {
+/*
+    Every queued call allocates a meta-call event in the emitting thread and
+    deletes it in the receiving one, so for a steady stream of calls between
+    two threads the general-purpose allocator keeps moving memory from one
+    thread's cache to another's. Instead, each thread keeps the blocks it
+    allocated: blocks it frees itself go on a plain list, blocks freed by
+    other threads are pushed onto a lock-free list that the owner takes over
+    in one go once its own list runs dry.
+
+    Pools are never deleted. When a thread exits, its pool, including the
+    blocks it caches, is handed to the next thread that needs one, so blocks
+    still in flight always have a valid owner to return to, and short-lived
+    threads don't start with an empty cache.
+*/
+class MetaCallEventPool
+{
+public:
+    struct alignas(std::max_align_t) Block
+    {
+        Block *next;
+        MetaCallEventPool *owner; // nullptr for blocks that aren't cached
+    };
+
+    // leave room for small subclasses, like the event of batched connections
+    static constexpr size_t PayloadSize = sizeof(QMetaCallEvent) + 2 * sizeof(void *);
+    static constexpr int MaxCachedBlocks = 512;
+
+    static void *allocate(size_t size)
+    {
+        MetaCallEventPool *pool = size <= PayloadSize ? current() : nullptr;
+        Block *block = pool ? pool->take() : nullptr;
+        if (!block) {
+            block = static_cast<Block *>(::operator new(sizeof(Block) + (pool ? PayloadSize : size)));
+            block->owner = pool;
+            if (pool)
+                ++pool->statistics.heapAllocations;
+        }
+        if (pool)
+            ++pool->statistics.allocations;
+        return block + 1;
+    }
+
+    static void deallocate(void *ptr) noexcept
+    {
+        if (!ptr)
+            return;
+        Block *block = static_cast<Block *>(ptr) - 1;
+        MetaCallEventPool *owner = block->owner;
+        if (!owner) {
+            ::operator delete(block);
+        } else if (owner == currentPool) {
+            if (owner->localCount < MaxCachedBlocks) {
+                block->next = std::exchange(owner->local, block);
+                ++owner->localCount;
+            } else {
+                ::operator delete(block);
+            }
+        } else {
+            Block *head = owner->remote.loadRelaxed();
+            do {
+                block->next = head;
+            } while (!owner->remote.testAndSetOrdered(head, block, head));
+        }
+    }
+
+    static QAbstractMetaCallEvent::AllocationStatistics currentStatistics()
+    {
+        return currentPool ? currentPool->statistics : QAbstractMetaCallEvent::AllocationStatistics();
+    }
+
+private:
+    Block *take()
+    {
+        if (!local) {
+            local = remote.fetchAndStoreAcquire(nullptr);
+            // we don't know how many blocks came back; they'll be used up first
+            localCount = 0;
+        }
+        Block *block = local;
+        if (block) {
+            local = block->next;
+            localCount = qMax(localCount - 1, 0);
+        }
+        return block;
+    }
+
+    struct Retired
+    {
+        QBasicMutex mutex;
+        MetaCallEventPool *first = nullptr;
+    };
+    static Retired &retired()
+    {
+        Q_CONSTINIT static Retired r;
+        return r;
+    }
+
+    // the calling thread's pool; nullptr once the thread is shutting down
+    static MetaCallEventPool *current()
+    {
+        if (Q_LIKELY(currentPool) || threadExiting)
+            return currentPool;
+
+        MetaCallEventPool *pool;
+        {
+            Retired &r = retired();
+            QBasicMutexLocker locker(&r.mutex);
+            pool = r.first;
+            if (pool)
+                r.first = pool->nextRetired;
+        }
+        if (!pool)
+            pool = new MetaCallEventPool;
+        pool->statistics = {};
+        currentPool = pool;
+        static thread_local Retirer retirer;
+        Q_UNUSED(retirer);
+        return pool;
+    }
+
+    struct Retirer
+    {
+        ~Retirer()
+        {
+            // the cached blocks stay with the pool, ready for the next thread
+            MetaCallEventPool *pool = std::exchange(currentPool, nullptr);
+            threadExiting = true;
+
+            Retired &r = retired();
+            QBasicMutexLocker locker(&r.mutex);
+            pool->nextRetired = std::exchange(r.first, pool);
+        }
+    };
+
+    Block *local = nullptr;
+    int localCount = 0;
+    QAtomicPointer<Block> remote;
+    MetaCallEventPool *nextRetired = nullptr;
+    QAbstractMetaCallEvent::AllocationStatistics statistics;
+
+    static thread_local MetaCallEventPool *currentPool;
+    static thread_local bool threadExiting;
+};
+
+thread_local MetaCallEventPool *MetaCallEventPool::currentPool = nullptr;
+thread_local bool MetaCallEventPool::threadExiting = false;
+} // unnamed namespace
+
+/*!
+    \internal
+
+    Meta-call events are allocated from a per-thread cache of blocks, as
+    they are usually created and deleted at a high rate. Blocks return to
+    the cache of the thread that allocated them, no matter which thread
+    deletes the event.
+ */
+void *QAbstractMetaCallEvent::operator new(std::size_t size)
+{
+    return MetaCallEventPool::allocate(size);
+}
+
+/*!
+    \internal
+ */
+void QAbstractMetaCallEvent::operator delete(void *ptr) noexcept
+{
+    MetaCallEventPool::deallocate(ptr);
+}
+
+/*!
+    \internal
+
+    Returns how many meta-call events the calling thread allocated, and how
+    many of those allocations could not be served from its cache.
+ */
+QAbstractMetaCallEvent::AllocationStatistics QAbstractMetaCallEvent::allocationStatistics()
+{
+    return MetaCallEventPool::currentStatistics();
+}
+
 /*!
     \internal
  */
@@ -1318,6 +1788,7 @@ inline QObjectPrivate::Connection::~Connection()
     }
     if (isSlotObject)
         slotObj->destroyIfLastRef();
+    delete batch;
 }
 
 
@@ -1890,6 +2361,8 @@ void QObjectPrivate::setThreadData_helper(QThreadData *currentData, QThreadData
     }
 
     // move posted events
+    currentData->flushPostEventInbox();
+    targetData->flushPostEventInbox();
     int eventsMoved = 0;
     for (int i = 0; i < currentData->postEventList.size(); ++i) {
         const QPostEvent &pe = currentData->postEventList.at(i);
@@ -3667,6 +4140,9 @@ QObjectPrivate::Connection *QMetaObjectPrivate::connect(const QObject *sender,
     const bool isSingleShot = type & Qt::SingleShotConnection;
     type &= ~Qt::SingleShotConnection;
 
+    const int batchFlags = type & (Qt::BatchedConnection | Qt::CoalescedConnection);
+    type &= ~(Qt::BatchedConnection | Qt::CoalescedConnection);
+
     Q_ASSERT(type >= 0);
     Q_ASSERT(type <= 3);
 
@@ -3684,6 +4160,7 @@ QObjectPrivate::Connection *QMetaObjectPrivate::connect(const QObject *sender,
     c->argumentTypes.storeRelaxed(types);
     c->callFunction = callFunction;
     c->isSingleShot = isSingleShot;
+    c->batch = createBatchedCallBuffer(type, batchFlags, isSingleShot);
 
     QObjectPrivate::get(s)->addConnection(signal_index, c.get());
 
@@ -3981,6 +4458,85 @@ private:
     QtPrivate::QSlotObjectBase *m_slotObject = nullptr;
 };
 
+/*
+    The event posted for a Qt::BatchedConnection or Qt::CoalescedConnection.
+    It takes the rows that have accumulated in the connection's buffer when it
+    gets delivered, and calls the slot once for each of them.
+*/
+class QBatchedMetaCallEvent : public QMetaCallEvent
+{
+public:
+    QBatchedMetaCallEvent(QObjectPrivate::Connection *c, const QObject *sender, int signalId, int nargs)
+        : QMetaCallEvent(c->method_offset, c->method_relative, c->callFunction, sender, signalId, nargs),
+          connection(c), nargs(nargs)
+    {
+        connection->ref();
+    }
+    QBatchedMetaCallEvent(QtPrivate::QSlotObjectBase *slotObj, QObjectPrivate::Connection *c,
+                          const QObject *sender, int signalId, int nargs)
+        : QMetaCallEvent(slotObj, sender, signalId, nargs),
+          connection(c), nargs(nargs)
+    {
+        connection->ref();
+    }
+
+    ~QBatchedMetaCallEvent() override
+    {
+        // the argument storage belongs to the buffer
+        clearArgs();
+
+        // if we never got delivered, the calls we were carrying go away with us
+        QBatchedCallBuffer *batch = connection->batch;
+        QBatchedCallBuffer::Chunk *dropped = nullptr;
+        {
+            QBasicMutexLocker locker(&batch->mutex);
+            if (batch->pending == this) {
+                batch->pending = nullptr;
+                dropped = batch->takeRows();
+            }
+        }
+        batch->release(dropped);
+        connection->deref();
+    }
+
+    void placeMetaCall(QObject *object) override
+    {
+        QBatchedCallBuffer *batch = connection->batch;
+        QBatchedCallBuffer::Chunk *rows;
+        {
+            QBasicMutexLocker locker(&batch->mutex);
+            if (batch->pending == this)
+                batch->pending = nullptr;
+            rows = batch->takeRows();
+        }
+        const auto cleanup = qScopeGuard([&] {
+            clearArgs();
+            batch->release(rows);
+        });
+
+        // a slot might delete the receiver; stop calling it then
+        const bool single = rows && !rows->next && rows->used == 1;
+        QPointer<QObject> guard;
+        if (!single)
+            guard = object;
+        batch->forEachRow(rows, args(), [&] {
+            QMetaCallEvent::placeMetaCall(object);
+            return single || !guard.isNull();
+        });
+    }
+
+private:
+    void clearArgs()
+    {
+        void **a = args();
+        for (int i = 1; i < nargs; ++i)
+            a[i] = nullptr;
+    }
+
+    QObjectPrivate::Connection *connection;
+    const int nargs;
+};
+
 /*!
     \internal
 
@@ -4016,6 +4572,30 @@ static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connect
     SlotObjectGuard slotObjectGuard { c->isSlotObject ? c->slotObj : nullptr };
     locker.unlock();
 
+    if (QBatchedCallBuffer *batch = c->batch) {
+        QMetaCallEvent *ev = nullptr;
+        {
+            QBasicMutexLocker batchLocker(&batch->mutex);
+            batch->append(argumentTypes, nargs, argv);
+            if (batch->pending) // rides along with the event that is already on its way
+                return;
+            ev = c->isSlotObject ?
+                new QBatchedMetaCallEvent(c->slotObj, c, sender, signal, nargs) :
+                new QBatchedMetaCallEvent(c, sender, signal, nargs);
+            batch->pending = ev;
+        }
+
+        locker.relock();
+        if (!c->receiver.loadRelaxed()) {
+            // the connection has been disconnected while we were unlocked
+            locker.unlock();
+            delete ev;
+            return;
+        }
+        QCoreApplication::postEvent(receiver, ev);
+        return;
+    }
+
     QMetaCallEvent *ev = c->isSlotObject ?
         new QMetaCallEvent(c->slotObj, sender, signal, nargs) :
         new QMetaCallEvent(c->method_offset, c->method_relative, c->callFunction, sender, signal, nargs);
@@ -4091,7 +4671,7 @@ void doActivate(QObject *sender, int signal_index, void **argv)
     QObjectPrivate::ConnectionDataPointer connections(sp->connections.loadRelaxed());
     QObjectPrivate::SignalVector *signalVector = connections->signalVector.loadRelaxed();
 
-    const QObjectPrivate::ConnectionList *list;
+    QObjectPrivate::ConnectionList *list;
     if (signal_index < signalVector->count())
         list = &signalVector->at(signal_index);
     else
@@ -4108,6 +4688,20 @@ void doActivate(QObject *sender, int signal_index, void **argv)
         if (!c)
             continue;
 
+        // iterate over the snapshot if there is one, otherwise follow the list
+        QObjectPrivate::Connection *const *snapshotPos = nullptr;
+        QObjectPrivate::Connection *const *snapshotEnd = nullptr;
+        if (const auto *snapshot = connections->snapshot(sender, signalVector, *list)) {
+            snapshotPos = snapshot->begin();
+            snapshotEnd = snapshot->end();
+            c = *snapshotPos;
+        }
+        const auto nextConnection = [&]() -> QObjectPrivate::Connection * {
+            if (snapshotPos)
+                return ++snapshotPos != snapshotEnd ? *snapshotPos : nullptr;
+            return c->nextConnectionList.loadRelaxed();
+        };
+
         do {
             QObject * const receiver = c->receiver.loadRelaxed();
             if (!receiver)
@@ -4118,7 +4712,9 @@ void doActivate(QObject *sender, int signal_index, void **argv)
                 continue;
 
             bool receiverInSameThread;
-            if (inSenderThread) {
+            if (inSenderThread || c->connectionType != Qt::AutoConnection) {
+                // Only an AutoConnection decides between a direct and a queued call
+                // based on this, so only it needs to be consistent with moveToThread()
                 receiverInSameThread = currentThreadId == td->threadId.loadRelaxed();
             } else {
                 // need to lock before reading the threadId, because moveToThread() could interfere
@@ -4203,7 +4799,7 @@ void doActivate(QObject *sender, int signal_index, void **argv)
                 if (callbacks_enabled && signal_spy_set->slot_end_callback != nullptr)
                     signal_spy_set->slot_end_callback(receiver, method);
             }
-        } while ((c = c->nextConnectionList.loadRelaxed()) != nullptr && c->id <= highestConnectionId);
+        } while ((c = nextConnection()) != nullptr && c->id <= highestConnectionId);
 
     } while (list != &signalVector->at(-1) &&
         //start over for all signals;
@@ -5298,6 +5894,9 @@ QMetaObject::Connection QObjectPrivate::connectImpl(const QObject *sender, int s
     const bool isSingleShot = type & Qt::SingleShotConnection;
     type &= ~Qt::SingleShotConnection;
 
+    const int batchFlags = type & (Qt::BatchedConnection | Qt::CoalescedConnection);
+    type &= ~(Qt::BatchedConnection | Qt::CoalescedConnection);
+
     Q_ASSERT(type >= 0);
     Q_ASSERT(type <= 3);
 
@@ -5316,6 +5915,7 @@ QMetaObject::Connection QObjectPrivate::connectImpl(const QObject *sender, int s
         c->ownArgumentTypes = false;
     }
     c->isSingleShot = isSingleShot;
+    c->batch = createBatchedCallBuffer(type, batchFlags, isSingleShot);
 
     QObjectPrivate::get(s)->addConnection(signal_index, c.get());
     QMetaObject::Connection ret(c.release());
@@ -102,6 +102,7 @@ public:
     struct ConnectionList;
     struct ConnectionOrSignalVector;
     struct SignalVector;
+    struct ConnectionSnapshot;
     struct Sender;
 
     /*
@@ -114,6 +115,9 @@ public:
 
         This vector is protected by the object mutex (signalSlotLock())
 
+        Each list can additionally have an immutable snapshot of its connections, which
+        activate() iterates over instead of the list. Modifying the list replaces the snapshot.
+
         Each Connection is also part of a 'senders' linked list. This one contains all connections connected
         to a slot in this object. The mutex of the receiver must be locked when touching the pointers of this
         linked list.
@@ -358,12 +362,29 @@ public:
     inline const QObject *sender() const { return sender_; }
     inline int signalId() const { return signalId_; }
 
+    // meta-call events are allocated from a per-thread cache, see qobject.cpp
+    static void *operator new(std::size_t size);
+    static void operator delete(void *ptr) noexcept;
+
+    struct AllocationStatistics
+    {
+        quint64 allocations = 0;       // events allocated by the calling thread
+        quint64 heapAllocations = 0;   // ... of which the cache could not serve
+    };
+    static AllocationStatistics allocationStatistics();
+
 private:
+    friend class QPostEventList;
+    friend class QThreadData;
+
     int signalId_;
     const QObject *sender_;
 #if QT_CONFIG(thread)
     QSemaphore *semaphore_;
 #endif
+    // set while the event waits in QPostEventList's inbox
+    QAbstractMetaCallEvent *inboxNext_ = nullptr;
+    QObject *inboxReceiver_ = nullptr;
 };
 
 class Q_CORE_EXPORT QMetaCallEvent : public QAbstractMetaCallEvent
@@ -17,10 +17,21 @@
 
 #include <sys/times.h>
 
+#include <algorithm>
+#include <limits>
+
 QT_BEGIN_NAMESPACE
 
 Q_CORE_EXPORT bool qt_disable_lowpriority_timers=false;
 
+// values of QTimerInfo::wheelLevel for timers that are not in the wheel
+enum { DueTimer = -1, UnqueuedTimer = -2 };
+
+static constexpr qint64 toMsecs(const timespec &t)
+{
+    return qint64(t.tv_sec) * 1000 + t.tv_nsec / (1000 * 1000);
+}
+
 /*
  * Internal functions for manipulating timer data structures.  The
  * timerBitVec array is used for keeping track of timer identifiers.
@@ -48,6 +59,19 @@ QTimerInfoList::QTimerInfoList()
 #endif
 
     firstTimerInfo = nullptr;
+
+    wheelTime = toMsecs(updateCurrentTime());
+    wheelOverflow = nullptr;
+    for (int level = 0; level < WheelLevels; ++level) {
+        wheelOccupancy[level] = 0;
+        for (int slot = 0; slot < WheelSize; ++slot)
+            wheel[level][slot] = nullptr;
+    }
+}
+
+QTimerInfoList::~QTimerInfoList()
+{
+    qDeleteAll(timers);
 }
 
 timespec QTimerInfoList::updateCurrentTime()
@@ -111,9 +135,17 @@ bool QTimerInfoList::timeChanged(timespec *delta)
 void QTimerInfoList::timerRepair(const timespec &diff)
 {
     // repair all timers
-    for (int i = 0; i < size(); ++i) {
-        QTimerInfo *t = at(i);
+    for (QTimerInfo *t : qAsConst(timers)) {
         t->timeout = t->timeout + diff;
+        if (t->wheelLevel != DueTimer)
+            wheelRemove(t);
+    }
+
+    // the position in the wheel depends on the timeout, so park them again
+    wheelTime = toMsecs(currentTime);
+    for (QTimerInfo *t : qAsConst(timers)) {
+        if (t->wheelLevel != DueTimer)
+            timerInsert(t);
     }
 }
 
@@ -135,17 +167,155 @@ void QTimerInfoList::repairTimersIfNeeded()
 #endif
 
 /*
-  insert timer info into list
+  insert timer info into the list of due timers, or park it in the wheel
 */
 void QTimerInfoList::timerInsert(QTimerInfo *ti)
 {
-    int index = size();
+    if (toMsecs(ti->timeout) > wheelTime) {
+        wheelInsert(ti);
+        return;
+    }
+
+    int index = dueTimers.size();
     while (index--) {
-        const QTimerInfo * const t = at(index);
+        const QTimerInfo * const t = dueTimers.at(index);
         if (!(ti->timeout < t->timeout))
             break;
     }
-    insert(index+1, ti);
+    dueTimers.insert(index+1, ti);
+    ti->wheelLevel = DueTimer;
+}
+
+void QTimerInfoList::timerRemove(QTimerInfo *ti)
+{
+    if (ti->wheelLevel == DueTimer)
+        dueTimers.removeOne(ti);
+    else
+        wheelRemove(ti);
+}
+
+/*
+  The wheel has WheelLevels levels of WheelSize slots each, where a slot on
+  level n spans WheelSize^n milliseconds. A timer is parked on the level of
+  the most significant group of WheelBits bits in which its timeout differs
+  from wheelTime, in the slot given by those bits. Therefore, occupied slots
+  are always ahead of the wheel's position on their level, and the lowest
+  occupied level holds the earliest timers.
+
+  When wheelTime reaches the start of an occupied slot, its timers are
+  inserted again: they either become due, or move down to a finer level.
+*/
+void QTimerInfoList::wheelInsert(QTimerInfo *ti)
+{
+    const qint64 msecs = toMsecs(ti->timeout);
+    Q_ASSERT(msecs > wheelTime);
+
+    const int level = int(63 - qCountLeadingZeroBits(quint64(msecs ^ wheelTime))) / WheelBits;
+    QTimerInfo **head;
+    if (level < WheelLevels) {
+        const int slot = int(msecs >> (level * WheelBits)) & (WheelSize - 1);
+        head = &wheel[level][slot];
+        wheelOccupancy[level] |= Q_UINT64_C(1) << slot;
+        ti->wheelLevel = qint8(level);
+        ti->wheelSlot = quint8(slot);
+    } else {
+        head = &wheelOverflow;
+        ti->wheelLevel = WheelLevels;
+        ti->wheelSlot = 0;
+    }
+
+    ti->wheelPrev = nullptr;
+    ti->wheelNext = *head;
+    if (*head)
+        (*head)->wheelPrev = ti;
+    *head = ti;
+}
+
+void QTimerInfoList::wheelRemove(QTimerInfo *ti)
+{
+    Q_ASSERT(ti->wheelLevel >= 0);
+
+    if (ti->wheelNext)
+        ti->wheelNext->wheelPrev = ti->wheelPrev;
+
+    if (ti->wheelPrev) {
+        ti->wheelPrev->wheelNext = ti->wheelNext;
+    } else if (ti->wheelLevel == WheelLevels) {
+        wheelOverflow = ti->wheelNext;
+    } else {
+        QTimerInfo *&head = wheel[ti->wheelLevel][ti->wheelSlot];
+        head = ti->wheelNext;
+        if (!head)
+            wheelOccupancy[ti->wheelLevel] &= ~(Q_UINT64_C(1) << ti->wheelSlot);
+    }
+
+    ti->wheelNext = ti->wheelPrev = nullptr;
+    ti->wheelLevel = UnqueuedTimer;
+}
+
+/*
+  Returns the start of the next occupied slot, or the maximum qint64 value
+  if the wheel is empty.
+*/
+qint64 QTimerInfoList::nextWheelEvent() const
+{
+    for (int level = 0; level < WheelLevels; ++level) {
+        const int shift = level * WheelBits;
+        const int index = int(wheelTime >> shift) & (WheelSize - 1);
+        const quint64 pending = wheelOccupancy[level] & (~Q_UINT64_C(0) << index << 1);
+        if (pending) {
+            const qint64 base = wheelTime >> (shift + WheelBits) << (shift + WheelBits);
+            return base + (qint64(qCountTrailingZeroBits(pending)) << shift);
+        }
+    }
+
+    if (wheelOverflow) {
+        constexpr int shift = WheelLevels * WheelBits;
+        return ((wheelTime >> shift) + 1) << shift;
+    }
+
+    return std::numeric_limits<qint64>::max();
+}
+
+void QTimerInfoList::advanceWheel(qint64 msecs)
+{
+    auto reinsert = [this](QTimerInfo *t) {
+        while (t) {
+            QTimerInfo *next = t->wheelNext;
+            t->wheelNext = t->wheelPrev = nullptr;
+            timerInsert(t);
+            t = next;
+        }
+    };
+
+    while (wheelTime < msecs) {
+        const qint64 next = nextWheelEvent();
+        if (next > msecs) {
+            // nothing in between, jump ahead
+            wheelTime = msecs;
+            return;
+        }
+        wheelTime = next;
+
+        constexpr qint64 overflowMask = (Q_INT64_C(1) << (WheelLevels * WheelBits)) - 1;
+        if (wheelOverflow && (wheelTime & overflowMask) == 0) {
+            QTimerInfo *t = wheelOverflow;
+            wheelOverflow = nullptr;
+            reinsert(t);
+        }
+
+        for (int level = WheelLevels - 1; level >= 0; --level) {
+            const int shift = level * WheelBits;
+            if (wheelTime & ((Q_INT64_C(1) << shift) - 1))
+                continue;
+
+            const int slot = int(wheelTime >> shift) & (WheelSize - 1);
+            QTimerInfo *t = wheel[level][slot];
+            wheel[level][slot] = nullptr;
+            wheelOccupancy[level] &= ~(Q_UINT64_C(1) << slot);
+            reinsert(t);
+        }
+    }
 }
 
 inline timespec &operator+=(timespec &t1, int ms)
@@ -354,22 +524,44 @@ bool QTimerInfoList::timerWait(timespec &tm)
 {
     timespec currentTime = updateCurrentTime();
     repairTimersIfNeeded();
+    advanceWheel(toMsecs(currentTime));
 
     // Find first waiting timer not already active
     QTimerInfo *t = nullptr;
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (!(*it)->activateRef) {
-            t = *it;
+    for (QTimerInfo *due : qAsConst(dueTimers)) {
+        if (!due->activateRef) {
+            t = due;
             break;
         }
     }
 
-    if (!t)
-      return false;
+    timespec timeout = {};
+    if (t)
+        timeout = t->timeout;
+
+    const qint64 wheelEvent = nextWheelEvent();
+    if (wheelEvent != std::numeric_limits<qint64>::max()) {
+        timespec wheelTimeout;
+        if (wheelOccupancy[0]) {
+            // the finest level holds the timers of a single millisecond
+            const QTimerInfo *parked = wheel[0][int(wheelEvent) & (WheelSize - 1)];
+            wheelTimeout = parked->timeout;
+            for (parked = parked->wheelNext; parked; parked = parked->wheelNext)
+                wheelTimeout = qMin(wheelTimeout, parked->timeout);
+        } else {
+            // wake up in time to move the timers of the next slot down
+            wheelTimeout.tv_sec = wheelEvent / 1000;
+            wheelTimeout.tv_nsec = (wheelEvent % 1000) * 1000 * 1000;
+        }
+        if (!t || wheelTimeout < timeout)
+            timeout = wheelTimeout;
+    } else if (!t) {
+        return false;
+    }
 
-    if (currentTime < t->timeout) {
+    if (currentTime < timeout) {
         // time to wait
-        tm = roundToMillisecond(t->timeout - currentTime);
+        tm = roundToMillisecond(timeout - currentTime);
     } else {
         // no time to wait
         tm.tv_sec  = 0;
@@ -379,6 +571,15 @@ bool QTimerInfoList::timerWait(timespec &tm)
     return true;
 }
 
+/*
+  Returns \c true if a timer has expired, activated or not.
+*/
+bool QTimerInfoList::hasExpiredTimers()
+{
+    advanceWheel(toMsecs(updateCurrentTime()));
+    return !dueTimers.isEmpty() && !(currentTime < dueTimers.constFirst()->timeout);
+}
+
 /*
   Returns the timer's remaining time in milliseconds with the given timerId, or
   null if there is nothing left. If the timer id is not found in the list, the
@@ -390,16 +591,13 @@ int QTimerInfoList::timerRemainingTime(int timerId)
     repairTimersIfNeeded();
     timespec tm = {0, 0};
 
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            if (currentTime < t->timeout) {
-                // time to wait
-                tm = roundToMillisecond(t->timeout - currentTime);
-                return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
-            } else {
-                return 0;
-            }
+    if (const QTimerInfo *t = timers.value(timerId)) {
+        if (currentTime < t->timeout) {
+            // time to wait
+            tm = roundToMillisecond(t->timeout - currentTime);
+            return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
+        } else {
+            return 0;
         }
     }
 
@@ -418,6 +616,9 @@ void QTimerInfoList::registerTimer(int timerId, qint64 interval, Qt::TimerType t
     t->timerType = timerType;
     t->obj = object;
     t->activateRef = nullptr;
+    t->wheelNext = t->wheelPrev = nullptr;
+    t->wheelLevel = UnqueuedTimer;
+    t->wheelSlot = 0;
 
     timespec expected = updateCurrentTime() + interval;
 
@@ -460,6 +661,7 @@ void QTimerInfoList::registerTimer(int timerId, qint64 interval, Qt::TimerType t
             ++t->timeout.tv_sec;
     }
 
+    timers.insert(timerId, t);
     timerInsert(t);
 
 #ifdef QTIMERINFO_DEBUG
@@ -474,40 +676,37 @@ void QTimerInfoList::registerTimer(int timerId, qint64 interval, Qt::TimerType t
 
 bool QTimerInfoList::unregisterTimer(int timerId)
 {
+    QTimerInfo *t = timers.take(timerId);
+    if (!t)
+        return false; // id not found
+
     // set timer inactive
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            // found it
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = nullptr;
-            if (t->activateRef)
-                *(t->activateRef) = nullptr;
-            delete t;
-            return true;
-        }
-    }
-    // id not found
-    return false;
+    timerRemove(t);
+    if (t == firstTimerInfo)
+        firstTimerInfo = nullptr;
+    if (t->activateRef)
+        *(t->activateRef) = nullptr;
+    delete t;
+    return true;
 }
 
 bool QTimerInfoList::unregisterTimers(QObject *object)
 {
     if (isEmpty())
         return false;
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
+    for (auto it = timers.begin(); it != timers.end(); ) {
+        QTimerInfo *t = it.value();
         if (t->obj == object) {
             // object found
-            removeAt(i);
+            it = timers.erase(it);
+            timerRemove(t);
             if (t == firstTimerInfo)
                 firstTimerInfo = nullptr;
             if (t->activateRef)
                 *(t->activateRef) = nullptr;
             delete t;
-            // move back one so that we don't skip the new current item
-            --i;
+        } else {
+            ++it;
         }
     }
     return true;
@@ -515,16 +714,25 @@ bool QTimerInfoList::unregisterTimers(QObject *object)
 
 QList<QAbstractEventDispatcher::TimerInfo> QTimerInfoList::registeredTimers(QObject *object) const
 {
+    QList<const QTimerInfo *> found;
+    for (const QTimerInfo *t : timers) {
+        if (t->obj == object)
+            found << t;
+    }
+
+    // report them in the order they will fire
+    std::sort(found.begin(), found.end(), [](const QTimerInfo *lhs, const QTimerInfo *rhs) {
+        return lhs->timeout < rhs->timeout;
+    });
+
     QList<QAbstractEventDispatcher::TimerInfo> list;
-    for (int i = 0; i < count(); ++i) {
-        const QTimerInfo * const t = at(i);
-        if (t->obj == object) {
-            list << QAbstractEventDispatcher::TimerInfo(t->id,
-                                                        (t->timerType == Qt::VeryCoarseTimer
-                                                         ? t->interval * 1000
-                                                         : t->interval),
-                                                        t->timerType);
-        }
+    list.reserve(found.size());
+    for (const QTimerInfo *t : qAsConst(found)) {
+        list << QAbstractEventDispatcher::TimerInfo(t->id,
+                                                    (t->timerType == Qt::VeryCoarseTimer
+                                                     ? t->interval * 1000
+                                                     : t->interval),
+                                                    t->timerType);
     }
     return list;
 }
@@ -543,21 +751,21 @@ int QTimerInfoList::activateTimers()
     timespec currentTime = updateCurrentTime();
     // qDebug() << "Thread" << QThread::currentThreadId() << "woken up at" << currentTime;
     repairTimersIfNeeded();
-
+    advanceWheel(toMsecs(currentTime));
 
     // Find out how many timer have expired
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (currentTime < (*it)->timeout)
+    for (const QTimerInfo *t : qAsConst(dueTimers)) {
+        if (currentTime < t->timeout)
             break;
         maxCount++;
     }
 
     //fire the timers.
     while (maxCount--) {
-        if (isEmpty())
+        if (dueTimers.isEmpty())
             break;
 
-        QTimerInfo *currentTimerInfo = constFirst();
+        QTimerInfo *currentTimerInfo = dueTimers.constFirst();
         if (currentTime < currentTimerInfo->timeout)
             break; // no timer has expired
 
@@ -572,7 +780,8 @@ int QTimerInfoList::activateTimers()
         }
 
         // remove from list
-        removeFirst();
+        dueTimers.removeFirst();
+        currentTimerInfo->wheelLevel = UnqueuedTimer;
 
 #ifdef QTIMERINFO_DEBUG
         float diff;
@@ -20,6 +20,8 @@
 // #define QTIMERINFO_DEBUG
 
 #include "qabstracteventdispatcher.h"
+#include "qhash.h"
+#include "qlist.h"
 
 #include <sys/time.h> // struct timeval
 
@@ -34,6 +36,12 @@ struct QTimerInfo {
     QObject *obj;     // - object to receive event
     QTimerInfo **activateRef; // - ref from activateTimers
 
+    // timing wheel links, see QTimerInfoList
+    QTimerInfo *wheelNext;
+    QTimerInfo *wheelPrev;
+    qint8 wheelLevel;    // - -1 when in the list of due timers
+    quint8 wheelSlot;
+
 #ifdef QTIMERINFO_DEBUG
     timeval expected; // when timer is expected to fire
     float cumulativeError;
@@ -41,8 +49,13 @@ struct QTimerInfo {
 #endif
 };
 
-class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
+// Timers that are due (in the current millisecond) are kept in a sorted list,
+// which preserves the activation order. All other timers are parked in a
+// hierarchical timing wheel, which makes registering and unregistering O(1).
+class Q_CORE_EXPORT QTimerInfoList
 {
+    Q_DISABLE_COPY(QTimerInfoList)
+
 #if ((_POSIX_MONOTONIC_CLOCK-0 <= 0) && !defined(Q_OS_MAC)) || defined(QT_BOOTSTRAPPED)
     timespec previousTime;
     clock_t previousTicks;
@@ -56,8 +69,29 @@ class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
     // state variables used by activateTimers()
     QTimerInfo *firstTimerInfo;
 
+    enum {
+        WheelBits = 6,
+        WheelSize = 1 << WheelBits,
+        WheelLevels = 4  // 2^24 ms, about 4.6 hours; later timers go to wheelOverflow
+    };
+
+    QList<QTimerInfo *> dueTimers;
+    QHash<int, QTimerInfo *> timers;
+
+    qint64 wheelTime;  // - msecs up to which the wheel has been advanced
+    quint64 wheelOccupancy[WheelLevels];
+    QTimerInfo *wheel[WheelLevels][WheelSize];
+    QTimerInfo *wheelOverflow;
+
+    void wheelInsert(QTimerInfo *);
+    void wheelRemove(QTimerInfo *);
+    qint64 nextWheelEvent() const;
+    void advanceWheel(qint64 msecs);
+    void timerRemove(QTimerInfo *);
+
 public:
     QTimerInfoList();
+    ~QTimerInfoList();
 
     timespec currentTime;
     timespec updateCurrentTime();
@@ -66,6 +100,7 @@ public:
     void repairTimersIfNeeded();
 
     bool timerWait(timespec &);
+    bool hasExpiredTimers();
     void timerInsert(QTimerInfo *);
 
     int timerRemainingTime(int timerId);
@@ -76,6 +111,9 @@ public:
     QList<QAbstractEventDispatcher::TimerInfo> registeredTimers(QObject *object) const;
 
     int activateTimers();
+
+    bool isEmpty() const { return timers.isEmpty(); }
+    qsizetype size() const { return timers.size(); }
 };
 
 QT_END_NAMESPACE
@@ -13,6 +13,7 @@ QT_BEGIN_NAMESPACE
 
 class QJsonObject;
 class QDataStream;
+class QStringPool;
 
 namespace QJsonPrivate { class Variant; }
 
@@ -298,7 +299,9 @@ public:
     static QCborMap fromJsonObject(const QJsonObject &o);
     static QCborMap fromJsonObject(QJsonObject &&o) noexcept;
     QVariantMap toVariantMap() const;
+    QVariantMap toVariantMap(QStringPool *keyPool) const;
     QVariantHash toVariantHash() const;
+    QVariantHash toVariantHash(QStringPool *keyPool) const;
     QJsonObject toJsonObject() const;
 
 private:
@@ -14,6 +14,9 @@
 
 #include <qmap.h>
 #include <qhash.h>
+#ifndef QT_BOOTSTRAPPED
+#include <qstringpool.h>
+#endif
 
 #include <private/qnumeric_p.h>
 #include <quuid.h>
@@ -880,10 +883,61 @@ QCborArray QCborArray::fromJsonArray(QJsonArray &&array) noexcept
         QCborArray::toVariantList()
  */
 QVariantMap QCborMap::toVariantMap() const
+{
+    return toVariantMap(nullptr);
+}
+
+static QString makeKey(const QCborContainerPrivate *d, qsizetype idx, QStringPool *keyPool)
+{
+    QString key = makeString(d, idx);
+#ifndef QT_BOOTSTRAPPED
+    if (keyPool)
+        key = keyPool->intern(key);
+#else
+    Q_UNUSED(keyPool);
+#endif
+    return key;
+}
+
+// like QCborValue::toVariant(), but interning the keys of the maps it contains
+static QVariant toVariant(const QCborValue &value, QStringPool *keyPool)
+{
+    if (!keyPool)
+        return value.toVariant();
+
+    switch (value.type()) {
+    case QCborValue::Array: {
+        const QCborArray array = value.toArray();
+        QVariantList list;
+        list.reserve(array.size());
+        for (const QCborValue &v : array)
+            list.append(toVariant(v, keyPool));
+        return list;
+    }
+    case QCborValue::Map:
+        return value.toMap().toVariantMap(keyPool);
+    case QCborValue::Tag:
+        return toVariant(value.taggedValue(), keyPool);
+    default:
+        return value.toVariant();
+    }
+}
+
+/*!
+    \overload
+    \since 6.5
+
+    If \a keyPool is not null, the keys of this map and of the maps that it
+    contains are interned in \a keyPool, so that equal keys share their data
+    with each other and with the other strings in the pool.
+
+    \sa QStringPool
+ */
+QVariantMap QCborMap::toVariantMap(QStringPool *keyPool) const
 {
     QVariantMap retval;
     for (qsizetype i = 0; i < 2 * size(); i += 2)
-        retval.insert(makeString(d.data(), i), d->valueAt(i + 1).toVariant());
+        retval.insert(makeKey(d.data(), i, keyPool), toVariant(d->valueAt(i + 1), keyPool));
     return retval;
 }
 
@@ -904,11 +958,26 @@ QVariantMap QCborMap::toVariantMap() const
         QCborArray::toVariantList()
  */
 QVariantHash QCborMap::toVariantHash() const
+{
+    return toVariantHash(nullptr);
+}
+
+/*!
+    \overload
+    \since 6.5
+
+    If \a keyPool is not null, the keys of this map are interned in \a
+    keyPool, and so are the keys of the maps that it contains, which are
+    converted to QVariantMap.
+
+    \sa QStringPool
+ */
+QVariantHash QCborMap::toVariantHash(QStringPool *keyPool) const
 {
     QVariantHash retval;
     retval.reserve(size());
     for (qsizetype i = 0; i < 2 * size(); i += 2)
-        retval.insert(makeString(d.data(), i), d->valueAt(i + 1).toVariant());
+        retval.insert(makeKey(d.data(), i, keyPool), toVariant(d->valueAt(i + 1), keyPool));
     return retval;
 }
 
@@ -0,0 +1,480 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qjsonlazyvalue.h"
+
+#include <qjsonarray.h>
+#include <qjsondocument.h>
+#include <qjsonobject.h>
+#include <qstringlist.h>
+
+#include <private/qjsonparser_p.h>
+#include <private/qstringconverter_p.h>
+
+QT_BEGIN_NAMESPACE
+
+using namespace QJsonPrivate;
+
+/*!
+    \class QJsonLazyValue
+    \inmodule QtCore
+    \ingroup json
+    \ingroup shared
+    \reentrant
+    \since 6.5
+
+    \brief The QJsonLazyValue class provides read-only access to a JSON
+    document without converting all of it.
+
+    QJsonDocument::fromJson() converts the whole document into QJsonObject,
+    QJsonArray and QJsonValue objects, even if only a few of the values are
+    needed later. QJsonLazyValue::fromJson() only validates the document and
+    records where each value is located in it. Strings and numbers are
+    converted when they are read, and objects and arrays are only converted
+    to QJsonObject and QJsonArray when toJsonValue() is called. This makes it
+    suitable for large documents of which only a small part is used, for
+    instance to decide where to forward them:
+
+    \snippet code/src_corelib_serialization_qjsonlazyvalue.cpp 0
+
+    A QJsonLazyValue keeps a reference to the QByteArray it was created from,
+    and to an index that takes a few dozen bytes for each value in the
+    document. The values returned by value(), at() and operator[]() share
+    both with the value they were obtained from.
+
+    Objects are not sorted and may contain duplicate keys: keys() lists them
+    in the order in which they appear in the document, and size() counts
+    every member. Like QJsonObject, value() returns the last of several
+    members with the same key. Looking up a member or an array element takes
+    time proportional to the number of values before it in the object or
+    array.
+
+    \sa QJsonDocument, QJsonValue, {JSON Support in Qt}
+*/
+
+/*!
+    Constructs an undefined QJsonLazyValue.
+
+    \sa isUndefined()
+*/
+QJsonLazyValue::QJsonLazyValue() noexcept = default;
+
+/*!
+    Destroys the QJsonLazyValue.
+*/
+QJsonLazyValue::~QJsonLazyValue() = default;
+
+/*!
+    Creates a copy of \a other.
+*/
+QJsonLazyValue::QJsonLazyValue(const QJsonLazyValue &other) noexcept = default;
+
+/*!
+    Assigns \a other to this value and returns a reference to this value.
+*/
+QJsonLazyValue &QJsonLazyValue::operator=(const QJsonLazyValue &other) noexcept = default;
+
+/*!
+    Move-constructs a QJsonLazyValue from \a other.
+*/
+QJsonLazyValue::QJsonLazyValue(QJsonLazyValue &&other) noexcept
+    : d(std::move(other.d)), n(std::exchange(other.n, -1))
+{
+}
+
+/*!
+    \fn QJsonLazyValue &QJsonLazyValue::operator=(QJsonLazyValue &&other)
+
+    Move-assigns \a other to this value.
+*/
+
+/*!
+    \fn void QJsonLazyValue::swap(QJsonLazyValue &other)
+
+    Swaps the value \a other with this. This operation is very fast and never
+    fails.
+*/
+
+QJsonLazyValue::QJsonLazyValue(LazyDocument *d, qsizetype n)
+    : d(d), n(n)
+{
+}
+
+/*!
+    Indexes the JSON document \a json and returns its top-level object or
+    array.
+
+    The document is validated as by QJsonDocument::fromJson(), and \a error,
+    if not \nullptr, reports the same errors at the same offsets. If the
+    document is not valid, an undefined value is returned.
+
+    \sa QJsonDocument::fromJson(), toJsonValue()
+*/
+QJsonLazyValue QJsonLazyValue::fromJson(const QByteArray &json, QJsonParseError *error)
+{
+    QExplicitlySharedDataPointer<LazyDocument> d(new LazyDocument);
+    d->json = json;
+    Parser parser(json.constData(), json.size());
+    if (!parser.buildIndex(&d->nodes, error))
+        return QJsonLazyValue();
+    return QJsonLazyValue(d.data(), 0);
+}
+
+/*!
+    Returns the type of the value.
+
+    \sa QJsonValue::Type
+*/
+QJsonValue::Type QJsonLazyValue::type() const
+{
+    return d ? d->nodes.at(n).type : QJsonValue::Undefined;
+}
+
+/*!
+    \fn bool QJsonLazyValue::isNull() const
+
+    Returns \c true if the value is null.
+*/
+
+/*!
+    \fn bool QJsonLazyValue::isBool() const
+
+    Returns \c true if the value contains a boolean.
+
+    \sa toBool()
+*/
+
+/*!
+    \fn bool QJsonLazyValue::isDouble() const
+
+    Returns \c true if the value contains a number.
+
+    \sa toDouble(), toInteger()
+*/
+
+/*!
+    \fn bool QJsonLazyValue::isString() const
+
+    Returns \c true if the value contains a string.
+
+    \sa toString()
+*/
+
+/*!
+    \fn bool QJsonLazyValue::isArray() const
+
+    Returns \c true if the value contains an array.
+
+    \sa at(), size()
+*/
+
+/*!
+    \fn bool QJsonLazyValue::isObject() const
+
+    Returns \c true if the value contains an object.
+
+    \sa value(), keys()
+*/
+
+/*!
+    \fn bool QJsonLazyValue::isUndefined() const
+
+    Returns \c true if the value is undefined. This is the case for
+    default-constructed values, for values looked up in an object that
+    doesn't contain them or at an index out of range, and for documents that
+    could not be parsed.
+*/
+
+/*!
+    Returns the boolean contained in the value, or \a defaultValue if the
+    value is not a boolean.
+*/
+bool QJsonLazyValue::toBool(bool defaultValue) const
+{
+    if (type() != QJsonValue::Bool)
+        return defaultValue;
+    return d->nodes.at(n).integer;
+}
+
+/*!
+    Returns the number contained in the value as an int, or \a defaultValue
+    if the value is not a number or not a whole number that fits into an
+    int.
+
+    \sa QJsonValue::toInt()
+*/
+int QJsonLazyValue::toInt(int defaultValue) const
+{
+    return isDouble() ? toJsonValue().toInt(defaultValue) : defaultValue;
+}
+
+/*!
+    Returns the number contained in the value as a qint64, or
+    \a defaultValue if the value is not a number or not a whole number that
+    fits into a qint64.
+
+    \sa QJsonValue::toInteger()
+*/
+qint64 QJsonLazyValue::toInteger(qint64 defaultValue) const
+{
+    return isDouble() ? toJsonValue().toInteger(defaultValue) : defaultValue;
+}
+
+/*!
+    Returns the number contained in the value, or \a defaultValue if the
+    value is not a number.
+*/
+double QJsonLazyValue::toDouble(double defaultValue) const
+{
+    return isDouble() ? toJsonValue().toDouble(defaultValue) : defaultValue;
+}
+
+/*!
+    Returns the string contained in the value, decoding it from the JSON
+    text, or a null QString if the value is not a string.
+*/
+QString QJsonLazyValue::toString() const
+{
+    return toString(QString());
+}
+
+/*!
+    \overload
+
+    Returns the string contained in the value, or \a defaultValue if the
+    value is not a string.
+*/
+QString QJsonLazyValue::toString(const QString &defaultValue) const
+{
+    if (type() != QJsonValue::String)
+        return defaultValue;
+    const LazyNode &node = d->nodes.at(n);
+    const char *json = d->json.constData();
+    return Parser::decodeString(json + node.begin, json + node.end, node.flags);
+}
+
+/*!
+    Returns the number of elements of an array, or the number of members of
+    an object, including those with duplicate keys. Returns 0 for any other
+    value.
+
+    \sa isEmpty()
+*/
+qsizetype QJsonLazyValue::size() const
+{
+    const QJsonValue::Type t = type();
+    if (t != QJsonValue::Array && t != QJsonValue::Object)
+        return 0;
+    return d->nodes.at(n).size;
+}
+
+/*!
+    \fn bool QJsonLazyValue::isEmpty() const
+
+    Returns \c true if the value is not an array or object, or is an empty
+    one.
+
+    \sa size()
+*/
+
+/*!
+    Returns the keys of an object, in the order in which they appear in the
+    document. Returns an empty list if the value is not an object.
+*/
+QStringList QJsonLazyValue::keys() const
+{
+    QStringList result;
+    if (!isObject())
+        return result;
+    result.reserve(size());
+    const char *json = d->json.constData();
+    for (qsizetype i = n + 1, end = d->nodes.at(n).next; i < end;) {
+        const LazyNode &key = d->nodes.at(i);
+        result.append(Parser::decodeString(json + key.begin, json + key.end, key.flags));
+        i = d->nodes.at(i + 1).next;
+    }
+    return result;
+}
+
+static bool keyEquals(const LazyNode &node, const char *json, QStringView key)
+{
+    if (node.flags & LazyNode::StringHasEscapes)
+        return Parser::decodeString(json + node.begin, json + node.end, node.flags) == key;
+    const QByteArrayView utf8(json + node.begin + 1, node.end - node.begin - 2);
+    return QUtf8::compareUtf8(utf8, key) == 0;
+}
+
+static bool keyEquals(const LazyNode &node, const char *json, QLatin1StringView key)
+{
+    if (node.flags & LazyNode::StringHasEscapes)
+        return Parser::decodeString(json + node.begin, json + node.end, node.flags) == key;
+    const QByteArrayView utf8(json + node.begin + 1, node.end - node.begin - 2);
+    return QUtf8::compareUtf8(utf8, key) == 0;
+}
+
+// returns the node of the value of the last member named key, or -1
+template <typename String>
+qsizetype QJsonLazyValue::findMember(String key) const
+{
+    qsizetype found = -1;
+    if (!isObject())
+        return found;
+    const char *json = d->json.constData();
+    for (qsizetype i = n + 1, end = d->nodes.at(n).next; i < end;) {
+        if (keyEquals(d->nodes.at(i), json, key))
+            found = i + 1;
+        i = d->nodes.at(i + 1).next;
+    }
+    return found;
+}
+
+/*!
+    \fn bool QJsonLazyValue::contains(const QString &key) const
+
+    Returns \c true if the value is an object that contains a member named
+    \a key.
+
+    \sa value()
+*/
+
+/*!
+    \overload
+*/
+bool QJsonLazyValue::contains(QStringView key) const
+{
+    return findMember(key) >= 0;
+}
+
+/*!
+    \overload
+*/
+bool QJsonLazyValue::contains(QLatin1StringView key) const
+{
+    return findMember(key) >= 0;
+}
+
+/*!
+    \fn QJsonLazyValue QJsonLazyValue::value(const QString &key) const
+
+    Returns the value of the member named \a key if this value is an object.
+    If the object contains several members with that name, the last one is
+    returned. Returns an undefined value if there is no such member, or if
+    this value is not an object.
+
+    \sa contains(), operator[]()
+*/
+
+/*!
+    \overload
+*/
+QJsonLazyValue QJsonLazyValue::value(QStringView key) const
+{
+    const qsizetype found = findMember(key);
+    return found < 0 ? QJsonLazyValue() : QJsonLazyValue(d.data(), found);
+}
+
+/*!
+    \overload
+*/
+QJsonLazyValue QJsonLazyValue::value(QLatin1StringView key) const
+{
+    const qsizetype found = findMember(key);
+    return found < 0 ? QJsonLazyValue() : QJsonLazyValue(d.data(), found);
+}
+
+/*!
+    Returns the element at index position \a i if this value is an array.
+    Returns an undefined value if \a i is out of range, or if this value is
+    not an array.
+
+    \sa size(), operator[]()
+*/
+QJsonLazyValue QJsonLazyValue::at(qsizetype i) const
+{
+    if (!isArray() || i < 0 || i >= size())
+        return QJsonLazyValue();
+    qsizetype node = n + 1;
+    while (i--)
+        node = d->nodes.at(node).next;
+    return QJsonLazyValue(d.data(), node);
+}
+
+/*!
+    \fn QJsonLazyValue QJsonLazyValue::operator[](const QString &key) const
+
+    Same as value(\a key).
+*/
+
+/*!
+    \fn QJsonLazyValue QJsonLazyValue::operator[](QStringView key) const
+    \overload
+*/
+
+/*!
+    \fn QJsonLazyValue QJsonLazyValue::operator[](QLatin1StringView key) const
+    \overload
+*/
+
+/*!
+    \fn QJsonLazyValue QJsonLazyValue::operator[](qsizetype i) const
+    \overload
+
+    Same as at(\a i).
+*/
+
+/*!
+    Returns the text of the value in the JSON document, without surrounding
+    whitespace. For strings, the text includes the quotation marks and is
+    not unescaped. This allows passing on part of a document without
+    converting it.
+
+    The returned view remains valid as long as any QJsonLazyValue obtained
+    from the same document exists.
+*/
+QByteArrayView QJsonLazyValue::rawJson() const
+{
+    if (!d)
+        return QByteArrayView();
+    const LazyNode &node = d->nodes.at(n);
+    return QByteArrayView(d->json.constData() + node.begin, node.end - node.begin);
+}
+
+/*!
+    Converts the value to a QJsonValue. This converts all the values
+    contained in an array or object.
+
+    The result is the same as the corresponding value in the QJsonDocument
+    that QJsonDocument::fromJson() returns for the whole document.
+*/
+QJsonValue QJsonLazyValue::toJsonValue() const
+{
+    if (!d)
+        return QJsonValue(QJsonValue::Undefined);
+
+    const LazyNode &node = d->nodes.at(n);
+    switch (node.type) {
+    case QJsonValue::Null:
+        return QJsonValue(QJsonValue::Null);
+    case QJsonValue::Bool:
+        return QJsonValue(bool(node.integer));
+    case QJsonValue::Double:
+        if (node.flags & LazyNode::IsInteger)
+            return QJsonValue(node.integer);
+        return QJsonValue(node.real);
+    case QJsonValue::String:
+        return QJsonValue(toString());
+    case QJsonValue::Array:
+    case QJsonValue::Object:
+        break;
+    case QJsonValue::Undefined:
+        Q_UNREACHABLE();
+    }
+
+    // the document has been validated, so this part of it is valid as well
+    const QByteArrayView json = rawJson();
+    const QJsonDocument doc =
+            QJsonDocument::fromJson(QByteArray::fromRawData(json.data(), json.size()));
+    return node.type == QJsonValue::Array ? QJsonValue(doc.array()) : QJsonValue(doc.object());
+}
+
+QT_END_NAMESPACE
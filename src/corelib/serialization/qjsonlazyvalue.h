@@ -0,0 +1,92 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QJSONLAZYVALUE_H
+#define QJSONLAZYVALUE_H
+
+#include <QtCore/qjsonvalue.h>
+#include <QtCore/qshareddata.h>
+#include <QtCore/qstringlist.h>
+
+QT_BEGIN_NAMESPACE
+
+struct QJsonParseError;
+
+namespace QJsonPrivate {
+class LazyDocument;
+}
+
+class Q_CORE_EXPORT QJsonLazyValue
+{
+public:
+    QJsonLazyValue() noexcept;
+    ~QJsonLazyValue();
+
+    QJsonLazyValue(const QJsonLazyValue &other) noexcept;
+    QJsonLazyValue &operator=(const QJsonLazyValue &other) noexcept;
+    QJsonLazyValue(QJsonLazyValue &&other) noexcept;
+    QT_MOVE_ASSIGNMENT_OPERATOR_IMPL_VIA_PURE_SWAP(QJsonLazyValue)
+
+    void swap(QJsonLazyValue &other) noexcept
+    {
+        d.swap(other.d);
+        std::swap(n, other.n);
+    }
+
+    static QJsonLazyValue fromJson(const QByteArray &json, QJsonParseError *error = nullptr);
+
+    QJsonValue::Type type() const;
+    bool isNull() const { return type() == QJsonValue::Null; }
+    bool isBool() const { return type() == QJsonValue::Bool; }
+    bool isDouble() const { return type() == QJsonValue::Double; }
+    bool isString() const { return type() == QJsonValue::String; }
+    bool isArray() const { return type() == QJsonValue::Array; }
+    bool isObject() const { return type() == QJsonValue::Object; }
+    bool isUndefined() const { return type() == QJsonValue::Undefined; }
+
+    bool toBool(bool defaultValue = false) const;
+    int toInt(int defaultValue = 0) const;
+    qint64 toInteger(qint64 defaultValue = 0) const;
+    double toDouble(double defaultValue = 0) const;
+    QString toString() const;
+    QString toString(const QString &defaultValue) const;
+
+    qsizetype size() const;
+    bool isEmpty() const { return size() == 0; }
+    QStringList keys() const;
+#if QT_STRINGVIEW_LEVEL < 2
+    bool contains(const QString &key) const { return contains(QStringView(key)); }
+#endif
+    bool contains(QStringView key) const;
+    bool contains(QLatin1StringView key) const;
+
+#if QT_STRINGVIEW_LEVEL < 2
+    QJsonLazyValue value(const QString &key) const { return value(QStringView(key)); }
+#endif
+    QJsonLazyValue value(QStringView key) const;
+    QJsonLazyValue value(QLatin1StringView key) const;
+    QJsonLazyValue at(qsizetype i) const;
+
+#if QT_STRINGVIEW_LEVEL < 2
+    QJsonLazyValue operator[](const QString &key) const { return value(QStringView(key)); }
+#endif
+    QJsonLazyValue operator[](QStringView key) const { return value(key); }
+    QJsonLazyValue operator[](QLatin1StringView key) const { return value(key); }
+    QJsonLazyValue operator[](qsizetype i) const { return at(i); }
+
+    QByteArrayView rawJson() const;
+    QJsonValue toJsonValue() const;
+
+private:
+    QJsonLazyValue(QJsonPrivate::LazyDocument *d, qsizetype n);
+    template <typename String> qsizetype findMember(String key) const;
+
+    QExplicitlySharedDataPointer<QJsonPrivate::LazyDocument> d;
+    qsizetype n = -1;
+};
+
+Q_DECLARE_SHARED(QJsonLazyValue)
+
+QT_END_NAMESPACE
+
+#endif // QJSONLAZYVALUE_H
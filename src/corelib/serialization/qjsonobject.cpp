@@ -193,6 +193,22 @@ QVariantMap QJsonObject::toVariantMap() const
     return QCborMap::fromJsonObject(*this).toVariantMap();
 }
 
+/*!
+    \overload
+    \since 6.5
+
+    If \a keyPool is not null, the keys of this object and of the objects that
+    it contains are interned in \a keyPool, so that equal keys share their
+    data with each other and with the other strings in the pool. This saves
+    memory when many objects with the same keys are converted.
+
+    \sa QStringPool
+ */
+QVariantMap QJsonObject::toVariantMap(QStringPool *keyPool) const
+{
+    return QCborMap::fromJsonObject(*this).toVariantMap(keyPool);
+}
+
 /*!
     Converts the variant hash \a hash to a QJsonObject.
     \since 5.5
@@ -228,6 +244,20 @@ QVariantHash QJsonObject::toVariantHash() const
     return QCborMap::fromJsonObject(*this).toVariantHash();
 }
 
+/*!
+    \overload
+    \since 6.5
+
+    If \a keyPool is not null, the keys of this object and of the objects that
+    it contains are interned in \a keyPool.
+
+    \sa toVariantMap(), QStringPool
+ */
+QVariantHash QJsonObject::toVariantHash(QStringPool *keyPool) const
+{
+    return QCborMap::fromJsonObject(*this).toVariantHash(keyPool);
+}
+
 /*!
     Returns a list of all keys in this object.
 
@@ -13,6 +13,7 @@
 QT_BEGIN_NAMESPACE
 
 class QDebug;
+class QStringPool;
 
 class QCborContainerPrivate;
 
@@ -43,8 +44,10 @@ public:
 
     static QJsonObject fromVariantMap(const QVariantMap &map);
     QVariantMap toVariantMap() const;
+    QVariantMap toVariantMap(QStringPool *keyPool) const;
     static QJsonObject fromVariantHash(const QVariantHash &map);
     QVariantHash toVariantHash() const;
+    QVariantHash toVariantHash(QStringPool *keyPool) const;
 
     QStringList keys() const;
     qsizetype size() const;
@@ -11,6 +11,7 @@
 #include "private/qstringconverter_p.h"
 #include "private/qcborvalue_p.h"
 #include "private/qnumeric_p.h"
+#include "private/qsimd_p.h"
 
 //#define PARSER_DEBUG
 #ifdef PARSER_DEBUG
@@ -44,6 +45,7 @@ QT_BEGIN_NAMESPACE
 #define JSONERR_DEEP_NEST   QT_TRANSLATE_NOOP("QJsonParseError", "too deeply nested document")
 #define JSONERR_DOC_LARGE   QT_TRANSLATE_NOOP("QJsonParseError", "too large document")
 #define JSONERR_GARBAGEEND  QT_TRANSLATE_NOOP("QJsonParseError", "garbage at the end of the document")
+#define JSONERR_PREMATURE   QT_TRANSLATE_NOOP("QJsonParseError", "premature end of document")
 
 /*!
     \class QJsonParseError
@@ -78,6 +80,9 @@ QT_BEGIN_NAMESPACE
     \value DeepNesting              The JSON document is too deeply nested for the parser to parse it
     \value DocumentTooLarge         The JSON document is too large for the parser to parse it
     \value GarbageAtEnd             The parsed document contains additional garbage characters at the end
+    \value PrematureEndOfDocument   The input ended before a value was complete. This error is
+                                    only reported by QJsonStreamReader, which can recover from it
+                                    when more data arrives. This value was added in Qt 6.5.
 
 */
 
@@ -153,6 +158,9 @@ QString QJsonParseError::errorString() const
     case GarbageAtEnd:
         sz = JSONERR_GARBAGEEND;
         break;
+    case PrematureEndOfDocument:
+        sz = JSONERR_PREMATURE;
+        break;
     }
 #ifndef QT_BOOTSTRAPPED
     return QCoreApplication::translate("QJsonParseError", sz);
@@ -247,18 +255,94 @@ void Parser::eatBOM()
         json += 3;
 }
 
-bool Parser::eatSpace()
+// Returns a pointer to the first character in [ptr, end) that is not JSON
+// whitespace, or end if there is none.
+const char *Parser::skipWhitespace(const char *ptr, const char *end)
 {
-    while (json < end) {
-        if (*json > Space)
+    // Compact JSON has no whitespace to skip at all
+    if (ptr == end || uchar(*ptr) > Space)
+        return ptr;
+
+#if defined(__SSE2__)
+    const __m128i space = _mm_set1_epi8(Space);
+    const __m128i tab = _mm_set1_epi8(Tab);
+    const __m128i lineFeed = _mm_set1_epi8(LineFeed);
+    const __m128i carriageReturn = _mm_set1_epi8(Return);
+    for ( ; end - ptr >= 16; ptr += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+        const __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(data, space),
+                                                     _mm_cmpeq_epi8(data, tab)),
+                                        _mm_or_si128(_mm_cmpeq_epi8(data, lineFeed),
+                                                     _mm_cmpeq_epi8(data, carriageReturn)));
+        const uint mask = ~uint(_mm_movemask_epi8(ws)) & 0xffff;
+        if (mask)
+            return ptr + qCountTrailingZeroBits(mask);
+    }
+#elif defined(__ARM_NEON__)
+    const uint8x16_t vmask = { 1, 1 << 1, 1 << 2, 1 << 3, 1 << 4, 1 << 5, 1 << 6, 1 << 7,
+                               1, 1 << 1, 1 << 2, 1 << 3, 1 << 4, 1 << 5, 1 << 6, 1 << 7 };
+    for ( ; end - ptr >= 16; ptr += 16) {
+        const uint8x16_t data = vld1q_u8(reinterpret_cast<const uint8_t *>(ptr));
+        const uint8x16_t ws = vorrq_u8(vorrq_u8(vceqq_u8(data, vdupq_n_u8(Space)),
+                                                vceqq_u8(data, vdupq_n_u8(Tab))),
+                                       vorrq_u8(vceqq_u8(data, vdupq_n_u8(LineFeed)),
+                                                vceqq_u8(data, vdupq_n_u8(Return))));
+        const uint8x16_t bits = vandq_u8(vmvnq_u8(ws), vmask);
+        const uint mask = vaddv_u8(vget_low_u8(bits)) | (vaddv_u8(vget_high_u8(bits)) << 8);
+        if (mask)
+            return ptr + qCountTrailingZeroBits(mask);
+    }
+#endif
+
+    for ( ; ptr < end; ++ptr) {
+        if (*ptr != Space && *ptr != Tab && *ptr != LineFeed && *ptr != Return)
             break;
-        if (*json != Space &&
-            *json != Tab &&
-            *json != LineFeed &&
-            *json != Return)
+    }
+    return ptr;
+}
+
+// Returns a pointer to the first character in [ptr, end) that is a quotation
+// mark, a backslash or not US-ASCII, or end if there is none. Everything
+// before it can be copied verbatim into a string.
+static const char *findStringSpecial(const char *ptr, const char *end)
+{
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8(Quote);
+    const __m128i backslash = _mm_set1_epi8('\\');
+    for ( ; end - ptr >= 16; ptr += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+        const __m128i special = _mm_or_si128(_mm_cmpeq_epi8(data, quote),
+                                             _mm_cmpeq_epi8(data, backslash));
+        // the sign bit of the data is set for non-ASCII characters
+        const uint mask = uint(_mm_movemask_epi8(_mm_or_si128(special, data)));
+        if (mask)
+            return ptr + qCountTrailingZeroBits(mask);
+    }
+#elif defined(__ARM_NEON__)
+    const uint8x16_t vmask = { 1, 1 << 1, 1 << 2, 1 << 3, 1 << 4, 1 << 5, 1 << 6, 1 << 7,
+                               1, 1 << 1, 1 << 2, 1 << 3, 1 << 4, 1 << 5, 1 << 6, 1 << 7 };
+    for ( ; end - ptr >= 16; ptr += 16) {
+        const uint8x16_t data = vld1q_u8(reinterpret_cast<const uint8_t *>(ptr));
+        const uint8x16_t special = vorrq_u8(vorrq_u8(vceqq_u8(data, vdupq_n_u8(Quote)),
+                                                     vceqq_u8(data, vdupq_n_u8('\\'))),
+                                            vcgtq_u8(data, vdupq_n_u8(0x7f)));
+        const uint8x16_t bits = vandq_u8(special, vmask);
+        const uint mask = vaddv_u8(vget_low_u8(bits)) | (vaddv_u8(vget_high_u8(bits)) << 8);
+        if (mask)
+            return ptr + qCountTrailingZeroBits(mask);
+    }
+#endif
+
+    for ( ; ptr < end; ++ptr) {
+        if (*ptr == Quote || *ptr == '\\' || uchar(*ptr) > 0x7f)
             break;
-        ++json;
     }
+    return ptr;
+}
+
+bool Parser::eatSpace()
+{
+    json = skipWhitespace(json, end);
     return (json < end);
 }
 
@@ -343,6 +427,109 @@ error:
     return QCborValue();
 }
 
+/*
+    Validates the document like parse() does, but instead of building the
+    containers, records the position of every value in \a nodes.
+*/
+bool Parser::buildIndex(QList<LazyNode> *nodes, QJsonParseError *error)
+{
+    index = nodes;
+    eatBOM();
+    char token = nextToken();
+
+    if (token == BeginArray || token == BeginObject) {
+        const qsizetype node = beginIndexNode(token == BeginArray ? QJsonValue::Array
+                                                                  : QJsonValue::Object);
+        if (token == BeginArray ? parseArray() : parseObject()) {
+            endIndexNode(node);
+            eatSpace();
+            if (json < end)
+                lastError = QJsonParseError::GarbageAtEnd;
+        }
+    } else {
+        lastError = QJsonParseError::IllegalValue;
+    }
+
+    if (error) {
+        error->offset = lastError == QJsonParseError::NoError ? 0 : json - head;
+        error->error = lastError;
+    }
+    if (lastError != QJsonParseError::NoError) {
+        nodes->clear();
+        return false;
+    }
+    return true;
+}
+
+void Parser::append(const char *start, const QCborValue &value)
+{
+    if (!index) {
+        container->append(value);
+        return;
+    }
+
+    LazyNode node = {};
+    node.begin = start - head;
+    node.end = json - head;
+    node.next = index->size() + 1;
+    switch (value.type()) {
+    case QCborValue::Null:
+        node.type = QJsonValue::Null;
+        break;
+    case QCborValue::False:
+    case QCborValue::True:
+        node.type = QJsonValue::Bool;
+        node.integer = value.isTrue();
+        break;
+    case QCborValue::Integer:
+        node.type = QJsonValue::Double;
+        node.flags = LazyNode::IsInteger;
+        node.integer = value.toInteger();
+        break;
+    default:
+        Q_ASSERT(value.isDouble());
+        node.type = QJsonValue::Double;
+        node.real = value.toDouble();
+        break;
+    }
+    index->append(node);
+}
+
+// start points past the opening quotation mark, json past the closing one
+void Parser::appendString(const char *start, quint8 flags)
+{
+    LazyNode node = {};
+    node.type = QJsonValue::String;
+    node.flags = flags;
+    node.begin = start - 1 - head;
+    node.end = json - head;
+    node.next = index->size() + 1;
+    index->append(node);
+}
+
+// json points to the opening bracket
+qsizetype Parser::beginIndexNode(QJsonValue::Type type)
+{
+    LazyNode node = {};
+    node.type = type;
+    node.begin = json - 1 - head;
+    index->append(node);
+    return index->size() - 1;
+}
+
+// json points past the closing bracket
+void Parser::endIndexNode(qsizetype n)
+{
+    qsizetype count = 0;
+    for (qsizetype i = n + 1; i < index->size(); i = index->at(i).next)
+        ++count;
+
+    LazyNode &node = (*index)[n];
+    node.end = json - head;
+    node.next = index->size();
+    node.size = node.type == QJsonValue::Object ? count / 2 : count;
+}
+
 // We need to retain the _last_ value for any duplicate keys and we need to deref containers.
 // Therefore the manual implementation of std::unique().
 template<typename Iterator, typename Compare, typename Assign>
@@ -457,7 +644,7 @@ bool Parser::parseObject()
 
     char token = nextToken();
     while (token == Quote) {
-        if (!container)
+        if (!container && !index)
             container = new QCborContainerPrivate;
         if (!parseMember())
             return false;
@@ -535,7 +722,7 @@ bool Parser::parseArray()
                 lastError = QJsonParseError::UnterminatedArray;
                 return false;
             }
-            if (!container)
+            if (!container && !index)
                 container = new QCborContainerPrivate;
             if (!parseValue())
                 return false;
@@ -578,7 +765,7 @@ bool Parser::parseValue()
         if (*json++ == 'u' &&
             *json++ == 'l' &&
             *json++ == 'l') {
-            container->append(QCborValue(QCborValue::Null));
+            append(json - 4, QCborValue(QCborValue::Null));
             DEBUG << "value: null";
             END;
             return true;
@@ -593,7 +780,7 @@ bool Parser::parseValue()
         if (*json++ == 'r' &&
             *json++ == 'u' &&
             *json++ == 'e') {
-            container->append(QCborValue(true));
+            append(json - 4, QCborValue(true));
             DEBUG << "value: true";
             END;
             return true;
@@ -609,7 +796,7 @@ bool Parser::parseValue()
             *json++ == 'l' &&
             *json++ == 's' &&
             *json++ == 'e') {
-            container->append(QCborValue(false));
+            append(json - 5, QCborValue(false));
             DEBUG << "value: false";
             END;
             return true;
@@ -624,17 +811,31 @@ bool Parser::parseValue()
         return true;
     }
     case BeginArray: {
-        StashedContainer stashedContainer(&container, QCborValue::Array);
-        if (!parseArray())
-            return false;
+        if (index) {
+            const qsizetype node = beginIndexNode(QJsonValue::Array);
+            if (!parseArray())
+                return false;
+            endIndexNode(node);
+        } else {
+            StashedContainer stashedContainer(&container, QCborValue::Array);
+            if (!parseArray())
+                return false;
+        }
         DEBUG << "value: array";
         END;
         return true;
     }
     case BeginObject: {
-        StashedContainer stashedContainer(&container, QCborValue::Map);
-        if (!parseObject())
-            return false;
+        if (index) {
+            const qsizetype node = beginIndexNode(QJsonValue::Object);
+            if (!parseObject())
+                return false;
+            endIndexNode(node);
+        } else {
+            StashedContainer stashedContainer(&container, QCborValue::Map);
+            if (!parseObject())
+                return false;
+        }
         DEBUG << "value: object";
         END;
         return true;
@@ -677,11 +878,11 @@ bool Parser::parseValue()
 
 */
 
-bool Parser::parseNumber()
+// Returns a pointer just past the number starting at \a json, which may be
+// \a end if the number is not terminated. \a isInteger is set to false if
+// the number has a fractional part or an exponent.
+const char *Parser::scanNumber(const char *json, const char *end, bool *isInteger)
 {
-    BEGIN << "parseNumber" << json;
-
-    const char *start = json;
     bool isInt = true;
 
     // minus
@@ -715,6 +916,18 @@ bool Parser::parseNumber()
             ++json;
     }
 
+    *isInteger = isInt;
+    return json;
+}
+
+bool Parser::parseNumber()
+{
+    BEGIN << "parseNumber" << json;
+
+    const char *start = json;
+    bool isInt;
+    json = scanNumber(json, end, &isInt);
+
     if (json >= end) {
         lastError = QJsonParseError::TerminationByNumber;
         return false;
@@ -727,7 +940,7 @@ bool Parser::parseNumber()
         bool ok;
         qlonglong n = number.toLongLong(&ok);
         if (ok) {
-            container->append(QCborValue(n));
+            append(start, QCborValue(n));
             END;
             return true;
         }
@@ -743,9 +956,9 @@ bool Parser::parseNumber()
 
     qint64 n;
     if (convertDoubleTo(d, &n))
-        container->append(QCborValue(n));
+        append(start, QCborValue(n));
     else
-        container->append(QCborValue(d));
+        append(start, QCborValue(d));
 
     END;
     return true;
@@ -845,85 +1058,130 @@ static inline bool scanUtf8Char(const char *&json, const char *end, char32_t *re
     return true;
 }
 
-bool Parser::parseString()
+// Scans a string that contains escape sequences up to the closing quotation
+// mark, appending the characters to \a out unless that is \nullptr.
+static QJsonParseError::ParseError scanEscapedString(const char *&json, const char *end,
+                                                     QString *out)
+{
+    while (json < end) {
+        const char *special = findStringSpecial(json, end);
+        if (out)
+            out->append(QLatin1StringView(json, special - json));
+        json = special;
+
+        char32_t ch = 0;
+        if (json >= end || *json == '"')
+            break;
+        else if (*json == '\\') {
+            if (!scanEscapeSequence(json, end, &ch))
+                return QJsonParseError::IllegalEscapeSequence;
+        } else {
+            if (!scanUtf8Char(json, end, &ch))
+                return QJsonParseError::IllegalUTF8String;
+        }
+        if (out)
+            out->append(QChar::fromUcs4(ch));
+    }
+    return QJsonParseError::NoError;
+}
+
+// Scans a string from just past its opening quotation mark up to and
+// including the closing one. \a flags records whether the string is plain
+// US-ASCII or contains escape sequences; in the latter case, the decoded
+// string is also stored in \a out unless that is \nullptr.
+QJsonParseError::ParseError Parser::scanString(const char *&json, const char *end,
+                                               quint8 *flags, QString *out)
 {
     const char *start = json;
 
     // try to parse a utf-8 string without escape sequences, and note whether it's 7bit ASCII.
-
-    BEGIN << "parse string" << json;
-    bool isUtf8 = true;
     bool isAscii = true;
-    while (json < end) {
+    while (true) {
         char32_t ch = 0;
-        if (*json == '"')
-            break;
-        if (*json == '\\') {
-            isAscii = false;
-            // If we find escape sequences, we store UTF-16 as there are some
-            // escape sequences which are hard to represent in UTF-8.
-            // (plain "\\ud800" for example)
-            isUtf8 = false;
-            break;
-        }
-        if (!scanUtf8Char(json, end, &ch)) {
-            lastError = QJsonParseError::IllegalUTF8String;
-            return false;
+        // skip over the US-ASCII characters in bulk
+        json = findStringSpecial(json, end);
+        if (json >= end)
+            return QJsonParseError::UnterminatedString;
+        if (*json == '"') {
+            ++json;
+            *flags = isAscii ? LazyNode::StringIsAscii : 0;
+            return QJsonParseError::NoError;
         }
+        if (*json == '\\')
+            break;
+        if (!scanUtf8Char(json, end, &ch))
+            return QJsonParseError::IllegalUTF8String;
         if (ch > 0x7f)
             isAscii = false;
         DEBUG << "  " << ch << char(ch);
     }
-    ++json;
-    DEBUG << "end of string";
-    if (json >= end) {
-        lastError = QJsonParseError::UnterminatedString;
-        return false;
-    }
-
-    // no escape sequences, we are done
-    if (isUtf8) {
-        if (isAscii)
-            container->appendAsciiString(start, json - start - 1);
-        else
-            container->appendUtf8String(start, json - start - 1);
-        END;
-        return true;
-    }
 
     DEBUG << "has escape sequences";
 
+    // If we find escape sequences, we store UTF-16 as there are some
+    // escape sequences which are hard to represent in UTF-8.
+    // (plain "\\ud800" for example)
     json = start;
-
-    QString ucs4;
-    while (json < end) {
-        char32_t ch = 0;
-        if (*json == '"')
-            break;
-        else if (*json == '\\') {
-            if (!scanEscapeSequence(json, end, &ch)) {
-                lastError = QJsonParseError::IllegalEscapeSequence;
-                return false;
-            }
-        } else {
-            if (!scanUtf8Char(json, end, &ch)) {
-                lastError = QJsonParseError::IllegalUTF8String;
-                return false;
-            }
-        }
-        ucs4.append(QChar::fromUcs4(ch));
-    }
+    *flags = LazyNode::StringHasEscapes;
+    const QJsonParseError::ParseError error = scanEscapedString(json, end, out);
+    if (error != QJsonParseError::NoError)
+        return error;
+    if (json >= end)
+        return QJsonParseError::UnterminatedString;
     ++json;
+    return QJsonParseError::NoError;
+}
 
+bool Parser::parseString()
+{
+    const char *start = json;
+
+    BEGIN << "parse string" << json;
+    quint8 flags;
+    // an index only records where the string is, to decode it when needed
+    QString ucs4;
+    lastError = scanString(json, end, &flags, index ? nullptr : &ucs4);
+    if (lastError == QJsonParseError::UnterminatedString)
+        ++json;     // the reported offset is one past the end of the input
+    if (lastError != QJsonParseError::NoError)
+        return false;
+    DEBUG << "end of string";
     if (json >= end) {
         lastError = QJsonParseError::UnterminatedString;
         return false;
     }
 
-    container->appendByteData(reinterpret_cast<const char *>(ucs4.constData()), ucs4.size() * 2,
-                              QCborValue::String, QtCbor::Element::StringIsUtf16);
+    if (index)
+        appendString(start, flags);
+    else if (flags & LazyNode::StringIsAscii)
+        container->appendAsciiString(start, json - start - 1);
+    else if (!(flags & LazyNode::StringHasEscapes))
+        container->appendUtf8String(start, json - start - 1);
+    else
+        container->appendByteData(reinterpret_cast<const char *>(ucs4.constData()),
+                                  ucs4.size() * 2, QCborValue::String,
+                                  QtCbor::Element::StringIsUtf16);
     END;
     return true;
 }
 
+/*
+    Returns the contents of the string value that the index recorded as
+    [json, end), including the quotation marks.
+*/
+QString Parser::decodeString(const char *json, const char *end, quint8 flags)
+{
+    ++json;
+    --end;
+    if (flags & LazyNode::StringIsAscii)
+        return QString::fromLatin1(json, end - json);
+    if (!(flags & LazyNode::StringHasEscapes))
+        return QString::fromUtf8(json, end - json);
+
+    QString result;
+    [[maybe_unused]] const auto error = scanEscapedString(json, end, &result);
+    Q_ASSERT(error == QJsonParseError::NoError);
+    return result;
+}
+
 QT_END_NAMESPACE
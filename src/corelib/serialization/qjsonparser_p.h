@@ -18,17 +18,56 @@
 #include <QtCore/private/qglobal_p.h>
 #include <QtCore/private/qcborvalue_p.h>
 #include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonvalue.h>
+#include <QtCore/qlist.h>
 
 QT_BEGIN_NAMESPACE
 
 namespace QJsonPrivate {
 
+// One value of a document indexed for QJsonLazyValue. The nodes are stored
+// in document order, so the children of an array or object (the key and the
+// value of each member, for objects) directly follow it.
+struct LazyNode
+{
+    enum Flag : quint8 {
+        IsInteger = 0x1,
+        StringIsAscii = 0x2,
+        StringHasEscapes = 0x4
+    };
+
+    QJsonValue::Type type;
+    quint8 flags;
+    qsizetype begin;        // offset of the value in the JSON text
+    qsizetype end;          // offset just past the value, including any closing quote
+    qsizetype next;         // index of the node following this value and its children
+    union {
+        qsizetype size;     // arrays and objects: number of elements or members
+        qint64 integer;     // booleans and integral numbers
+        double real;        // other numbers
+    };
+};
+
+class LazyDocument : public QSharedData
+{
+public:
+    QByteArray json;
+    QList<LazyNode> nodes;
+};
+
 class Parser
 {
 public:
     Parser(const char *json, int length);
 
     QCborValue parse(QJsonParseError *error);
+    bool buildIndex(QList<LazyNode> *nodes, QJsonParseError *error);
+
+    static const char *skipWhitespace(const char *ptr, const char *end);
+    static const char *scanNumber(const char *json, const char *end, bool *isInteger);
+    static QJsonParseError::ParseError scanString(const char *&json, const char *end,
+                                                  quint8 *flags, QString *out = nullptr);
+    static QString decodeString(const char *json, const char *end, quint8 flags);
 
 private:
     inline void eatBOM();
@@ -41,6 +80,11 @@ private:
     bool parseString();
     bool parseValue();
     bool parseNumber();
+    void append(const char *start, const QCborValue &value);
+    void appendString(const char *start, quint8 flags);
+    qsizetype beginIndexNode(QJsonValue::Type type);
+    void endIndexNode(qsizetype node);
+
     const char *head;
     const char *json;
     const char *end;
@@ -48,6 +92,7 @@ private:
     int nestingLevel;
     QJsonParseError::ParseError lastError;
     QExplicitlySharedDataPointer<QCborContainerPrivate> container;
+    QList<LazyNode> *index = nullptr;
 };
 
 }
@@ -0,0 +1,782 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qjsonstreamreader.h"
+
+#include <private/qjsonparser_p.h>
+#include <private/qnumeric_p.h>
+#include <qiodevice.h>
+#include <qstringpool.h>
+#include <qvarlengtharray.h>
+
+#include <cstring>
+
+QT_BEGIN_NAMESPACE
+
+using namespace QJsonPrivate;
+
+class QJsonStreamReaderPrivate
+{
+public:
+    enum {
+        // bytes read from the device at once, unless a long token needs more
+        ReadChunkSize = 16384,
+        NestingLimit = 1024
+    };
+
+    // what the reader expects to find next, apart from whitespace
+    enum State : quint8 {
+        ExpectValue,
+        ExpectValueOrEnd,       // just after the start of an array
+        ExpectName,
+        ExpectNameOrEnd,        // just after the start of an object
+        ExpectNameSeparator,
+        ExpectSeparatorOrEnd    // after an element or member
+    };
+
+    QIODevice *device = nullptr;
+    QStringPool *namePool = nullptr;
+    QByteArray buffer;
+    qsizetype pos = 0;          // the data in buffer before pos has been consumed
+    qint64 bufferOffset = 0;    // offset of buffer[0] in the input
+    qint64 tokenOffset = 0;
+    QVarLengthArray<bool, 16> containers;   // true for objects, false for arrays
+    State state = ExpectValue;
+    bool outOfData = false;
+
+    QJsonStreamReader::TokenType tokenType = QJsonStreamReader::NoToken;
+    QJsonParseError::ParseError error = QJsonParseError::NoError;
+    bool isInteger = false;
+    qint64 integer = 0;
+    double real = 0;
+    QString text;
+
+    void reset()
+    {
+        buffer.clear();
+        pos = 0;
+        bufferOffset = 0;
+        tokenOffset = 0;
+        containers.clear();
+        state = ExpectValue;
+        outOfData = false;
+        tokenType = QJsonStreamReader::NoToken;
+        error = QJsonParseError::NoError;
+        text.clear();
+    }
+
+    QJsonStreamReader::TokenType readNext();
+
+private:
+    bool fill();
+    bool ensureAvailable(qsizetype size);
+    bool skipSpace();
+    bool inputIsFinal() const { return !device || !device->isSequential(); }
+    void afterValue() { state = containers.isEmpty() ? ExpectValue : ExpectSeparatorOrEnd; }
+
+    QJsonStreamReader::TokenType next();
+    QJsonStreamReader::TokenType readValue(char c);
+    QJsonStreamReader::TokenType readString(QJsonStreamReader::TokenType type);
+    QJsonStreamReader::TokenType readNumber();
+    QJsonStreamReader::TokenType readLiteral(QByteArrayView literal, bool value,
+                                             QJsonStreamReader::TokenType type);
+    QJsonStreamReader::TokenType endContainer();
+
+    QJsonStreamReader::TokenType fail(QJsonParseError::ParseError e)
+    {
+        error = e;
+        tokenOffset = bufferOffset + pos;
+        return QJsonStreamReader::Invalid;
+    }
+
+    QJsonStreamReader::TokenType premature()
+    {
+        outOfData = true;
+        return fail(QJsonParseError::PrematureEndOfDocument);
+    }
+};
+
+/*
+    Reads more data from the device, discarding the data that has already been
+    consumed. Returns false if no more data is available at the moment.
+*/
+bool QJsonStreamReaderPrivate::fill()
+{
+    if (!device)
+        return false;
+
+    if (pos) {
+        buffer.remove(0, pos);
+        bufferOffset += pos;
+        pos = 0;
+    }
+
+    // Read at least as much as is buffered already: a token that is longer
+    // than a chunk is scanned again after every read, and this keeps the total
+    // work linear in its length.
+    const qsizetype size = buffer.size();
+    const qsizetype chunk = qMax(qsizetype(ReadChunkSize), size);
+    buffer.resize(size + chunk);
+    const qint64 bytesRead = device->read(buffer.data() + size, chunk);
+    buffer.resize(size + qMax(bytesRead, qint64(0)));
+    return bytesRead > 0;
+}
+
+bool QJsonStreamReaderPrivate::ensureAvailable(qsizetype size)
+{
+    while (buffer.size() - pos < size) {
+        if (!fill())
+            return false;
+    }
+    return true;
+}
+
+bool QJsonStreamReaderPrivate::skipSpace()
+{
+    while (true) {
+        const char *begin = buffer.constData();
+        pos = Parser::skipWhitespace(begin + pos, begin + buffer.size()) - begin;
+        if (pos < buffer.size())
+            return true;
+        if (!fill())
+            return false;
+    }
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::readNext()
+{
+    if (error != QJsonParseError::NoError && error != QJsonParseError::PrematureEndOfDocument)
+        return QJsonStreamReader::Invalid;
+
+    error = QJsonParseError::NoError;
+    outOfData = false;
+    text.clear();
+
+    // eat UTF-8 byte order mark
+    if (bufferOffset + pos == 0 && ensureAvailable(3)
+            && std::memcmp(buffer.constData(), "\xef\xbb\xbf", 3) == 0) {
+        pos = 3;
+    }
+
+    tokenType = next();
+    return tokenType;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::next()
+{
+    while (true) {
+        if (!skipSpace()) {
+            if (containers.isEmpty() && state == ExpectValue) {
+                // between two top-level values
+                outOfData = true;
+                tokenOffset = bufferOffset + pos;
+                return QJsonStreamReader::NoToken;
+            }
+            return premature();
+        }
+
+        tokenOffset = bufferOffset + pos;
+        const char c = buffer.at(pos);
+        switch (state) {
+        case ExpectNameSeparator:
+            if (c != ':')
+                return fail(QJsonParseError::MissingNameSeparator);
+            ++pos;
+            state = ExpectValue;
+            continue;
+        case ExpectSeparatorOrEnd:
+            if (c == ',') {
+                ++pos;
+                state = containers.last() ? ExpectName : ExpectValue;
+                continue;
+            }
+            if (c == (containers.last() ? '}' : ']'))
+                return endContainer();
+            return fail(containers.last() ? QJsonParseError::UnterminatedObject
+                                          : QJsonParseError::MissingValueSeparator);
+        case ExpectNameOrEnd:
+            if (c == '}')
+                return endContainer();
+            if (c != '"')
+                return fail(QJsonParseError::UnterminatedObject);
+            return readString(QJsonStreamReader::Name);
+        case ExpectName:
+            if (c == '"')
+                return readString(QJsonStreamReader::Name);
+            return fail(c == '}' ? QJsonParseError::MissingObject
+                                 : QJsonParseError::UnterminatedObject);
+        case ExpectValueOrEnd:
+            if (c == ']')
+                return endContainer();
+            Q_FALLTHROUGH();
+        case ExpectValue:
+            return readValue(c);
+        }
+        Q_UNREACHABLE();
+    }
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::readValue(char c)
+{
+    switch (c) {
+    case '[':
+    case '{':
+        if (containers.size() >= NestingLimit)
+            return fail(QJsonParseError::DeepNesting);
+        ++pos;
+        containers.append(c == '{');
+        if (c == '{') {
+            state = ExpectNameOrEnd;
+            return QJsonStreamReader::StartObject;
+        }
+        state = ExpectValueOrEnd;
+        return QJsonStreamReader::StartArray;
+    case '"':
+        return readString(QJsonStreamReader::String);
+    case 't':
+        return readLiteral("true", true, QJsonStreamReader::Bool);
+    case 'f':
+        return readLiteral("false", false, QJsonStreamReader::Bool);
+    case 'n':
+        return readLiteral("null", false, QJsonStreamReader::Null);
+    case ',':
+        // missing value, but after a colon, not after a comma
+        return fail(QJsonParseError::IllegalValue);
+    case ']':
+    case '}':
+        return fail(QJsonParseError::MissingObject);
+    default:
+        return readNumber();
+    }
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::readString(QJsonStreamReader::TokenType type)
+{
+    while (true) {
+        const char *begin = buffer.constData() + pos;
+        const char *end = buffer.constData() + buffer.size();
+        const char *json = begin + 1;
+        quint8 flags;
+        text.clear();
+        const auto e = Parser::scanString(json, end, &flags, &text);
+        if (e == QJsonParseError::NoError) {
+            if (!(flags & LazyNode::StringHasEscapes))
+                text = Parser::decodeString(begin, json, flags);
+            if (type == QJsonStreamReader::Name && namePool)
+                text = namePool->intern(text);
+            pos = json - buffer.constData();
+            if (type == QJsonStreamReader::Name)
+                state = ExpectNameSeparator;
+            else
+                afterValue();
+            return type;
+        }
+
+        // An escape sequence or UTF-8 character may have been cut off at the
+        // end of the data, unless the closing quotation mark follows.
+        if (e != QJsonParseError::UnterminatedString
+                && std::memchr(json, '"', end - json) != nullptr) {
+            pos = json - buffer.constData();
+            return fail(e);
+        }
+        if (!fill())
+            return premature();
+    }
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::readNumber()
+{
+    while (true) {
+        const char *begin = buffer.constData() + pos;
+        const char *end = buffer.constData() + buffer.size();
+        bool isInt;
+        const char *json = Parser::scanNumber(begin, end, &isInt);
+        // the number may continue in the data that hasn't arrived yet
+        if (json == end) {
+            if (fill())
+                continue;
+            if (!containers.isEmpty() || !inputIsFinal())
+                return premature();
+        }
+
+        const QByteArray number = QByteArray::fromRawData(begin, json - begin);
+        bool ok = false;
+        if (isInt)
+            integer = number.toLongLong(&ok);
+        isInteger = ok;
+        if (ok) {
+            real = double(integer);
+        } else {
+            real = number.toDouble(&ok);
+            if (!ok)
+                return fail(QJsonParseError::IllegalNumber);
+            isInteger = convertDoubleTo(real, &integer);
+        }
+
+        text = QString::fromLatin1(number);
+        pos = json - buffer.constData();
+        afterValue();
+        return QJsonStreamReader::Number;
+    }
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::readLiteral(QByteArrayView literal, bool value,
+                                                                   QJsonStreamReader::TokenType type)
+{
+    if (!ensureAvailable(literal.size())) {
+        // the data so far may be the beginning of the literal
+        if (literal.startsWith(QByteArrayView(buffer).sliced(pos)))
+            return premature();
+        return fail(QJsonParseError::IllegalValue);
+    }
+    if (QByteArrayView(buffer).sliced(pos, literal.size()) != literal)
+        return fail(QJsonParseError::IllegalValue);
+
+    pos += literal.size();
+    integer = value;
+    afterValue();
+    return type;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::endContainer()
+{
+    ++pos;
+    const bool isObject = containers.last();
+    containers.removeLast();
+    afterValue();
+    return isObject ? QJsonStreamReader::EndObject : QJsonStreamReader::EndArray;
+}
+
+/*!
+    \class QJsonStreamReader
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 6.5
+
+    \brief The QJsonStreamReader class is a pull parser for JSON that reads
+    one token at a time.
+
+    QJsonStreamReader reads JSON from a QIODevice or from data supplied with
+    addData() without building a QJsonDocument. Unlike
+    QJsonDocument::fromJson(), it only keeps the token that is currently being
+    read in memory, so it can process inputs of any size, as long as no single
+    string in them is larger than the available memory.
+
+    The reader works like QXmlStreamReader and QCborStreamReader: the
+    application calls readNext() to advance to the next token, and inspects
+    it with tokenType(), text() and the other accessors. Each array produces a
+    StartArray token, the tokens of its elements and an EndArray token. Each
+    object produces a StartObject token, a Name token followed by the tokens of
+    the value for each member, and an EndObject token.
+
+    \snippet code/src_corelib_serialization_qjsonstreamreader.cpp 0
+
+    The input may contain any number of top-level values separated by
+    whitespace, which makes QJsonStreamReader suitable for newline-delimited
+    JSON (NDJSON) and similar formats. When the reader has read all available
+    input after a complete value, readNext() returns NoToken and atEnd()
+    returns \c true. Values of any type are accepted at the top level.
+
+    \section1 Incremental parsing
+
+    If the input ends in the middle of a value, readNext() returns Invalid,
+    and error() returns QJsonParseError::PrematureEndOfDocument. This is not
+    a fatal error: once more data is available, either because it was
+    supplied with addData() or because it arrived on the device(), the next
+    call to readNext() continues where the previous one stopped. The reader
+    must not be given the same data twice.
+
+    A number at the end of the input cannot be distinguished from one that
+    continues in data that hasn't arrived yet. It is therefore reported as
+    PrematureEndOfDocument when reading from a sequential device, such as a
+    socket or a pipe. When reading from a QByteArray or from a random-access
+    device, the input is assumed to be complete.
+
+    All other errors are fatal: readNext() keeps returning Invalid until
+    clear() or setDevice() is called.
+
+    \sa QJsonStreamWriter, QJsonDocument, QCborStreamReader, QXmlStreamReader
+*/
+
+/*!
+    \enum QJsonStreamReader::TokenType
+
+    This enum specifies the type of the token that the reader has read.
+
+    \value NoToken      The reader has not read anything yet, or it has
+                        reached the end of the available input after a
+                        complete top-level value.
+    \value Invalid      An error occurred, as reported by error().
+    \value StartArray   The start of an array.
+    \value EndArray     The end of an array.
+    \value StartObject  The start of an object.
+    \value EndObject    The end of an object.
+    \value Name         The name of an object member; text() returns it.
+                        The tokens of its value follow.
+    \value String       A string value; text() returns it.
+    \value Number       A number; see isInteger(), toInteger() and toDouble().
+    \value Bool         The literal \c true or \c false; see toBool().
+    \value Null         The literal \c null.
+*/
+
+/*!
+    Constructs a QJsonStreamReader with no input. Use addData() or setDevice()
+    to give it data to read.
+*/
+QJsonStreamReader::QJsonStreamReader()
+    : d(new QJsonStreamReaderPrivate)
+{
+}
+
+/*!
+    Constructs a QJsonStreamReader that reads the JSON in \a data.
+*/
+QJsonStreamReader::QJsonStreamReader(const QByteArray &data)
+    : QJsonStreamReader()
+{
+    d->buffer = data;
+}
+
+/*!
+    Constructs a QJsonStreamReader that reads from \a device. The device must
+    already be open. QJsonStreamReader does not take ownership of \a device,
+    so it must remain valid until this object is destroyed.
+*/
+QJsonStreamReader::QJsonStreamReader(QIODevice *device)
+    : QJsonStreamReader()
+{
+    d->device = device;
+}
+
+/*!
+    Destroys this QJsonStreamReader object.
+*/
+QJsonStreamReader::~QJsonStreamReader()
+{
+}
+
+/*!
+    Sets the device to read from to \a device, and resets the reader to its
+    initial state.
+
+    \sa device(), clear()
+*/
+void QJsonStreamReader::setDevice(QIODevice *device)
+{
+    d->reset();
+    d->device = device;
+}
+
+/*!
+    Returns the device that was set with setDevice() or the constructor, or
+    \nullptr if the reader is reading from data added with addData().
+*/
+QIODevice *QJsonStreamReader::device() const
+{
+    return d->device;
+}
+
+/*!
+    \since 6.5
+
+    Sets the pool in which the reader interns the text of Name tokens
+    to \a pool. Documents that contain many objects with the same members then
+    only need one copy of each member name, and the names compare faster.
+    If \a pool is \nullptr, which is the default, names are not interned.
+
+    The reader does not take ownership of \a pool, which must remain valid
+    as long as it is set.
+
+    \sa namePool(), text(), QStringPool::globalInstance()
+*/
+void QJsonStreamReader::setNamePool(QStringPool *pool)
+{
+    d->namePool = pool;
+}
+
+/*!
+    \since 6.5
+
+    Returns the pool that was set with setNamePool(), or \nullptr.
+*/
+QStringPool *QJsonStreamReader::namePool() const
+{
+    return d->namePool;
+}
+
+/*!
+    Adds more \a data for the reader to read. The data is appended to any
+    input that hasn't been read yet. This function does nothing if the reader
+    has a device().
+
+    \sa readNext(), clear()
+*/
+void QJsonStreamReader::addData(const QByteArray &data)
+{
+    if (d->device) {
+        qWarning("QJsonStreamReader: addData() with device()");
+        return;
+    }
+
+    if (d->pos) {
+        d->buffer.remove(0, d->pos);
+        d->bufferOffset += d->pos;
+        d->pos = 0;
+    }
+    d->buffer += data;
+    d->outOfData = false;
+}
+
+/*!
+    Removes the device() or data from the reader and resets it to its
+    initial state.
+*/
+void QJsonStreamReader::clear()
+{
+    d->reset();
+    d->device = nullptr;
+}
+
+/*!
+    Reads the next token and returns its type.
+
+    If the reader has reached the end of the available input after a complete
+    top-level value, this function returns NoToken. If an error occurred,
+    including running out of input in the middle of a value, it returns
+    Invalid, and error() describes the error.
+
+    \sa tokenType(), atEnd(), error()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::readNext()
+{
+    return d->readNext();
+}
+
+/*!
+    Returns the type of the current token.
+
+    \sa readNext()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::tokenType() const
+{
+    return d->tokenType;
+}
+
+/*!
+    Returns \c true if the reader has read all of the input that is currently
+    available, or if a fatal error occurred; otherwise returns \c false.
+
+    When reading from a device, atEnd() returns \c false again once more data
+    has arrived, and when reading data added with addData(), once more data
+    was added.
+
+    \sa readNext(), hasError()
+*/
+bool QJsonStreamReader::atEnd() const
+{
+    if (d->error != QJsonParseError::NoError
+            && d->error != QJsonParseError::PrematureEndOfDocument) {
+        return true;
+    }
+    if (!d->outOfData)
+        return false;
+    return !d->device || d->device->atEnd();
+}
+
+/*!
+    Returns the number of arrays and objects that the reader is inside of.
+    StartArray and StartObject tokens increment this number, and EndArray and
+    EndObject tokens decrement it. It is 0 between top-level values.
+*/
+int QJsonStreamReader::depth() const
+{
+    return int(d->containers.size());
+}
+
+/*!
+    Returns the offset in the input of the current token or, if an error
+    occurred, of the position where the error was detected.
+*/
+qint64 QJsonStreamReader::offset() const
+{
+    return d->tokenOffset;
+}
+
+/*!
+    \fn bool QJsonStreamReader::isStartArray() const
+
+    Returns \c true if the current token is StartArray.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isEndArray() const
+
+    Returns \c true if the current token is EndArray.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isStartObject() const
+
+    Returns \c true if the current token is StartObject.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isEndObject() const
+
+    Returns \c true if the current token is EndObject.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isName() const
+
+    Returns \c true if the current token is Name.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isString() const
+
+    Returns \c true if the current token is String.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isNumber() const
+
+    Returns \c true if the current token is Number.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isBool() const
+
+    Returns \c true if the current token is Bool.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isNull() const
+
+    Returns \c true if the current token is Null.
+*/
+
+/*!
+    Returns the text of the current token: the decoded string for String
+    and Name tokens, and the number as it appears in the input for Number
+    tokens. For all other tokens, this function returns an empty string.
+*/
+QString QJsonStreamReader::text() const
+{
+    switch (d->tokenType) {
+    case Name:
+    case String:
+    case Number:
+        return d->text;
+    default:
+        return QString();
+    }
+}
+
+/*!
+    Returns \c true if the current token is a number that can be represented
+    exactly as a 64-bit integer.
+
+    \sa toInteger(), toDouble()
+*/
+bool QJsonStreamReader::isInteger() const
+{
+    return d->tokenType == Number && d->isInteger;
+}
+
+/*!
+    Returns the value of the current Number token as a 64-bit integer, if
+    isInteger() returns \c true. Otherwise returns 0.
+
+    \sa toDouble()
+*/
+qint64 QJsonStreamReader::toInteger() const
+{
+    return isInteger() ? d->integer : 0;
+}
+
+/*!
+    Returns the value of the current Number token. Otherwise returns 0.
+
+    \sa toInteger()
+*/
+double QJsonStreamReader::toDouble() const
+{
+    return d->tokenType == Number ? d->real : 0;
+}
+
+/*!
+    Returns the value of the current Bool token. Otherwise returns \c false.
+*/
+bool QJsonStreamReader::toBool() const
+{
+    return d->tokenType == Bool && d->integer;
+}
+
+/*!
+    Skips the current value. If the current token is StartArray or
+    StartObject, this function reads up to and including the matching
+    EndArray or EndObject token. If the current token is Name, it skips the
+    value of the member. For other tokens, it does nothing.
+
+    Returns \c true if the value was skipped completely, or \c false if an
+    error occurred, including running out of input.
+*/
+bool QJsonStreamReader::skipValue()
+{
+    switch (d->tokenType) {
+    case Name:
+        readNext();
+        if (!isStartArray() && !isStartObject())
+            return !hasError();
+        Q_FALLTHROUGH();
+    case StartArray:
+    case StartObject: {
+        const int level = depth() - 1;
+        while (readNext() != Invalid) {
+            if (depth() == level)
+                return true;
+        }
+        return false;
+    }
+    default:
+        return !hasError();
+    }
+}
+
+/*!
+    Returns \c true if an error occurred, including running out of input in
+    the middle of a value; otherwise returns \c false.
+
+    \sa error(), errorString()
+*/
+bool QJsonStreamReader::hasError() const
+{
+    return d->error != QJsonParseError::NoError;
+}
+
+/*!
+    Returns the error that occurred while reading the current token, or
+    QJsonParseError::NoError.
+
+    \sa errorString(), offset()
+*/
+QJsonParseError::ParseError QJsonStreamReader::error() const
+{
+    return d->error;
+}
+
+/*!
+    Returns a human-readable description of error().
+*/
+QString QJsonStreamReader::errorString() const
+{
+    QJsonParseError error;
+    error.error = d->error;
+    return error.errorString();
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qjsonstreamreader.cpp"
@@ -0,0 +1,382 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qjsonstreamwriter.h"
+
+#include <private/qjsonwriter_p.h>
+#include <qcborvalue.h>
+#include <qiodevice.h>
+#include <qvarlengtharray.h>
+
+QT_BEGIN_NAMESPACE
+
+using namespace QJsonPrivate;
+
+class QJsonStreamWriterPrivate
+{
+public:
+    enum {
+        // output collected before it is written to the device
+        WriteChunkSize = 16384
+    };
+
+    struct Container
+    {
+        bool isObject;
+        bool hasElements;
+    };
+
+    QIODevice *device = nullptr;
+    QByteArray *data = nullptr;
+    QByteArray buffer;
+    QVarLengthArray<Container, 16> containers;
+    bool compact = false;
+    bool afterName = false;
+
+    QByteArray &json() { return data ? *data : buffer; }
+
+    int indent() const { return int(containers.size()); }
+
+    // writes the separator and indentation before an element or member
+    void separate()
+    {
+        Container &container = containers.last();
+        QByteArray &out = json();
+        if (container.hasElements)
+            out += compact ? "," : ",\n";
+        container.hasElements = true;
+        if (!compact)
+            out.append(4 * indent(), ' ');
+    }
+
+    void beginValue()
+    {
+        if (containers.isEmpty())
+            return;
+        if (containers.last().isObject) {
+            Q_ASSERT_X(afterName, "QJsonStreamWriter", "object members need a name");
+            afterName = false;
+            return;
+        }
+        separate();
+    }
+
+    void endValue()
+    {
+        if (!containers.isEmpty()) {
+            if (buffer.size() >= WriteChunkSize)
+                flush();
+            return;
+        }
+
+        // each top-level value is on a line of its own
+        json() += '\n';
+        flush();
+    }
+
+    void startContainer(bool isObject)
+    {
+        beginValue();
+        json() += isObject ? '{' : '[';
+        if (!compact)
+            json() += '\n';
+        containers.append({ isObject, false });
+    }
+
+    bool endContainer(bool isObject)
+    {
+        if (containers.isEmpty() || containers.last().isObject != isObject || afterName)
+            return false;
+
+        const bool hasElements = containers.last().hasElements;
+        containers.removeLast();
+        QByteArray &out = json();
+        if (!compact) {
+            if (hasElements)
+                out += '\n';
+            out.append(4 * indent(), ' ');
+        }
+        out += isObject ? '}' : ']';
+        endValue();
+        return true;
+    }
+
+    void flush()
+    {
+        if (device && !buffer.isEmpty())
+            device->write(buffer);
+        buffer.clear();
+    }
+};
+
+/*!
+    \class QJsonStreamWriter
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 6.5
+
+    \brief The QJsonStreamWriter class writes JSON to a QIODevice or QByteArray
+    one value at a time.
+
+    QJsonStreamWriter writes JSON without building a QJsonDocument first, so
+    that large documents and long sequences of values can be produced with a
+    constant amount of memory. It provides an API similar to that of
+    QCborStreamWriter: values are written with the append() overloads, and
+    arrays and objects with startArray() and startObject(), which must be
+    terminated by the corresponding endArray() and endObject() calls. Inside
+    an object, writeName() must be called before the value of each member.
+
+    \snippet code/src_corelib_serialization_qjsonstreamwriter.cpp 0
+
+    The output uses the same formatting as QJsonDocument::toJson() with the
+    format() that was set. Each top-level value is terminated by a newline,
+    so writing several values in the QJsonDocument::Compact format produces
+    newline-delimited JSON (NDJSON).
+
+    When writing to a QIODevice, QJsonStreamWriter collects the output in
+    chunks, which it writes when a top-level value is complete, when flush()
+    is called and when the writer is destroyed.
+
+    QJsonStreamWriter does not check that the output is complete: it is up to
+    the application to end every array and object it started.
+
+    \sa QJsonStreamReader, QJsonDocument, QCborStreamWriter
+*/
+
+/*!
+    Creates a QJsonStreamWriter object that will write the JSON to \a device.
+    The device must be opened before the first append() call is made. The
+    writer does not take ownership of \a device, so it must remain valid
+    until this object is destroyed.
+
+    \sa setDevice()
+*/
+QJsonStreamWriter::QJsonStreamWriter(QIODevice *device)
+    : d(new QJsonStreamWriterPrivate)
+{
+    d->device = device;
+}
+
+/*!
+    Creates a QJsonStreamWriter object that will append the JSON to \a data.
+    The writer does not take ownership of \a data, so it must remain valid
+    until this object is destroyed.
+*/
+QJsonStreamWriter::QJsonStreamWriter(QByteArray *data)
+    : d(new QJsonStreamWriterPrivate)
+{
+    d->data = data;
+}
+
+/*!
+    Destroys this QJsonStreamWriter object, writing any pending output to the
+    device.
+*/
+QJsonStreamWriter::~QJsonStreamWriter()
+{
+    d->flush();
+}
+
+/*!
+    Makes this writer write to \a device, after writing any pending output to
+    the previous one. The writer continues where it stopped, so any arrays and
+    objects that were started must still be ended.
+
+    \sa device()
+*/
+void QJsonStreamWriter::setDevice(QIODevice *device)
+{
+    d->flush();
+    d->data = nullptr;
+    d->device = device;
+}
+
+/*!
+    Returns the device that this writer writes to, or \nullptr if it appends
+    to a QByteArray.
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamWriter::device() const
+{
+    return d->device;
+}
+
+/*!
+    Sets the format of the output written from now on to \a format. The
+    default is QJsonDocument::Indented.
+
+    \sa format()
+*/
+void QJsonStreamWriter::setFormat(QJsonDocument::JsonFormat format)
+{
+    d->compact = format == QJsonDocument::Compact;
+}
+
+/*!
+    Returns the format of the output.
+
+    \sa setFormat()
+*/
+QJsonDocument::JsonFormat QJsonStreamWriter::format() const
+{
+    return d->compact ? QJsonDocument::Compact : QJsonDocument::Indented;
+}
+
+/*!
+    Writes \a name as the name of the next member of the current object. It
+    must be followed by exactly one value. This function must only be called
+    inside an object.
+
+    \sa startObject()
+*/
+void QJsonStreamWriter::writeName(QAnyStringView name)
+{
+    if (d->containers.isEmpty() || !d->containers.last().isObject || d->afterName) {
+        qWarning("QJsonStreamWriter: writeName() must be followed by a value and can only "
+                 "be used inside an object");
+        return;
+    }
+
+    d->separate();
+    QByteArray &json = d->json();
+    json += '"';
+    json += Writer::escapedString(name.toString());
+    json += d->compact ? "\":" : "\": ";
+    d->afterName = true;
+}
+
+/*!
+    Appends the string \a str.
+*/
+void QJsonStreamWriter::append(QAnyStringView str)
+{
+    d->beginValue();
+    QByteArray &json = d->json();
+    json += '"';
+    json += Writer::escapedString(str.toString());
+    json += '"';
+    d->endValue();
+}
+
+/*!
+    \overload
+
+    Appends the integer \a i.
+*/
+void QJsonStreamWriter::append(qint64 i)
+{
+    d->beginValue();
+    d->json() += QByteArray::number(i);
+    d->endValue();
+}
+
+/*!
+    \overload
+
+    Appends the number \a d. Like QJsonDocument, QJsonStreamWriter writes
+    infinities and NaN as \c null, as JSON cannot represent them.
+*/
+void QJsonStreamWriter::append(double d)
+{
+    this->d->beginValue();
+    Writer::valueToJson(QCborValue(d), this->d->json(), 0, this->d->compact);
+    this->d->endValue();
+}
+
+/*!
+    \overload
+
+    Appends the literal \c true or \c false, depending on \a b.
+*/
+void QJsonStreamWriter::append(bool b)
+{
+    d->beginValue();
+    d->json() += b ? "true" : "false";
+    d->endValue();
+}
+
+/*!
+    \fn void QJsonStreamWriter::append(std::nullptr_t)
+    \overload
+
+    Appends the literal \c null.
+
+    \sa appendNull()
+*/
+
+/*!
+    Appends the literal \c null.
+*/
+void QJsonStreamWriter::appendNull()
+{
+    d->beginValue();
+    d->json() += "null";
+    d->endValue();
+}
+
+/*!
+    \overload
+
+    Appends \a value, including all of its elements or members if it is an
+    array or an object. Undefined values are written as \c null.
+*/
+void QJsonStreamWriter::append(const QJsonValue &value)
+{
+    d->beginValue();
+    Writer::valueToJson(QCborValue::fromJsonValue(value), d->json(),
+                        d->compact ? 0 : d->indent(), d->compact);
+    d->endValue();
+}
+
+/*!
+    Starts an array. The elements are added with the append(), startArray()
+    and startObject() functions, and the array must be ended with
+    endArray().
+*/
+void QJsonStreamWriter::startArray()
+{
+    d->startContainer(false);
+}
+
+/*!
+    Ends the array started by the last startArray() call that hasn't been
+    ended yet. Returns \c false, without writing anything, if the innermost
+    container is an object or if there is none.
+*/
+bool QJsonStreamWriter::endArray()
+{
+    return d->endContainer(false);
+}
+
+/*!
+    Starts an object. Each member is added by calling writeName() and then
+    writing its value, and the object must be ended with endObject().
+*/
+void QJsonStreamWriter::startObject()
+{
+    d->startContainer(true);
+}
+
+/*!
+    Ends the object started by the last startObject() call that hasn't been
+    ended yet. Returns \c false, without writing anything, if the innermost
+    container is an array, if there is none, or if the value of the last
+    member is missing.
+*/
+bool QJsonStreamWriter::endObject()
+{
+    return d->endContainer(true);
+}
+
+/*!
+    Writes the pending output to the device. This function does nothing when
+    writing to a QByteArray.
+*/
+void QJsonStreamWriter::flush()
+{
+    d->flush();
+}
+
+QT_END_NAMESPACE
@@ -300,7 +300,10 @@ public:
     [[nodiscard]] constexpr char last()  const { return back(); }
 
     friend inline bool operator==(QByteArrayView lhs, QByteArrayView rhs) noexcept
-    { return lhs.size() == rhs.size() && QtPrivate::compareMemory(lhs, rhs) == 0; }
+    {
+        return lhs.size() == rhs.size()
+                && (lhs.data() == rhs.data() || QtPrivate::compareMemory(lhs, rhs) == 0);
+    }
     friend inline bool operator!=(QByteArrayView lhs, QByteArrayView rhs) noexcept
     { return !(lhs == rhs); }
     friend inline bool operator< (QByteArrayView lhs, QByteArrayView rhs) noexcept
@@ -4071,11 +4071,40 @@ bool QLocaleData::validateChars(QStringView str, NumberMode numMode, QByteArray
     return true;
 }
 
+/*
+    Copies a number that consists only of ASCII digits, signs, decimal points
+    and exponent characters to \a result, like numberToCLocale() does for the
+    C locale, but without looking up the locale's symbols for each character.
+    Returns false if \a s contains any other character.
+*/
+static bool plainNumberToCLocale(QStringView s, QLocaleData::CharBuff *result)
+{
+    if (s.isEmpty())
+        return false;
+    result->resize(s.size() + 1);
+    char *out = result->data();
+    for (QChar ch : s) {
+        const char16_t c = ch.unicode();
+        if ((c < u'0' || c > u'9') && c != u'.' && c != u'-' && c != u'+' && c != u'e'
+                && c != u'E') {
+            result->clear();
+            return false;
+        }
+        *out++ = char(c);
+    }
+    *out = '\0';
+    return true;
+}
+
 double QLocaleData::stringToDouble(QStringView str, bool *ok,
                                    QLocale::NumberOptions number_options) const
 {
+    constexpr QLocale::NumberOptions ExtraChecks =
+            QLocale::RejectLeadingZeroInExponent | QLocale::RejectTrailingZeroesAfterDot;
     CharBuff buff;
-    if (!numberToCLocale(str, number_options, &buff)) {
+    const bool plain = this == c() && !(number_options & ExtraChecks)
+            && plainNumberToCLocale(str, &buff);
+    if (!plain && !numberToCLocale(str, number_options, &buff)) {
         if (ok != nullptr)
             *ok = false;
         return 0.0;
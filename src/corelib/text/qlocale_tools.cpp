@@ -39,6 +39,51 @@ QT_BEGIN_NAMESPACE
 
 QT_CLOCALE_HOLDER
 
+#if defined(__cpp_lib_to_chars) && !defined(QT_NO_DOUBLECONVERSION) && !defined(QT_BOOTSTRAPPED)
+// std::to_chars and std::from_chars implement shortest round-trip formatting
+// and correctly rounded parsing with faster algorithms (Ryu, Eisel-Lemire)
+// than double-conversion. We use them where they give the same results.
+#  define QT_USE_CHARCONV_FOR_DOUBLES
+
+// Moves the digits of the output of std::to_chars in scientific form,
+// "d[.ddd]e[+-]dd", to the front of \a out, without the '.'. Returns the
+// number of digits and sets \a decpt to the position of the decimal point
+// relative to the first digit.
+static int scientificDigits(char *out, const char *end, int &decpt)
+{
+    int length = 0;
+    const char *p = out;
+    for (; *p != 'e'; ++p) {
+        if (*p != '.')
+            out[length++] = *p;
+    }
+    ++p;
+    const bool negativeExponent = *p++ == '-';
+    int exponent = 0;
+    for (; p != end; ++p)
+        exponent = exponent * 10 + (*p - '0');
+    decpt = (negativeExponent ? -exponent : exponent) + 1;
+    return length;
+}
+
+// Produces the same digits as double-conversion's DoubleToAscii() in SHORTEST
+// mode. Its PRECISION and FIXED modes are faster than std::to_chars with a
+// precision, so we don't replace those.
+static bool toCharsShortest(double d, char *buf, int bufSize, bool &sign, int &length, int &decpt)
+{
+    char out[32]; // "d.dddddddddddddddde-308"
+    sign = std::signbit(d);
+    const auto result = std::to_chars(out, out + sizeof out, std::abs(d),
+                                      std::chars_format::scientific);
+    Q_ASSERT(result.ec == std::errc());
+    length = scientificDigits(out, result.ptr, decpt);
+    if (length > bufSize)
+        return false;
+    memcpy(buf, out, length);
+    return true;
+}
+#endif // __cpp_lib_to_chars && !QT_NO_DOUBLECONVERSION && !QT_BOOTSTRAPPED
+
 void qt_doubleToAscii(double d, QLocaleData::DoubleForm form, int precision, char *buf, int bufSize,
                       bool &sign, int &length, int &decpt)
 {
@@ -85,16 +130,23 @@ void qt_doubleToAscii(double d, QLocaleData::DoubleForm form, int precision, cha
     if (form == QLocaleData::DFExponent && precision >= 0)
         ++precision;
 
-    double_conversion::DoubleToStringConverter::DtoaMode mode;
-    if (precision == QLocale::FloatingPointShortest) {
-        mode = double_conversion::DoubleToStringConverter::SHORTEST;
-    } else if (form == QLocaleData::DFSignificantDigits || form == QLocaleData::DFExponent) {
-        mode = double_conversion::DoubleToStringConverter::PRECISION;
-    } else {
-        mode = double_conversion::DoubleToStringConverter::FIXED;
+    bool converted = false;
+#  ifdef QT_USE_CHARCONV_FOR_DOUBLES
+    if (precision == QLocale::FloatingPointShortest)
+        converted = toCharsShortest(d, buf, bufSize, sign, length, decpt);
+#  endif
+    if (!converted) {
+        double_conversion::DoubleToStringConverter::DtoaMode mode;
+        if (precision == QLocale::FloatingPointShortest) {
+            mode = double_conversion::DoubleToStringConverter::SHORTEST;
+        } else if (form == QLocaleData::DFSignificantDigits || form == QLocaleData::DFExponent) {
+            mode = double_conversion::DoubleToStringConverter::PRECISION;
+        } else {
+            mode = double_conversion::DoubleToStringConverter::FIXED;
+        }
+        double_conversion::DoubleToStringConverter::DoubleToAscii(d, mode, precision, buf, bufSize,
+                                                                  &sign, &length, &decpt);
     }
-    double_conversion::DoubleToStringConverter::DoubleToAscii(d, mode, precision, buf, bufSize,
-                                                              &sign, &length, &decpt);
 #else // QT_NO_DOUBLECONVERSION || QT_BOOTSTRAPPED
 
     // Cut the precision at 999, to fit it into the format string. We can't get more than 17
@@ -284,6 +336,22 @@ double qt_asciiToDouble(const char *num, qsizetype numLen, bool &ok, int &proces
     }
 
     double d = 0.0;
+#ifdef QT_USE_CHARCONV_FOR_DOUBLES
+    // std::from_chars neither accepts a '+' sign nor whitespace, but it does
+    // accept "infinity" and "nan(...)", which we don't. We let
+    // double-conversion handle those, as well as zero, overflow and underflow.
+    const char first = numLen > 1 && num[0] == '-' ? num[1] : num[0];
+    if (((first >= '0' && first <= '9') || first == '.')
+            && numLen <= std::numeric_limits<int>::max()) {
+        const char *end = num + numLen;
+        const auto result = std::from_chars(num, end, d);
+        if (result.ec == std::errc() && result.ptr == end && qIsFinite(d) && !isZero(d)) {
+            processed = int(numLen);
+            return d;
+        }
+        d = 0.0;
+    }
+#endif
 #if !defined(QT_NO_DOUBLECONVERSION) && !defined(QT_BOOTSTRAPPED)
     int conv_flags = double_conversion::StringToDoubleConverter::NO_FLAGS;
     if (strayCharMode == TrailingJunkAllowed) {
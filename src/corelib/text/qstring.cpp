@@ -315,6 +315,17 @@ bool qt_ends_with_impl(Haystack haystack, Needle needle, Qt::CaseSensitivity cs)
  * on its own (64-bit glibc on Linux does; 32-bit glibc on Linux returns them
  * 50% of the time), so skipping the alignment prologue is actually optimizing
  * for the common case.
+ *
+ * ** AVX-512 notes: **
+ *
+ * The AVX2 code paths above are only enabled when the whole library is
+ * compiled for AVX2, which is not the case for most distribution builds. The
+ * functions with the _avx256 suffix are instead selected at runtime on
+ * processors with AVX-512BW and AVX-512VL. They only use 256-bit (YMM)
+ * registers: those do not cause the frequency reduction that 512-bit
+ * operations do on some processors, yet give us the AVX-512 masked loads and
+ * stores, which let us process the tail of a string without a scalar loop and
+ * without reading past its end.
  */
 
 #if defined(__mips_dsp)
@@ -324,6 +335,13 @@ extern "C" void qt_fromlatin1_mips_asm_unroll8 (char16_t*, const char*, uint);
 extern "C" void qt_toLatin1_mips_dsp_asm(uchar *dst, const char16_t *src, int length);
 #endif
 
+#if defined(__SSE2__) && QT_COMPILER_SUPPORTS_HERE(AVX512VL) && QT_COMPILER_SUPPORTS_HERE(AVX512BW)
+static inline bool hasFastAvx256()
+{
+    return qCpuHasFeature(ArchSkylakeAvx512);
+}
+#endif
+
 #if defined(__SSE2__) && defined(Q_CC_GNU)
 #  if defined(__SANITIZE_ADDRESS__) && Q_CC_GNU < 800 && !defined(Q_CC_CLANG)
 #     warning "The __attribute__ on below will likely cause a build failure with your GCC version. Your choices are:"
@@ -425,6 +443,33 @@ inline RetType UnrollTailLoop<0>::exec(Number, RetType returnIfExited, Functor1,
 }
 #endif
 
+#if defined(__SSE2__) && QT_COMPILER_SUPPORTS_HERE(AVX512VL) && QT_COMPILER_SUPPORTS_HERE(AVX512BW)
+static QT_FUNCTION_TARGET(ARCH_SKYLAKE_AVX512)
+const char16_t *qustrchr_avx256(const char16_t *n, const char16_t *e, char16_t c) noexcept
+{
+    const __m256i mch = _mm256_set1_epi16(short(c));
+
+    // we're going to read n[0..31] (64 bytes)
+    for ( ; e - n >= 32; n += 32) {
+        __m256i data1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(n));
+        __m256i data2 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(n + 16));
+        uint mask = _mm256_cmpeq_epi16_mask(data1, mch)
+                | (uint(_mm256_cmpeq_epi16_mask(data2, mch)) << 16);
+        if (mask)
+            return n + qCountTrailingZeroBits(mask);
+    }
+
+    // the remaining 0 to 31 characters, using masked loads
+    for ( ; n < e; n += 16) {
+        __mmask16 valid = _bzhi_u32(-1, uint(qMin<qptrdiff>(e - n, 16)));
+        __m256i data = _mm256_maskz_loadu_epi16(valid, n);
+        if (__mmask16 mask = _mm256_mask_cmpeq_epi16_mask(valid, data, mch))
+            return n + qCountTrailingZeroBits(uint(mask));
+    }
+    return e;
+}
+#endif
+
 /*!
  * \internal
  *
@@ -438,6 +483,11 @@ const char16_t *QtPrivate::qustrchr(QStringView str, char16_t c) noexcept
     const char16_t *n = str.utf16();
     const char16_t *e = n + str.size();
 
+#if defined(__SSE2__) && QT_COMPILER_SUPPORTS_HERE(AVX512VL) && QT_COMPILER_SUPPORTS_HERE(AVX512BW)
+    if (hasFastAvx256())
+        return qustrchr_avx256(n, e, c);
+#endif
+
 #ifdef __SSE2__
     bool loops = true;
     // Using the PMOVMSKB instruction, we get two bits for each character
@@ -768,8 +818,37 @@ bool QtPrivate::isValidUtf16(QStringView s) noexcept
 }
 
 // conversion between Latin 1 and UTF-16
+#if defined(__SSE2__) && QT_COMPILER_SUPPORTS_HERE(AVX512VL) && QT_COMPILER_SUPPORTS_HERE(AVX512BW)
+static QT_FUNCTION_TARGET(ARCH_SKYLAKE_AVX512)
+void qt_from_latin1_avx256(char16_t *dst, const char *str, size_t size) noexcept
+{
+    size_t offset = 0;
+
+    // we're going to read str[offset..offset+31] (32 bytes)
+    for ( ; offset + 32 <= size; offset += 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(str + offset));
+        const __m256i first = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(chunk));
+        const __m256i second = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(chunk, 1));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + offset), first);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + offset + 16), second);
+    }
+
+    // the remaining 0 to 31 bytes, using masked loads and stores
+    for ( ; offset < size; offset += 16) {
+        __mmask16 mask = _bzhi_u32(-1, uint(qMin<size_t>(size - offset, 16)));
+        const __m128i chunk = _mm_maskz_loadu_epi8(mask, str + offset);
+        _mm256_mask_storeu_epi16(dst + offset, mask, _mm256_cvtepu8_epi16(chunk));
+    }
+}
+#endif
+
 Q_CORE_EXPORT void qt_from_latin1(char16_t *dst, const char *str, size_t size) noexcept
 {
+#if defined(__SSE2__) && QT_COMPILER_SUPPORTS_HERE(AVX512VL) && QT_COMPILER_SUPPORTS_HERE(AVX512BW)
+    if (hasFastAvx256())
+        return qt_from_latin1_avx256(dst, str, size);
+#endif
+
     /* SIMD:
      * Unpacking with SSE has been shown to improve performance on recent CPUs
      * The same method gives no improvement with NEON. On Aarch64, clang will do the vectorization
@@ -826,9 +905,48 @@ Q_CORE_EXPORT void qt_from_latin1(char16_t *dst, const char *str, size_t size) n
 #endif
 }
 
+#if defined(__SSE2__) && QT_COMPILER_SUPPORTS_HERE(AVX512VL) && QT_COMPILER_SUPPORTS_HERE(AVX512BW)
+template <bool Checked>
+static QT_FUNCTION_TARGET(ARCH_SKYLAKE_AVX512)
+void qt_to_latin1_internal_avx256(uchar *dst, const char16_t *src, qsizetype length)
+{
+    const __m256i questionMark = _mm256_set1_epi16('?');
+    const __m256i maxLatin1 = _mm256_set1_epi16(0xff);
+
+    auto narrow = [=](__m256i chunk) QT_FUNCTION_TARGET(ARCH_SKYLAKE_AVX512) {
+        if (Checked) {
+            __mmask16 offLimitMask = _mm256_cmpgt_epu16_mask(chunk, maxLatin1);
+            chunk = _mm256_mask_mov_epi16(chunk, offLimitMask, questionMark);
+        }
+
+        // pack the two halves to 16 x 8bits elements
+        return _mm_packus_epi16(_mm256_castsi256_si128(chunk), _mm256_extracti128_si256(chunk, 1));
+    };
+
+    qsizetype offset = 0;
+
+    // we're going to write to dst[offset..offset+15] (16 bytes)
+    for ( ; offset + 16 <= length; offset += 16) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + offset));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + offset), narrow(chunk));
+    }
+
+    // the remaining 0 to 15 characters, using masked loads and stores
+    if (offset < length) {
+        __mmask16 mask = _bzhi_u32(-1, uint(length - offset));
+        __m256i chunk = _mm256_maskz_loadu_epi16(mask, src + offset);
+        _mm_mask_storeu_epi8(dst + offset, mask, narrow(chunk));
+    }
+}
+#endif
+
 template <bool Checked>
 static void qt_to_latin1_internal(uchar *dst, const char16_t *src, qsizetype length)
 {
+#if defined(__SSE2__) && QT_COMPILER_SUPPORTS_HERE(AVX512VL) && QT_COMPILER_SUPPORTS_HERE(AVX512BW)
+    if (hasFastAvx256())
+        return qt_to_latin1_internal_avx256<Checked>(dst, src, length);
+#endif
 #if defined(__SSE2__)
     uchar *e = dst + length;
     qptrdiff offset = 0;
@@ -993,6 +1111,50 @@ void qt_to_latin1_unchecked(uchar *dst, const char16_t *src, qsizetype length)
     qt_to_latin1_internal<false>(dst, src, length);
 }
 
+#if defined(__SSE2__) && QT_COMPILER_SUPPORTS_HERE(AVX512VL) && QT_COMPILER_SUPPORTS_HERE(AVX512BW)
+// Returns the length of the common prefix of \a a and \a b (up to \a l) that
+// is US-ASCII in both strings and compares equal case-insensitively. Case
+// folding of US-ASCII characters does not depend on the previous character.
+template <typename Char2>
+static QT_FUNCTION_TARGET(ARCH_SKYLAKE_AVX512)
+qsizetype ucstricmpAsciiPrefix_avx256(const char16_t *a, const Char2 *b, qsizetype l) noexcept
+{
+    const __m256i maxAscii = _mm256_set1_epi16(0x7f);
+    const __m256i upperA = _mm256_set1_epi16('A');
+    const __m256i letterCount = _mm256_set1_epi16('Z' - 'A' + 1);
+    const __m256i caseBit = _mm256_set1_epi16(0x20);
+    auto toLower = [=](__m256i data) QT_FUNCTION_TARGET(ARCH_SKYLAKE_AVX512) {
+        __mmask16 isUpper = _mm256_cmplt_epu16_mask(_mm256_sub_epi16(data, upperA), letterCount);
+        return _mm256_mask_add_epi16(data, isUpper, data, caseBit);
+    };
+
+    // returns a bit set for each character that is either non-ASCII or different
+    auto stopMask = [=](qsizetype i, __mmask16 valid) QT_FUNCTION_TARGET(ARCH_SKYLAKE_AVX512) {
+        __m256i data1 = _mm256_maskz_loadu_epi16(valid, a + i);
+        __m256i data2;
+        if constexpr (sizeof(Char2) == 1)
+            data2 = _mm256_cvtepu8_epi16(_mm_maskz_loadu_epi8(valid, b + i));
+        else
+            data2 = _mm256_maskz_loadu_epi16(valid, b + i);
+        return uint(_mm256_cmpgt_epu16_mask(_mm256_or_si256(data1, data2), maxAscii)
+                    | _mm256_cmpneq_epi16_mask(toLower(data1), toLower(data2)));
+    };
+
+    qsizetype i = 0;
+    for ( ; l - i >= 16; i += 16) {
+        if (uint stop = stopMask(i, __mmask16(-1)))
+            return i + qCountTrailingZeroBits(stop);
+    }
+
+    // the remaining 0 to 15 characters
+    if (i < l) {
+        if (uint stop = stopMask(i, _bzhi_u32(-1, uint(l - i))))
+            return i + qCountTrailingZeroBits(stop);
+    }
+    return l;
+}
+#endif
+
 // Unicode case-insensitive comparison (argument order matches QStringView)
 Q_NEVER_INLINE static int ucstricmp(qsizetype alen, const char16_t *a, qsizetype blen, const char16_t *b)
 {
@@ -1003,7 +1165,20 @@ Q_NEVER_INLINE static int ucstricmp(qsizetype alen, const char16_t *a, qsizetype
     char32_t blast = 0;
     qsizetype l = qMin(alen, blen);
     qsizetype i;
+#if defined(__SSE2__) && QT_COMPILER_SUPPORTS_HERE(AVX512VL) && QT_COMPILER_SUPPORTS_HERE(AVX512BW)
+    const bool asciiFastPath = hasFastAvx256();
+#endif
     for (i = 0; i < l; ++i) {
+#if defined(__SSE2__) && QT_COMPILER_SUPPORTS_HERE(AVX512VL) && QT_COMPILER_SUPPORTS_HERE(AVX512BW)
+        if (asciiFastPath && (a[i] | b[i]) < 0x80) {
+            i += ucstricmpAsciiPrefix_avx256(a + i, b + i, l - i);
+            if (i == l)
+                break;
+
+            // the skipped characters were not surrogates
+            alast = blast = 0;
+        }
+#endif
 //         qDebug() << Qt::hex << alast << blast;
 //         qDebug() << Qt::hex << "*a=" << *a << "alast=" << alast << "folded=" << foldCase (*a, alast);
 //         qDebug() << Qt::hex << "*b=" << *b << "blast=" << blast << "folded=" << foldCase (*b, blast);
@@ -1025,7 +1200,17 @@ Q_NEVER_INLINE static int ucstricmp(qsizetype alen, const char16_t *a, qsizetype
 {
     qsizetype l = qMin(alen, blen);
     qsizetype i;
+#if defined(__SSE2__) && QT_COMPILER_SUPPORTS_HERE(AVX512VL) && QT_COMPILER_SUPPORTS_HERE(AVX512BW)
+    const bool asciiFastPath = hasFastAvx256();
+#endif
     for (i = 0; i < l; ++i) {
+#if defined(__SSE2__) && QT_COMPILER_SUPPORTS_HERE(AVX512VL) && QT_COMPILER_SUPPORTS_HERE(AVX512BW)
+        if (asciiFastPath && (a[i] | uchar(b[i])) < 0x80) {
+            i += ucstricmpAsciiPrefix_avx256(a + i, b + i, l - i);
+            if (i == l)
+                break;
+        }
+#endif
         int diff = foldCase(a[i]) - foldCase(char16_t{uchar(b[i])});
         if ((diff))
             return diff;
@@ -1074,11 +1259,50 @@ extern "C" int qt_ucstrncmp_mips_dsp_asm(const char16_t *a,
                                          unsigned len);
 #endif
 
+#if defined(__SSE2__) && QT_COMPILER_SUPPORTS_HERE(AVX512VL) && QT_COMPILER_SUPPORTS_HERE(AVX512BW)
+static QT_FUNCTION_TARGET(ARCH_SKYLAKE_AVX512)
+int ucstrncmp_avx256(const char16_t *a, const char16_t *b, size_t l) noexcept
+{
+    size_t offset = 0;
+    auto difference = [=](size_t offset, uint mask) {
+        // found a different character
+        uint idx = qCountTrailingZeroBits(mask);
+        return a[offset + idx] - b[offset + idx];
+    };
+
+    // we're going to read a[0..31] and b[0..31] (128 bytes)
+    for ( ; offset + 32 <= l; offset += 32) {
+        __m256i a_data1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + offset));
+        __m256i a_data2 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + offset + 16));
+        __m256i b_data1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + offset));
+        __m256i b_data2 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + offset + 16));
+        uint mask = _mm256_cmpneq_epi16_mask(a_data1, b_data1)
+                | (uint(_mm256_cmpneq_epi16_mask(a_data2, b_data2)) << 16);
+        if (mask)
+            return difference(offset, mask);
+    }
+
+    // the remaining 0 to 31 characters, using masked loads
+    for ( ; offset < l; offset += 16) {
+        __mmask16 valid = _bzhi_u32(-1, uint(qMin<size_t>(l - offset, 16)));
+        __m256i a_data = _mm256_maskz_loadu_epi16(valid, a + offset);
+        __m256i b_data = _mm256_maskz_loadu_epi16(valid, b + offset);
+        if (__mmask16 mask = _mm256_cmpneq_epi16_mask(a_data, b_data))
+            return difference(offset, mask);
+    }
+    return 0;
+}
+#endif
+
 // Unicode case-sensitive compare two same-sized strings
 template <StringComparisonMode Mode>
 static int ucstrncmp(const char16_t *a, const char16_t *b, size_t l)
 {
 #ifndef __OPTIMIZE_SIZE__
+#  if defined(__SSE2__) && QT_COMPILER_SUPPORTS_HERE(AVX512VL) && QT_COMPILER_SUPPORTS_HERE(AVX512BW)
+    if (hasFastAvx256())
+        return ucstrncmp_avx256(a, b, l);
+#  endif
 #  if defined(__mips_dsp)
     static_assert(sizeof(uint) == sizeof(size_t));
     if (l >= 8) {
@@ -929,7 +929,11 @@ public:
     static QString number(double, char format='g', int precision=6);
 
     friend bool operator==(const QString &s1, const QString &s2) noexcept
-    { return (s1.size() == s2.size()) && QtPrivate::compareStrings(s1, s2, Qt::CaseSensitive) == 0; }
+    {
+        return (s1.size() == s2.size())
+                && (s1.constData() == s2.constData() // shared, e.g. by QStringPool
+                    || QtPrivate::compareStrings(s1, s2, Qt::CaseSensitive) == 0);
+    }
     friend bool operator< (const QString &s1, const QString &s2) noexcept
     { return QtPrivate::compareStrings(s1, s2, Qt::CaseSensitive) < 0; }
     friend bool operator> (const QString &s1, const QString &s2) noexcept { return s2 < s1; }
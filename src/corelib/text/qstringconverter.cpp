@@ -51,8 +51,149 @@ static Q_ALWAYS_INLINE uint qBitScanReverse(unsigned v) noexcept
 #endif
 
 #if defined(__SSE2__) && defined(QT_COMPILER_SUPPORTS_SSE2)
+#  if QT_COMPILER_SUPPORTS_HERE(AVX512VL) && QT_COMPILER_SUPPORTS_HERE(AVX512BW)
+// The functions below use the AVX-512 masked loads and stores on 256-bit
+// registers (see the notes in qstring.cpp) so they can process the tail of
+// the input too, without reading or writing past its end.
+static inline bool hasFastAvx256()
+{
+    return qCpuHasFeature(ArchSkylakeAvx512);
+}
+
+static QT_FUNCTION_TARGET(ARCH_SKYLAKE_AVX512)
+bool simdEncodeAscii_avx256(uchar *&dstRef, const char16_t *&nextAscii, const char16_t *&srcRef, const char16_t *end)
+{
+    // work on copies: the stores to dst could otherwise alias the pointers
+    uchar *dst = dstRef;
+    const char16_t *src = srcRef;
+
+    const __m256i maxAscii = _mm256_set1_epi16(0x7f);
+    auto pack = [](__m256i data) QT_FUNCTION_TARGET(ARCH_SKYLAKE_AVX512) {
+        return _mm_packus_epi16(_mm256_castsi256_si128(data), _mm256_extracti128_si256(data, 1));
+    };
+    auto stopAtNonAscii = [&](uint nonAscii) {
+        // find the next probable ASCII character
+        nextAscii = src + qBitScanReverse(nonAscii) + 1;
+
+        uint n = qCountTrailingZeroBits(nonAscii);
+        dstRef = dst + n;
+        srcRef = src + n;
+        return false;
+    };
+
+    // do sixteen characters at a time
+    for ( ; end - src >= 16; src += 16, dst += 16) {
+        __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+        __mmask16 nonAscii = _mm256_cmpgt_epu16_mask(data, maxAscii);
+
+        // store, even if there are non-ASCII characters here
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), pack(data));
+        if (nonAscii)
+            return stopAtNonAscii(nonAscii);
+    }
+
+    // the remaining 0 to 15 characters, using masked loads and stores
+    if (src != end) {
+        __mmask16 valid = _bzhi_u32(-1, uint(end - src));
+        __m256i data = _mm256_maskz_loadu_epi16(valid, src);
+        __mmask16 nonAscii = _mm256_cmpgt_epu16_mask(data, maxAscii);
+        _mm_mask_storeu_epi8(dst, valid, pack(data));
+        if (nonAscii)
+            return stopAtNonAscii(nonAscii);
+        dst += end - src;
+    }
+    dstRef = dst;
+    srcRef = end;
+    return true;
+}
+
+static QT_FUNCTION_TARGET(ARCH_SKYLAKE_AVX512)
+bool simdDecodeAscii_avx256(char16_t *&dstRef, const uchar *&nextAscii, const uchar *&srcRef, const uchar *end)
+{
+    // work on copies: the stores to dst could otherwise alias the pointers
+    char16_t *dst = dstRef;
+    const uchar *src = srcRef;
+
+    auto store = [&](__m256i data, __mmask32 mask) QT_FUNCTION_TARGET(ARCH_SKYLAKE_AVX512) {
+        __m256i first = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(data));
+        __m256i second = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(data, 1));
+        _mm256_mask_storeu_epi16(dst, __mmask16(mask), first);
+        _mm256_mask_storeu_epi16(dst + 16, __mmask16(mask >> 16), second);
+    };
+    auto stopAtNonAscii = [&](__m256i data, uint nonAscii) QT_FUNCTION_TARGET(ARCH_SKYLAKE_AVX512) {
+        // copy the front part that is still ASCII
+        uint n = qCountTrailingZeroBits(nonAscii);
+        store(data, _bzhi_u32(-1, n));
+
+        // find the next probable ASCII character
+        nextAscii = src + qBitScanReverse(nonAscii) + 1;
+        dstRef = dst + n;
+        srcRef = src + n;
+        return false;
+    };
+
+    // do thirty-two characters at a time
+    for ( ; end - src >= 32; src += 32, dst += 32) {
+        __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+        if (uint nonAscii = _mm256_movepi8_mask(data))
+            return stopAtNonAscii(data, nonAscii);
+
+        __m256i first = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(data));
+        __m256i second = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(data, 1));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), first);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 16), second);
+    }
+
+    // the remaining 0 to 31 characters, using masked loads and stores
+    if (src != end) {
+        __mmask32 valid = _bzhi_u32(-1, uint(end - src));
+        __m256i data = _mm256_maskz_loadu_epi8(valid, src);
+        if (uint nonAscii = _mm256_movepi8_mask(data))
+            return stopAtNonAscii(data, nonAscii);
+        store(data, valid);
+        dst += end - src;
+    }
+    dstRef = dst;
+    srcRef = end;
+    return true;
+}
+
+static QT_FUNCTION_TARGET(ARCH_SKYLAKE_AVX512)
+const uchar *simdFindNonAscii_avx256(const uchar *src, const uchar *end, const uchar *&nextAscii)
+{
+    auto stopAtNonAscii = [&](uint nonAscii) {
+        // find the next probable ASCII character
+        nextAscii = src + qBitScanReverse(nonAscii) + 1;
+
+        // return the non-ASCII character
+        return src + qCountTrailingZeroBits(nonAscii);
+    };
+
+    // do thirty-two characters at a time
+    for ( ; end - src >= 32; src += 32) {
+        __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+        if (uint nonAscii = _mm256_movepi8_mask(data))
+            return stopAtNonAscii(nonAscii);
+    }
+
+    // the remaining 0 to 31 characters, using a masked load
+    if (src != end) {
+        __m256i data = _mm256_maskz_loadu_epi8(_bzhi_u32(-1, uint(end - src)), src);
+        if (uint nonAscii = _mm256_movepi8_mask(data))
+            return stopAtNonAscii(nonAscii);
+    }
+    nextAscii = end;
+    return end;
+}
+#  endif
+
 static inline bool simdEncodeAscii(uchar *&dst, const char16_t *&nextAscii, const char16_t *&src, const char16_t *end)
 {
+#  if QT_COMPILER_SUPPORTS_HERE(AVX512VL) && QT_COMPILER_SUPPORTS_HERE(AVX512BW)
+    if (hasFastAvx256())
+        return simdEncodeAscii_avx256(dst, nextAscii, src, end);
+#  endif
+
     // do sixteen characters at a time
     for ( ; end - src >= 16; src += 16, dst += 16) {
 #  ifdef __AVX2__
@@ -117,6 +258,11 @@ static inline bool simdEncodeAscii(uchar *&dst, const char16_t *&nextAscii, cons
 
 static inline bool simdDecodeAscii(char16_t *&dst, const uchar *&nextAscii, const uchar *&src, const uchar *end)
 {
+#  if QT_COMPILER_SUPPORTS_HERE(AVX512VL) && QT_COMPILER_SUPPORTS_HERE(AVX512BW)
+    if (hasFastAvx256())
+        return simdDecodeAscii_avx256(dst, nextAscii, src, end);
+#  endif
+
     // do sixteen characters at a time
     for ( ; end - src >= 16; src += 16, dst += 16) {
         __m128i data = _mm_loadu_si128((const __m128i*)src);
@@ -184,6 +330,11 @@ static inline bool simdDecodeAscii(char16_t *&dst, const uchar *&nextAscii, cons
 
 static inline const uchar *simdFindNonAscii(const uchar *src, const uchar *end, const uchar *&nextAscii)
 {
+#  if QT_COMPILER_SUPPORTS_HERE(AVX512VL) && QT_COMPILER_SUPPORTS_HERE(AVX512BW)
+    if (hasFastAvx256())
+        return simdFindNonAscii_avx256(src, end, nextAscii);
+#  endif
+
 #ifdef __AVX2__
     // do 32 characters at a time
     // (this is similar to simdTestMask in qstring.cpp)
@@ -455,6 +606,379 @@ static void simdCompareAscii(const char8_t *&, const char8_t *, const char16_t *
 }
 #endif
 
+#if defined(__SSE2__) && QT_COMPILER_SUPPORTS_HERE(SSE4_1)
+/*
+ * Validation and decoding of UTF-8 that is not US-ASCII.
+ *
+ * The validation is the algorithm from John Keiser and Daniel Lemire,
+ * "Validating UTF-8 In Less Than One Instruction Per Byte" (2021): three
+ * lookups indexed by the nibbles of each pair of consecutive bytes classify
+ * every error that can be detected with two bytes, and a saturating
+ * subtraction finds the third and fourth bytes of the longer sequences.
+ *
+ * The decoding follows Lemire and Keiser's simdutf: a 12-bit mask of the
+ * bytes that end a code point selects a shuffle that gathers six code points
+ * of one or two bytes, or four code points of up to three bytes, into 16- or
+ * 32-bit lanes, where they are assembled with shifts and masks.
+ *
+ * Both work on blocks of 64 bytes. Any block that is not entirely valid is
+ * left to the scalar code, so the error handling is the same as before.
+ */
+namespace {
+struct Utf8ShuffleTables
+{
+    enum {
+        SixCodePoints = 0,          // 64 shuffles for six code points of 1 or 2 bytes
+        FourCodePoints = 64,        // 81 shuffles for four code points of 1 to 3 bytes
+        ShuffleCount = 64 + 81,
+        Scalar = 255                // anything else
+    };
+
+    // indexed by the mask of the bytes that end a code point in the next 12 bytes
+    struct Pattern {
+        uchar shuffle;
+        uchar consumed;
+    } patterns[1 << 12];
+    uchar shuffles[ShuffleCount][16];
+};
+} // unnamed namespace
+
+static constexpr Utf8ShuffleTables makeUtf8ShuffleTables()
+{
+    Utf8ShuffleTables t = {};
+
+    // six 16-bit lanes: { second byte, first byte } or { byte, zero }
+    for (int index = 0; index < 64; ++index) {
+        int start = 0;
+        for (int i = 0; i < 16; ++i)
+            t.shuffles[index][i] = 0x80;
+        for (int k = 0; k < 6; ++k) {
+            const bool twoBytes = index & (1 << k);
+            t.shuffles[index][2 * k] = uchar(twoBytes ? start + 1 : start);
+            t.shuffles[index][2 * k + 1] = twoBytes ? uchar(start) : 0x80;
+            start += twoBytes ? 2 : 1;
+        }
+    }
+
+    // four 32-bit lanes: the bytes of the code point in reverse order
+    for (int index = 0; index < 81; ++index) {
+        int start = 0;
+        int lengths = index;
+        uchar *shuffle = t.shuffles[Utf8ShuffleTables::FourCodePoints + index];
+        for (int k = 0; k < 4; ++k) {
+            const int length = lengths % 3 + 1;
+            lengths /= 3;
+            for (int i = 0; i < 4; ++i)
+                shuffle[4 * k + i] = i < length ? uchar(start + length - 1 - i) : 0x80;
+            start += length;
+        }
+    }
+
+    for (int mask = 0; mask < (1 << 12); ++mask) {
+        int lengths[12] = {};
+        int count = 0;
+        int start = 0;
+        for (int i = 0; i < 12; ++i) {
+            if (mask & (1 << i)) {
+                lengths[count++] = i - start + 1;
+                start = i + 1;
+            }
+        }
+
+        auto longest = [&](int n) {
+            int result = 0;
+            for (int k = 0; k < n; ++k)
+                result = lengths[k] > result ? lengths[k] : result;
+            return result;
+        };
+
+        Utf8ShuffleTables::Pattern &pattern = t.patterns[mask];
+        pattern.shuffle = Utf8ShuffleTables::Scalar;
+        if (count >= 6 && longest(6) <= 2) {
+            int index = 0;
+            int consumed = 0;
+            for (int k = 0; k < 6; ++k) {
+                index |= (lengths[k] - 1) << k;
+                consumed += lengths[k];
+            }
+            pattern = { uchar(Utf8ShuffleTables::SixCodePoints + index), uchar(consumed) };
+        } else if (count >= 4 && longest(4) <= 3) {
+            int index = 0;
+            int consumed = 0;
+            for (int k = 3; k >= 0; --k) {
+                index = index * 3 + lengths[k] - 1;
+                consumed += lengths[k];
+            }
+            pattern = { uchar(Utf8ShuffleTables::FourCodePoints + index), uchar(consumed) };
+        }
+    }
+    return t;
+}
+
+static constexpr Utf8ShuffleTables utf8ShuffleTables = makeUtf8ShuffleTables();
+
+// Returns non-zero bytes where the 16 bytes of \a input, preceded by the 16
+// bytes of \a previous, are not valid UTF-8. Sequences that are incomplete
+// at the end of \a input are not errors.
+static QT_FUNCTION_TARGET(SSE4_1)
+__m128i utf8Errors(__m128i input, __m128i previous)
+{
+    // the error classes found with two bytes
+    enum : uchar {
+        TooShort = 1 << 0,          // 11______ followed by 0_______ or 11______
+        TooLong = 1 << 1,           // 0_______ followed by 10______
+        Overlong3 = 1 << 2,         // 11100000 100_____
+        TooLarge = 1 << 3,          // 11110100 1001____ and 11110100 101_____
+        Surrogate = 1 << 4,         // 11101101 101_____
+        Overlong2 = 1 << 5,         // 1100000_ 10______
+        TooLarge1000 = 1 << 6,      // 11110101 1000____ and higher
+        Overlong4 = 1 << 6,         // 11110000 1000____
+        TwoConts = 1 << 7,          // 10______ 10______
+        Carry = TooShort | TooLong | TwoConts
+    };
+    const __m128i byte1HighTable = _mm_setr_epi8(
+            // 0_______: US-ASCII
+            TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong,
+            // 10______: continuation
+            TwoConts, TwoConts, TwoConts, TwoConts,
+            // 1100____ and 1101____: two-byte sequences
+            TooShort | Overlong2, TooShort,
+            // 1110____: three-byte sequences
+            TooShort | Overlong3 | Surrogate,
+            // 1111____: four-byte sequences
+            char(TooShort | TooLarge | TooLarge1000 | Overlong4));
+    const __m128i byte1LowTable = _mm_setr_epi8(
+            char(Carry | Overlong3 | Overlong2 | Overlong4),    // ____0000
+            char(Carry | Overlong2),                            // ____0001
+            char(Carry), char(Carry),                           // ____001_
+            char(Carry | TooLarge),                             // ____0100
+            char(Carry | TooLarge | TooLarge1000),              // ____0101
+            char(Carry | TooLarge | TooLarge1000),
+            char(Carry | TooLarge | TooLarge1000),
+            char(Carry | TooLarge | TooLarge1000),
+            char(Carry | TooLarge | TooLarge1000),
+            char(Carry | TooLarge | TooLarge1000),
+            char(Carry | TooLarge | TooLarge1000),
+            char(Carry | TooLarge | TooLarge1000),
+            char(Carry | TooLarge | TooLarge1000 | Surrogate),  // ____1101
+            char(Carry | TooLarge | TooLarge1000),
+            char(Carry | TooLarge | TooLarge1000));
+    const __m128i byte2HighTable = _mm_setr_epi8(
+            // 0_______: US-ASCII
+            TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort,
+            // 1000____, 1001____, 101_____: continuation
+            char(TooLong | Overlong2 | TwoConts | Overlong3 | TooLarge1000 | Overlong4),
+            char(TooLong | Overlong2 | TwoConts | Overlong3 | TooLarge),
+            char(TooLong | Overlong2 | TwoConts | Surrogate | TooLarge),
+            char(TooLong | Overlong2 | TwoConts | Surrogate | TooLarge),
+            // 11______: start of a sequence
+            TooShort, TooShort, TooShort, TooShort);
+
+    const __m128i nibbleMask = _mm_set1_epi8(0x0f);
+    const __m128i previous1 = _mm_alignr_epi8(input, previous, 15);
+    const __m128i byte1High = _mm_shuffle_epi8(byte1HighTable,
+                                               _mm_and_si128(_mm_srli_epi16(previous1, 4), nibbleMask));
+    const __m128i byte1Low = _mm_shuffle_epi8(byte1LowTable, _mm_and_si128(previous1, nibbleMask));
+    const __m128i byte2High = _mm_shuffle_epi8(byte2HighTable,
+                                               _mm_and_si128(_mm_srli_epi16(input, 4), nibbleMask));
+    const __m128i specialCases = _mm_and_si128(_mm_and_si128(byte1High, byte1Low), byte2High);
+
+    // the third and fourth bytes of a sequence must be continuation bytes:
+    // TwoConts must be set exactly for those
+    const __m128i previous2 = _mm_alignr_epi8(input, previous, 14);
+    const __m128i previous3 = _mm_alignr_epi8(input, previous, 13);
+    const __m128i isThirdByte = _mm_subs_epu8(previous2, _mm_set1_epi8(char(0xe0 - 0x80)));
+    const __m128i isFourthByte = _mm_subs_epu8(previous3, _mm_set1_epi8(char(0xf0 - 0x80)));
+    const __m128i must23 = _mm_and_si128(_mm_or_si128(isThirdByte, isFourthByte),
+                                         _mm_set1_epi8(char(TwoConts)));
+    return _mm_xor_si128(must23, specialCases);
+}
+
+// Returns true if the 64 bytes in \a block are valid UTF-8, assuming they
+// start with a code point. The last sequence may be incomplete.
+static QT_FUNCTION_TARGET(SSE4_1)
+bool utf8BlockIsValid(const __m128i (&block)[4])
+{
+    __m128i errors = utf8Errors(block[0], _mm_setzero_si128());
+    errors = _mm_or_si128(errors, utf8Errors(block[1], block[0]));
+    errors = _mm_or_si128(errors, utf8Errors(block[2], block[1]));
+    errors = _mm_or_si128(errors, utf8Errors(block[3], block[2]));
+    return _mm_testz_si128(errors, errors);
+}
+
+static QT_FUNCTION_TARGET(SSE4_1)
+void simdDecodeUtf8_sse4(char16_t *&dstRef, const uchar *&nextAscii, const uchar *&srcRef, const uchar *end)
+{
+    // work on copies: the stores to dst could otherwise alias the pointers
+    char16_t *dst = dstRef;
+    const uchar *src = srcRef;
+
+    // We need to know whether the byte after each code point is a continuation
+    // byte, so only the first 63 bytes of each block are decoded, and the
+    // 16-byte load for the last of them reads past the block. The stores below
+    // write at most 16 characters past the code points that they decode, and
+    // there are always more bytes left than that, so they can't overflow the
+    // output buffer.
+    constexpr qptrdiff BlockSize = 64;
+    constexpr qptrdiff LastWindow = BlockSize - 1 - 12;
+    constexpr qptrdiff MinimumSize = LastWindow + 16;
+
+    // simdDecodeAscii() found the last non-US-ASCII character in the chunk it
+    // was looking at: if it is close, this is probably a single word in a
+    // mostly US-ASCII text
+    if (nextAscii - src < 16)
+        return;
+
+    while (end - src >= MinimumSize) {
+        __m128i block[4];
+        for (int i = 0; i < 4; ++i)
+            block[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src) + i);
+
+        quint64 nonAscii = 0;
+        for (int i = 0; i < 4; ++i)
+            nonAscii |= quint64(uint(_mm_movemask_epi8(block[i]))) << (16 * i);
+        if (qPopulationCount(nonAscii) < BlockSize / 4) {
+            // mostly US-ASCII: simdDecodeAscii() and the scalar code are faster
+            break;
+        }
+
+        if (!utf8BlockIsValid(block)) {
+            // let the scalar code deal with the errors in this block
+            nextAscii = src + BlockSize;
+            break;
+        }
+
+        // bit N is set if byte N ends a code point (valid for N < 63)
+        const __m128i minLeadByte = _mm_set1_epi8(char(0xc0));
+        quint64 continuations = 0;
+        for (int i = 0; i < 4; ++i) {
+            // continuation bytes are 0x80 to 0xbf, the only ones less than 0xc0 when signed
+            const int mask = _mm_movemask_epi8(_mm_cmplt_epi8(block[i], minLeadByte));
+            continuations |= quint64(uint(mask)) << (16 * i);
+        }
+        const quint64 ends = ~continuations >> 1;
+        nonAscii |= quint64(1) << (BlockSize - 1);
+
+        qptrdiff pos = 0;
+        while (pos <= LastWindow) {
+            const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + pos));
+            const quint64 nonAsciiHere = nonAscii >> pos;
+            if ((nonAsciiHere & 0xf) == 0) {
+                // at least four US-ASCII characters (the bit for byte 63 is
+                // set, so this stops before it)
+                const uint count = qCountTrailingZeroBits(nonAsciiHere | 0x10000);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_unpacklo_epi8(input, _mm_setzero_si128()));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst) + 1, _mm_unpackhi_epi8(input, _mm_setzero_si128()));
+                dst += count;
+                pos += count;
+                continue;
+            }
+
+            const Utf8ShuffleTables::Pattern pattern = utf8ShuffleTables.patterns[(ends >> pos) & 0xfff];
+            if (pattern.shuffle < Utf8ShuffleTables::FourCodePoints) {
+                // 110yyyyy 10xxxxxx -> 00000yyy yyxxxxxx
+                const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(utf8ShuffleTables.shuffles[pattern.shuffle]));
+                const __m128i lanes = _mm_shuffle_epi8(input, shuffle);
+                const __m128i low = _mm_and_si128(lanes, _mm_set1_epi16(0x7f));
+                const __m128i high = _mm_and_si128(lanes, _mm_set1_epi16(0x1f00));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_or_si128(low, _mm_srli_epi16(high, 2)));
+                dst += 6;
+                pos += pattern.consumed;
+            } else if (pattern.shuffle != Utf8ShuffleTables::Scalar) {
+                // 1110zzzz 10yyyyyy 10xxxxxx -> zzzzyyyy yyxxxxxx
+                const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(utf8ShuffleTables.shuffles[pattern.shuffle]));
+                const __m128i lanes = _mm_shuffle_epi8(input, shuffle);
+                const __m128i low = _mm_and_si128(lanes, _mm_set1_epi32(0x7f));
+                const __m128i middle = _mm_and_si128(lanes, _mm_set1_epi32(0x3f00));
+                const __m128i high = _mm_and_si128(lanes, _mm_set1_epi32(0x0f0000));
+                const __m128i utf32 = _mm_or_si128(_mm_or_si128(low, _mm_srli_epi32(middle, 2)),
+                                                   _mm_srli_epi32(high, 4));
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(dst), _mm_packus_epi32(utf32, utf32));
+                dst += 4;
+                pos += pattern.consumed;
+            } else {
+                // a four-byte sequence: already validated, decode it one at a time
+                const uchar *next = src + pos;
+                uchar b = *next++;
+                QUtf8Functions::fromUtf8<QUtf8BaseTraits>(b, dst, next, end);
+                pos = next - src;
+            }
+        }
+        src += pos;
+    }
+
+    if (end - src < MinimumSize)
+        nextAscii = end;
+    dstRef = dst;
+    srcRef = src;
+}
+
+// Returns false if the UTF-8 in [src, end) is invalid. Otherwise, returns
+// true and updates \a src to the start of the first code point that has not
+// been validated.
+static QT_FUNCTION_TARGET(SSE4_1)
+bool simdValidateUtf8_sse4(const uchar *&src, const uchar *end)
+{
+    constexpr qptrdiff BlockSize = 64;
+    if (end - src <= BlockSize)
+        return true;
+
+    // non-zero if the last bytes start a sequence longer than what's left
+    const __m128i incomplete = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                             char(0xf0 - 1), char(0xe0 - 1), char(0xc0 - 1));
+    __m128i previous = _mm_setzero_si128();
+    __m128i errors = _mm_setzero_si128();
+    for ( ; end - src > BlockSize; src += BlockSize) {
+        __m128i block[4];
+        for (int i = 0; i < 4; ++i)
+            block[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src) + i);
+
+        const __m128i highBits = _mm_or_si128(_mm_or_si128(block[0], block[1]),
+                                              _mm_or_si128(block[2], block[3]));
+        if (_mm_movemask_epi8(highBits) == 0) {
+            // US-ASCII: only the end of the previous block needs checking
+            errors = _mm_or_si128(errors, _mm_subs_epu8(previous, incomplete));
+        } else {
+            errors = _mm_or_si128(errors, utf8Errors(block[0], previous));
+            errors = _mm_or_si128(errors, utf8Errors(block[1], block[0]));
+            errors = _mm_or_si128(errors, utf8Errors(block[2], block[1]));
+            errors = _mm_or_si128(errors, utf8Errors(block[3], block[2]));
+        }
+        if (!_mm_testz_si128(errors, errors))
+            return false;
+        previous = block[3];
+    }
+
+    // the last sequence may be incomplete or followed by an error that we
+    // haven't seen yet: back up to its first byte
+    const uchar *last = src - 1;
+    while (QUtf8Functions::isContinuationByte(*last))
+        --last;
+    src = *last < 0x80 ? last + 1 : last;
+    return true;
+}
+
+static inline void simdDecodeUtf8(char16_t *&dst, const uchar *&nextAscii, const uchar *&src, const uchar *end)
+{
+    if (qCpuHasFeature(SSE4_1))
+        simdDecodeUtf8_sse4(dst, nextAscii, src, end);
+}
+
+static inline bool simdValidateUtf8(const uchar *&src, const uchar *end)
+{
+    return qCpuHasFeature(SSE4_1) ? simdValidateUtf8_sse4(src, end) : true;
+}
+#else
+static inline void simdDecodeUtf8(char16_t *&, const uchar *&, const uchar *&, const uchar *)
+{
+}
+
+static inline bool simdValidateUtf8(const uchar *&, const uchar *)
+{
+    return true;
+}
+#endif
+
 enum { HeaderDone = 1 };
 
 QByteArray QUtf8::convertFromUnicode(QStringView in)
@@ -625,6 +1149,7 @@ QChar *QUtf8::convertToUnicode(QChar *buffer, QByteArrayView in) noexcept
             nextAscii = end;
             if (simdDecodeAscii(dst, nextAscii, src, end))
                 break;
+            simdDecodeUtf8(dst, nextAscii, src, end);
 
             do {
                 uchar b = *src++;
@@ -727,8 +1252,11 @@ QChar *QUtf8::convertToUnicode(QChar *out, QByteArrayView in, QStringConverter::
     res = 0;
     const uchar *nextAscii = src;
     while (res >= 0 && src < end) {
-        if (src >= nextAscii && simdDecodeAscii(dst, nextAscii, src, end))
-            break;
+        if (src >= nextAscii) {
+            if (simdDecodeAscii(dst, nextAscii, src, end))
+                break;
+            simdDecodeUtf8(dst, nextAscii, src, end);
+        }
 
         ch = *src++;
         res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(ch, dst, src, end);
@@ -780,6 +1308,11 @@ QUtf8::ValidUtf8Result QUtf8::isValidUtf8(QByteArrayView in)
             src = simdFindNonAscii(src, end, nextAscii);
         if (src == end)
             break;
+        if (*src & 0x80) {
+            isValidAscii = false;
+            if (!simdValidateUtf8(src, end))
+                return { false, false };
+        }
 
         do {
             uchar b = *src++;
@@ -0,0 +1,231 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qstringpool.h"
+
+#include <QtCore/qconcurrenthash.h>
+
+QT_BEGIN_NAMESPACE
+
+class QStringPoolPrivate
+{
+public:
+    // the keys and values are the same data: the value is what intern() returns
+    QConcurrentHash<QString, QString> strings;
+    QConcurrentHash<QByteArray, QByteArray> byteArrays;
+};
+
+Q_GLOBAL_STATIC(QStringPool, globalStringPool)
+
+static QString rawString(QStringView str)
+{
+    return QString::fromRawData(reinterpret_cast<const QChar *>(str.data()), str.size());
+}
+
+static QByteArray rawByteArray(QByteArrayView data)
+{
+    return QByteArray::fromRawData(data.data(), data.size());
+}
+
+// Returns the pooled copy of \a key, inserting \a copy() if there is none.
+// \a key may refer to data that the pool must not keep.
+template <typename String, typename Copy>
+static String internImpl(QConcurrentHash<String, String> &pool, const String &key, Copy copy)
+{
+    String pooled = pool.value(key);
+    if (!pooled.isNull())
+        return pooled;
+
+    pooled = copy();
+    if (pool.tryInsert(pooled, pooled))
+        return pooled;
+
+    // another thread inserted it first; unless clear() removed it since
+    const String other = pool.value(pooled);
+    return other.isNull() ? pooled : other;
+}
+
+// Returns true if the pool may keep a reference to the data of the non-empty
+// \a str instead of copying it: the data must be allocated, so it isn't raw
+// data that the caller may free, and have no capacity that would be wasted.
+// Raw data has no capacity at all.
+template <typename String>
+static bool canShare(const String &str)
+{
+    return str.capacity() == str.size();
+}
+
+/*!
+    \class QStringPool
+    \inmodule QtCore
+    \brief The QStringPool class stores a single copy of each distinct string
+    that it is given.
+    \since 6.5
+
+    \ingroup tools
+    \ingroup string-processing
+
+    \threadsafe
+
+    Applications often hold many copies of the same few strings, such as the
+    field names of JSON documents, the keys of QVariantMaps, property names
+    and MIME types. Each copy is allocated separately, even though QString and
+    QByteArray are \l{implicitly shared}, because the copies are created
+    independently of each other, for instance by a parser.
+
+    QStringPool \e interns strings: intern() returns a QString or QByteArray
+    that shares its data with all the other strings with the same contents
+    that were interned in the same pool. The copies that the caller no longer
+    needs can then be freed, so that only one allocation remains for each
+    distinct string.
+
+    \snippet code/src_corelib_text_qstringpool.cpp 0
+
+    Strings that share their data compare equal without comparing their
+    contents, which makes lookups of interned keys in QHash and QMap faster.
+    Hashing them still reads the contents.
+
+    The pool itself holds a reference to each string until clear() is called
+    or the pool is destroyed, so it is meant for sets of strings that are
+    small compared to the number of times each of them is used. QStringPool
+    can be used from any number of threads at once. The application-wide
+    pool returned by globalInstance() is a good default.
+
+    QJsonObject::toVariantMap(), QCborMap::toVariantMap() and
+    QJsonStreamReader can optionally intern the keys and names they create in
+    a pool.
+
+    \sa QString, QByteArray, QConcurrentHash
+*/
+
+/*!
+    Constructs an empty pool.
+*/
+QStringPool::QStringPool()
+    : d(new QStringPoolPrivate)
+{
+}
+
+/*!
+    Destroys the pool. The strings that were returned by intern() remain
+    valid.
+*/
+QStringPool::~QStringPool() = default;
+
+/*!
+    Returns a string equal to \a str that shares its data with all other
+    strings equal to \a str that were returned by this pool.
+
+    The data of \a str is only copied if the pool does not contain an equal
+    string yet.
+*/
+QString QStringPool::intern(QStringView str)
+{
+    if (str.isEmpty())
+        return str.toString();
+    return internImpl(d->strings, rawString(str), [str] { return str.toString(); });
+}
+
+/*!
+    \overload
+
+    If the pool does not contain a string equal to \a str yet, it will share
+    the data of \a str, unless that is raw data (see QString::fromRawData()) or
+    has unused capacity. Otherwise, it stores a copy.
+*/
+QString QStringPool::intern(const QString &str)
+{
+    if (str.isEmpty())
+        return str;
+    return internImpl(d->strings, str, [&str] {
+        return canShare(str) ? str : QStringView(str).toString();
+    });
+}
+
+/*!
+    \overload
+
+    Returns a byte array equal to \a data that shares its data with all other
+    byte arrays equal to \a data that were returned by this pool.
+*/
+QByteArray QStringPool::intern(QByteArrayView data)
+{
+    if (data.isEmpty())
+        return data.toByteArray();
+    return internImpl(d->byteArrays, rawByteArray(data), [data] { return data.toByteArray(); });
+}
+
+/*!
+    \overload
+
+    If the pool does not contain a byte array equal to \a data yet, it will
+    share the data of \a data, unless that is raw data (see
+    QByteArray::fromRawData()) or has unused capacity. Otherwise, it stores a
+    copy.
+*/
+QByteArray QStringPool::intern(const QByteArray &data)
+{
+    if (data.isEmpty())
+        return data;
+    return internImpl(d->byteArrays, data, [&data] {
+        return canShare(data) ? data : QByteArrayView(data).toByteArray();
+    });
+}
+
+/*!
+    Returns \c true if the pool contains a string equal to \a str.
+*/
+bool QStringPool::contains(QStringView str) const
+{
+    return d->strings.contains(rawString(str));
+}
+
+/*!
+    \overload
+
+    Returns \c true if the pool contains a byte array equal to \a data.
+*/
+bool QStringPool::contains(QByteArrayView data) const
+{
+    return d->byteArrays.contains(rawByteArray(data));
+}
+
+/*!
+    Returns the number of distinct strings and byte arrays in the pool.
+
+    \sa isEmpty()
+*/
+qsizetype QStringPool::size() const
+{
+    return d->strings.size() + d->byteArrays.size();
+}
+
+/*!
+    \fn bool QStringPool::isEmpty() const
+
+    Returns \c true if the pool contains no strings or byte arrays.
+
+    \sa size()
+*/
+
+/*!
+    Removes all strings and byte arrays from the pool. The strings and byte
+    arrays that were returned by intern() remain valid, but will not share
+    their data with the ones that are interned afterwards.
+*/
+void QStringPool::clear()
+{
+    d->strings.clear();
+    d->byteArrays.clear();
+}
+
+/*!
+    Returns the application-wide pool. It is created the first time this
+    function is called, and is destroyed when the application exits.
+*/
+QStringPool *QStringPool::globalInstance()
+{
+    return globalStringPool();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,43 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QSTRINGPOOL_H
+#define QSTRINGPOOL_H
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qbytearrayview.h>
+#include <QtCore/qscopedpointer.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qstringview.h>
+
+QT_BEGIN_NAMESPACE
+
+class QStringPoolPrivate;
+class Q_CORE_EXPORT QStringPool
+{
+public:
+    QStringPool();
+    ~QStringPool();
+
+    QString intern(QStringView str);
+    QString intern(const QString &str);
+    QByteArray intern(QByteArrayView data);
+    QByteArray intern(const QByteArray &data);
+
+    bool contains(QStringView str) const;
+    bool contains(QByteArrayView data) const;
+
+    qsizetype size() const;
+    bool isEmpty() const { return size() == 0; }
+    void clear();
+
+    static QStringPool *globalInstance();
+
+private:
+    Q_DISABLE_COPY(QStringPool)
+    QScopedPointer<QStringPoolPrivate> d;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSTRINGPOOL_H
@@ -291,6 +291,9 @@ private:
 
     friend struct QtPrivate::UnwrapHandler;
 
+    template<typename U>
+    friend class QtPrivate::FutureAwaiter;
+
     using QFuturePrivate =
             std::conditional_t<std::is_same_v<T, void>, QFutureInterfaceBase, QFutureInterface<T>>;
 
@@ -530,4 +533,6 @@ QT_END_NAMESPACE
 
 Q_DECLARE_METATYPE_TEMPLATE_1ARG(QFuture)
 
+#include <QtCore/qfuture_coroutine.h>
+
 #endif // QFUTURE_H
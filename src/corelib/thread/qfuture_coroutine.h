@@ -0,0 +1,211 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QFUTURE_H
+#error Do not include qfuture_coroutine.h directly
+#endif
+
+#if 0
+#pragma qt_sync_skip_header_check
+#pragma qt_sync_stop_processing
+#endif
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+namespace QtPrivate {
+// Qt itself need not be built with coroutine support for this to be usable
+Q_CORE_EXPORT void postCoroutineResume(QObject *context, void *frame,
+                                       void (*resume)(void *), void (*destroy)(void *));
+}
+
+QT_END_NAMESPACE
+
+#if defined(__cpp_impl_coroutine) && defined(__cpp_lib_coroutine)
+
+#include <QtCore/qthread.h>
+#include <QtCore/qthreadpool.h>
+
+#include <exception>
+#include <utility>
+
+QT_BEGIN_NAMESPACE
+
+namespace QtPrivate {
+
+template<typename T>
+class FuturePromise;
+
+template<typename Promise>
+inline constexpr bool IsFuturePromise = false;
+template<typename T>
+inline constexpr bool IsFuturePromise<FuturePromise<T>> = true;
+
+template<typename T>
+class FutureAwaiter
+{
+public:
+    explicit FutureAwaiter(const QFuture<T> &future) : future(future) { }
+
+    bool await_ready() const { return future.isFinished(); }
+
+    template<typename Promise>
+    void await_suspend(std::coroutine_handle<Promise> handle)
+    {
+        // The continuation may run, and even finish the coroutine, before
+        // setContinuation() returns; the local copy keeps the state it is
+        // working on alive until then.
+        auto d = future.d;
+        d.setContinuation([handle](const QFutureInterfaceBase &parent) {
+            if constexpr (IsFuturePromise<Promise>) {
+                // like with then(), cancellation propagates along the chain
+                if (parent.isCanceled() && !parent.hasException()) {
+                    handle.destroy();
+                    return;
+                }
+            }
+            handle.resume();
+        });
+    }
+
+    T await_resume()
+    {
+        if constexpr (std::is_void_v<T>) {
+            future.waitForFinished();
+        } else {
+            future.waitForFinished();
+            Q_ASSERT_X(future.resultCount() > 0, "co_await QFuture",
+                       "The future was canceled without providing a result");
+            if constexpr (std::is_copy_constructible_v<T>)
+                return future.result();
+            else
+                return future.takeResult();
+        }
+    }
+
+private:
+    QFuture<T> future;
+};
+
+class ThreadPoolAwaiter : public QRunnable
+{
+public:
+    explicit ThreadPoolAwaiter(QThreadPool *pool) : pool(pool) { setAutoDelete(false); }
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h)
+    {
+        handle = h;
+        pool->start(this);
+    }
+    void await_resume() const noexcept { }
+
+    void run() override { handle.resume(); }
+
+private:
+    QThreadPool *pool;
+    std::coroutine_handle<> handle;
+};
+
+class ContextAwaiter
+{
+public:
+    explicit ContextAwaiter(QObject *context) : context(context) { }
+
+    bool await_ready() const { return context->thread() == QThread::currentThread(); }
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        postCoroutineResume(context, handle.address(),
+                            [](void *frame) { std::coroutine_handle<>::from_address(frame).resume(); },
+                            [](void *frame) { std::coroutine_handle<>::from_address(frame).destroy(); });
+    }
+    void await_resume() const noexcept { }
+
+private:
+    QObject *context;
+};
+
+template<typename T>
+class FuturePromiseBase
+{
+public:
+    FuturePromiseBase() { d.reportStarted(); }
+    ~FuturePromiseBase()
+    {
+        // destroyed without reaching co_return, e.g. on cancellation
+        if (!d.isFinished() && !returned)
+            d.reportCanceled();
+        d.reportFinished();
+    }
+
+    QFuture<T> get_return_object() { return d.future(); }
+    std::suspend_never initial_suspend() const noexcept { return {}; }
+    std::suspend_never final_suspend() const noexcept { return {}; }
+
+    void unhandled_exception()
+    {
+#ifndef QT_NO_EXCEPTIONS
+        d.reportException(std::current_exception());
+#else
+        std::terminate();
+#endif
+    }
+
+protected:
+    QFutureInterface<T> d;
+    bool returned = false;
+};
+
+template<typename T>
+class FuturePromise : public FuturePromiseBase<T>
+{
+public:
+    template<typename U = T>
+    void return_value(U &&value)
+    {
+        this->d.reportResult(std::forward<U>(value));
+        this->returned = true;
+    }
+};
+
+template<>
+class FuturePromise<void> : public FuturePromiseBase<void>
+{
+public:
+    void return_void() { returned = true; }
+};
+
+} // namespace QtPrivate
+
+template<typename T>
+QtPrivate::FutureAwaiter<T> operator co_await(const QFuture<T> &future)
+{
+    return QtPrivate::FutureAwaiter<T>(future);
+}
+
+namespace QtFuture {
+
+inline QtPrivate::ThreadPoolAwaiter resumeOn(QThreadPool *pool)
+{
+    return QtPrivate::ThreadPoolAwaiter(pool);
+}
+
+inline QtPrivate::ContextAwaiter resumeOn(QObject *context)
+{
+    return QtPrivate::ContextAwaiter(context);
+}
+
+} // namespace QtFuture
+
+QT_END_NAMESPACE
+
+template<typename T, typename... Args>
+struct std::coroutine_traits<QT_PREPEND_NAMESPACE(QFuture)<T>, Args...>
+{
+    using promise_type = QT_PREPEND_NAMESPACE(QtPrivate)::FuturePromise<T>;
+};
+
+#endif // __cpp_impl_coroutine && __cpp_lib_coroutine
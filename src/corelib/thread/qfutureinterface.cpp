@@ -6,7 +6,9 @@
 #include "qfutureinterface_p.h"
 
 #include <QtCore/qatomic.h>
+#include <QtCore/qcoreapplication.h>
 #include <QtCore/qthread.h>
+#include <QtCore/private/qobject_p.h>
 #include <QtCore/private/qsimd_p.h> // for qYieldCpu()
 #include <private/qthreadpool_p.h>
 
@@ -879,4 +881,46 @@ bool QFutureInterfaceBase::launchAsync() const
     return d->launchAsync;
 }
 
+namespace QtPrivate {
+
+namespace {
+class CoroutineResumeEvent : public QAbstractMetaCallEvent
+{
+public:
+    CoroutineResumeEvent(void *frame, void (*resume)(void *), void (*destroy)(void *))
+        : QAbstractMetaCallEvent(nullptr, -1), frame(frame), resume(resume), destroy(destroy)
+    { }
+
+    ~CoroutineResumeEvent() override
+    {
+        // never delivered, e.g. because the context object was destroyed
+        if (frame)
+            destroy(frame);
+    }
+
+    void placeMetaCall(QObject *) override { resume(std::exchange(frame, nullptr)); }
+
+private:
+    void *frame;
+    void (*resume)(void *);
+    void (*destroy)(void *);
+};
+} // unnamed namespace
+
+/*!
+    \internal
+
+    Resumes the coroutine \a frame in the thread of \a context by calling
+    \a resume from the event loop. If the event is discarded instead, for
+    instance because \a context gets destroyed, the coroutine is destroyed
+    by calling \a destroy.
+*/
+void postCoroutineResume(QObject *context, void *frame,
+                         void (*resume)(void *), void (*destroy)(void *))
+{
+    QCoreApplication::postEvent(context, new CoroutineResumeEvent(frame, resume, destroy));
+}
+
+} // namespace QtPrivate
+
 QT_END_NAMESPACE
@@ -0,0 +1,346 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qshardedreadwritelock.h"
+
+#include "qdeadlinetimer.h"
+#include "qmath.h"
+#include "qthread.h"
+#include "qlocking_p.h"
+#include "qwaitcondition_p.h"
+
+#include <atomic>
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+/*
+ * Implementation details of QShardedReadWriteLock:
+ *
+ * Every thread is assigned one of the shards when it first uses any
+ * QShardedReadWriteLock. A reader increments the counter of its shard and then
+ * checks that no writer is active; as long as there are no writers, readers
+ * on different shards never write to the same cache line.
+ *
+ * A writer first takes writerMutex, which serializes it against other
+ * writers, then raises the writer flag and waits until all shards have
+ * drained. Readers that see the flag undo their increment and wait on
+ * writerMutex, so they sleep until the writer is done. The flag and the shard
+ * counters use sequentially-consistent operations: either the reader sees the
+ * flag, or the writer sees the reader's count.
+ */
+
+namespace {
+
+enum { MaxShards = 64 };
+
+// one per cache line, so that readers on different shards don't interfere
+struct alignas(64) Shard
+{
+    std::atomic<int> readers{0};
+};
+
+uint shardForCurrentThread()
+{
+    Q_CONSTINIT static QBasicAtomicInteger<uint> nextShard = Q_BASIC_ATOMIC_INITIALIZER(0);
+    static thread_local const uint shard = nextShard.fetchAndAddRelaxed(1);
+    return shard;
+}
+
+} // unnamed namespace
+
+class QShardedReadWriteLockPrivate
+{
+public:
+    QShardedReadWriteLockPrivate()
+        : shardMask(qMin(qNextPowerOfTwo(quint32(QThread::idealThreadCount() - 1)),
+                         quint32(MaxShards)) - 1),
+          shards(new Shard[shardMask + 1])
+    {
+    }
+
+    Shard &currentShard() const { return shards[shardForCurrentThread() & shardMask]; }
+
+    bool drained() const
+    {
+        for (uint i = 0; i <= shardMask; ++i) {
+            if (shards[i].readers.load() != 0)
+                return false;
+        }
+        return true;
+    }
+
+    void unlockRead(Shard &shard)
+    {
+        if (shard.readers.fetch_sub(1) == 1 && writerActive.load()) {
+            // we may have been the last reader the writer is waiting for
+            const auto lock = qt_scoped_lock(drainMutex);
+            drainCond.notify_one();
+        }
+    }
+
+    bool abortWrite()
+    {
+        writerActive.store(false);
+        writerMutex.unlock();
+        return false;
+    }
+
+    const uint shardMask;
+    const std::unique_ptr<Shard[]> shards;
+
+    alignas(64) std::atomic<bool> writerActive{false};
+    std::atomic<Qt::HANDLE> writer{nullptr};
+    QMutex writerMutex;
+    QtPrivate::mutex drainMutex;
+    QtPrivate::condition_variable drainCond;
+};
+
+/*! \class QShardedReadWriteLock
+    \inmodule QtCore
+    \since 6.5
+    \brief The QShardedReadWriteLock class provides a read-write lock that
+    scales with the number of concurrent readers.
+
+    \threadsafe
+
+    \ingroup thread
+
+    QShardedReadWriteLock offers the same guarantees as a non-recursive
+    QReadWriteLock, but is optimized for data that is read very often from
+    many threads at the same time and only rarely written, such as a shared
+    cache.
+
+    QReadWriteLock keeps track of its readers in a single counter. Even when
+    there is no writer, every lockForRead() and unlock() modifies that
+    counter, so the processor cores that read concurrently keep taking the
+    cache line holding it away from each other. QShardedReadWriteLock instead
+    spreads the readers over several counters, each on its own cache line,
+    so that readers in different threads usually don't touch the same
+    memory.
+
+    In exchange, locking for writing is more expensive: the writer has to
+    wait until the readers of every counter have left, and the lock uses
+    considerably more memory than a QReadWriteLock. Prefer QReadWriteLock
+    unless profiling shows contention between readers.
+
+    Like QReadWriteLock, a writer that is waiting for the lock prevents new
+    readers from obtaining it. Consequently, a thread that already holds the
+    lock for reading must not lock it for reading again, as this deadlocks
+    if a writer is waiting in between. The lock must be unlocked by the
+    thread that locked it.
+
+    QShardedReadWriteLock cannot be used with QReadLocker and QWriteLocker.
+    It meets the requirements of the standard \c SharedMutex concept instead,
+    so it can be used with \c{std::shared_lock} and \c{std::unique_lock}.
+
+    \sa QReadWriteLock
+*/
+
+/*!
+    Constructs a QShardedReadWriteLock object.
+
+    The number of reader counters depends on QThread::idealThreadCount().
+*/
+QShardedReadWriteLock::QShardedReadWriteLock()
+    : d(new QShardedReadWriteLockPrivate)
+{
+}
+
+/*!
+    Destroys the QShardedReadWriteLock object.
+
+    \warning Destroying a read-write lock that is in use may result
+    in undefined behavior.
+*/
+QShardedReadWriteLock::~QShardedReadWriteLock()
+{
+    delete d;
+}
+
+/*!
+    Locks the lock for reading. This function will block the current
+    thread if another thread has locked for writing, or is waiting to do so.
+
+    \sa unlock(), lockForWrite(), tryLockForRead()
+*/
+void QShardedReadWriteLock::lockForRead()
+{
+    tryLockForRead(-1);
+}
+
+/*!
+    Attempts to lock for reading. If the lock was obtained, this
+    function returns \c true, otherwise it returns \c false instead of
+    waiting for the lock to become available, i.e. it does not block.
+
+    The lock attempt will fail if another thread has locked for
+    writing, or is waiting to do so.
+
+    \sa unlock(), lockForRead()
+*/
+bool QShardedReadWriteLock::tryLockForRead()
+{
+    return tryLockForRead(0);
+}
+
+/*! \overload
+
+    Attempts to lock for reading. This function returns \c true if the
+    lock was obtained; otherwise it returns \c false. If another thread
+    has locked for writing, this function will wait for at most \a
+    timeout milliseconds for the lock to become available.
+
+    Passing a negative number as the \a timeout is equivalent to calling
+    lockForRead().
+
+    \sa unlock(), lockForRead()
+*/
+bool QShardedReadWriteLock::tryLockForRead(int timeout)
+{
+    Shard &shard = d->currentShard();
+    QDeadlineTimer deadline(timeout);
+    while (true) {
+        shard.readers.fetch_add(1);
+        if (Q_LIKELY(!d->writerActive.load()))
+            return true;
+
+        // a writer is active or waiting for the readers to leave; give way
+        d->unlockRead(shard);
+        if (!d->writerMutex.tryLock(deadline.remainingTime()))
+            return false;
+        d->writerMutex.unlock();
+    }
+}
+
+/*! \fn template <typename Rep, typename Period> bool QShardedReadWriteLock::tryLockForRead(std::chrono::duration<Rep, Period> timeout)
+    \overload
+
+    Attempts to lock for reading, waiting for at most \a timeout.
+*/
+
+/*!
+    Locks the lock for writing. This function will block the current
+    thread if another thread has locked for reading or writing.
+
+    It is not possible to lock for write if the thread already has
+    locked for read.
+
+    \sa unlock(), lockForRead(), tryLockForWrite()
+*/
+void QShardedReadWriteLock::lockForWrite()
+{
+    tryLockForWrite(-1);
+}
+
+/*!
+    Attempts to lock for writing. If the lock was obtained, this
+    function returns \c true; otherwise, it returns \c false immediately.
+
+    The lock attempt will fail if another thread has locked for
+    reading or writing.
+
+    \sa unlock(), lockForWrite()
+*/
+bool QShardedReadWriteLock::tryLockForWrite()
+{
+    return tryLockForWrite(0);
+}
+
+/*! \overload
+
+    Attempts to lock for writing. This function returns \c true if the
+    lock was obtained; otherwise it returns \c false. If another thread
+    has locked for reading or writing, this function will wait for at
+    most \a timeout milliseconds for the lock to become available.
+
+    Passing a negative number as the \a timeout is equivalent to calling
+    lockForWrite().
+
+    \sa unlock(), lockForWrite()
+*/
+bool QShardedReadWriteLock::tryLockForWrite(int timeout)
+{
+    QDeadlineTimer deadline(timeout);
+    if (!d->writerMutex.tryLock(deadline.remainingTime()))
+        return false;
+
+    d->writerActive.store(true);
+    if (!d->drained()) {
+        if (!timeout)
+            return d->abortWrite();
+
+        auto lock = qt_unique_lock(d->drainMutex);
+        const auto drained = [this] { return d->drained(); };
+        if (deadline.isForever()) {
+            d->drainCond.wait(lock, drained);
+        } else if (!d->drainCond.wait_until(lock, deadline.deadline<std::chrono::steady_clock>(),
+                                            drained)) {
+            lock.unlock();
+            return d->abortWrite();
+        }
+    }
+    d->writer.store(QThread::currentThreadId(), std::memory_order_relaxed);
+    return true;
+}
+
+/*! \fn template <typename Rep, typename Period> bool QShardedReadWriteLock::tryLockForWrite(std::chrono::duration<Rep, Period> timeout)
+    \overload
+
+    Attempts to lock for writing, waiting for at most \a timeout.
+*/
+
+/*!
+    Unlocks the lock, which the current thread must have locked for reading
+    or writing.
+
+    \sa lockForRead(), lockForWrite(), unlock_shared()
+*/
+void QShardedReadWriteLock::unlock()
+{
+    if (d->writer.load(std::memory_order_relaxed) != QThread::currentThreadId()) {
+        unlock_shared();
+        return;
+    }
+
+    d->writer.store(nullptr, std::memory_order_relaxed);
+    d->writerActive.store(false);
+    d->writerMutex.unlock();
+}
+
+/*!
+    Unlocks the lock, which the current thread must have locked for
+    reading. This is slightly faster than unlock().
+
+    \sa lockForRead(), unlock()
+*/
+void QShardedReadWriteLock::unlock_shared()
+{
+    d->unlockRead(d->currentShard());
+}
+
+/*!
+    \fn void QShardedReadWriteLock::lock()
+
+    Same as lockForWrite(). Provided for compatibility with \c{std::unique_lock}.
+*/
+
+/*!
+    \fn bool QShardedReadWriteLock::try_lock()
+
+    Same as tryLockForWrite(). Provided for compatibility with \c{std::unique_lock}.
+*/
+
+/*!
+    \fn void QShardedReadWriteLock::lock_shared()
+
+    Same as lockForRead(). Provided for compatibility with \c{std::shared_lock}.
+*/
+
+/*!
+    \fn bool QShardedReadWriteLock::try_lock_shared()
+
+    Same as tryLockForRead(). Provided for compatibility with \c{std::shared_lock}.
+*/
+
+QT_END_NAMESPACE
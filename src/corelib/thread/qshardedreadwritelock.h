@@ -0,0 +1,54 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QSHARDEDREADWRITELOCK_H
+#define QSHARDEDREADWRITELOCK_H
+
+#include <QtCore/qglobal.h>
+#include <QtCore/qmutex.h> // for convertToMilliseconds()
+
+#include <chrono>
+
+QT_REQUIRE_CONFIG(thread);
+
+QT_BEGIN_NAMESPACE
+
+class QShardedReadWriteLockPrivate;
+
+class Q_CORE_EXPORT QShardedReadWriteLock
+{
+public:
+    QShardedReadWriteLock();
+    ~QShardedReadWriteLock();
+
+    void lockForRead();
+    bool tryLockForRead();
+    bool tryLockForRead(int timeout);
+    template <typename Rep, typename Period>
+    bool tryLockForRead(std::chrono::duration<Rep, Period> timeout)
+    { return tryLockForRead(QtPrivate::convertToMilliseconds(timeout)); }
+
+    void lockForWrite();
+    bool tryLockForWrite();
+    bool tryLockForWrite(int timeout);
+    template <typename Rep, typename Period>
+    bool tryLockForWrite(std::chrono::duration<Rep, Period> timeout)
+    { return tryLockForWrite(QtPrivate::convertToMilliseconds(timeout)); }
+
+    void unlock();
+
+    // std::shared_mutex compatibility:
+    void lock() { lockForWrite(); }
+    bool try_lock() { return tryLockForWrite(); }
+    void lock_shared() { lockForRead(); }
+    bool try_lock_shared() { return tryLockForRead(); }
+    void unlock_shared();
+
+private:
+    Q_DISABLE_COPY(QShardedReadWriteLock)
+    QShardedReadWriteLockPrivate *d;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSHARDEDREADWRITELOCK_H
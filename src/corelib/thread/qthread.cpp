@@ -15,6 +15,7 @@
 #include "private/qcoreapplication_p.h"
 
 #include <limits>
+#include <utility>
 
 QT_BEGIN_NAMESPACE
 
@@ -58,6 +59,7 @@ QThreadData::~QThreadData()
     thread.storeRelease(nullptr);
     delete t;
 
+    flushPostEventInbox();
     for (int i = 0; i < postEventList.size(); ++i) {
         const QPostEvent &pe = postEventList.at(i);
         if (pe.event) {
@@ -70,6 +72,40 @@ QThreadData::~QThreadData()
     // fprintf(stderr, "QThreadData %p destroyed\n", this);
 }
 
+void QThreadData::flushPostEventInboxHelper()
+{
+    // the inbox is a stack, restore the order in which the events were posted
+    QAbstractMetaCallEvent *event = postEventList.inbox.fetchAndStoreAcquire(nullptr);
+    QAbstractMetaCallEvent *first = nullptr;
+    while (event) {
+        QAbstractMetaCallEvent *next = std::exchange(event->inboxNext_, first);
+        first = event;
+        event = next;
+    }
+
+    while ((event = first)) {
+        first = std::exchange(event->inboxNext_, nullptr);
+        QObject *receiver = std::exchange(event->inboxReceiver_, nullptr);
+
+        QThreadData *receiverData = receiver->d_func()->threadData.loadAcquire();
+        if (receiverData == this) {
+            postEventList.addEvent(QPostEvent(receiver, event, Qt::NormalEventPriority));
+            canWait = false;
+        } else if (receiverData) {
+            // the receiver was moved to another thread after the event was
+            // pushed, follow it
+            receiverData->postEventList.pushToInbox(receiver, event);
+            if (QAbstractEventDispatcher *dispatcher = receiverData->eventDispatcher.loadAcquire())
+                dispatcher->wakeUp();
+        } else {
+            // posting during destruction, like postEvent() does
+            --receiver->d_func()->postedEvents;
+            event->m_posted = false;
+            delete event;
+        }
+    }
+}
+
 void QThreadData::ref()
 {
 #if QT_CONFIG(thread)
@@ -71,8 +71,24 @@ public:
 
     QMutex mutex;
 
+    // Queued calls that postEvent() hands over without taking the mutex.
+    // The inbox is a lock-free stack, linked through the events, that any
+    // thread may push to; whoever holds the mutex moves its contents to the
+    // list (see QThreadData::flushPostEventInbox()) before looking at the
+    // list.
+    QAtomicPointer<QAbstractMetaCallEvent> inbox;
+
     inline QPostEventList() : QList<QPostEvent>(), recursion(0), startOffset(0), insertionOffset(0) { }
 
+    void pushToInbox(QObject *receiver, QAbstractMetaCallEvent *event)
+    {
+        event->inboxReceiver_ = receiver;
+        QAbstractMetaCallEvent *head = inbox.loadRelaxed();
+        do {
+            event->inboxNext_ = head;
+        } while (!inbox.testAndSetRelease(head, event, head));
+    }
+
     void addEvent(const QPostEvent &ev)
     {
         int priority = ev.priority;
@@ -313,13 +329,23 @@ public:
         return createEventDispatcher();
     }
 
+    // postEventList.mutex must be locked
+    void flushPostEventInbox()
+    {
+        if (postEventList.inbox.loadRelaxed())
+            flushPostEventInboxHelper();
+    }
+
     bool canWaitLocked()
     {
         QMutexLocker locker(&postEventList.mutex);
+        flushPostEventInbox();
         return canWait;
     }
 
 private:
+    void flushPostEventInboxHelper();
+
     QAtomicInt _ref;
 
 public:
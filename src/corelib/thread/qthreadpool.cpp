@@ -5,6 +5,7 @@
 #include "qthreadpool_p.h"
 #include "qdeadlinetimer.h"
 #include "qcoreapplication.h"
+#include "qvarlengtharray.h"
 
 #include <algorithm>
 #include <memory>
@@ -24,11 +25,24 @@ public:
     void run() override;
     void registerThreadInactive();
 
+    QRunnable *takeLocal();
+    QRunnable *stealLocal();
+
     QWaitCondition runnableReady;
     QThreadPoolPrivate *manager;
     QRunnable *runnable;
+
+    // runnables started from this thread while work stealing is enabled;
+    // the owner pops from the back, other threads steal from the front
+    QMutex localMutex;
+    QList<QRunnable *> localQueue;
 };
 
+Q_CONSTINIT static thread_local QThreadPoolThread *currentPoolThread = nullptr;
+
+// upper bound for the runnables a worker moves from the queue to its local queue at once
+static constexpr int MaxLocalBatch = 16;
+
 /*
     QThreadPool private class.
 */
@@ -48,6 +62,7 @@ QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
 */
 void QThreadPoolThread::run()
 {
+    currentPoolThread = this;
     QMutexLocker locker(&manager->mutex);
     for(;;) {
         QRunnable *r = runnable;
@@ -55,27 +70,32 @@ void QThreadPoolThread::run()
 
         do {
             if (r) {
-                // If autoDelete() is false, r might already be deleted after run(), so check status now.
-                const bool del = r->autoDelete();
-
-                // run the task
                 locker.unlock();
+                do {
+                    // If autoDelete() is false, r might already be deleted after run(), so check status now.
+                    const bool del = r->autoDelete();
+
+                    // run the task
 #ifndef QT_NO_EXCEPTIONS
-                try {
+                    try {
 #endif
-                    r->run();
+                        r->run();
 #ifndef QT_NO_EXCEPTIONS
-                } catch (...) {
-                    qWarning("Qt Concurrent has caught an exception thrown from a worker thread.\n"
-                             "This is not supported, exceptions thrown in worker threads must be\n"
-                             "caught before control returns to Qt Concurrent.");
-                    registerThreadInactive();
-                    throw;
-                }
+                    } catch (...) {
+                        qWarning("Qt Concurrent has caught an exception thrown from a worker thread.\n"
+                                 "This is not supported, exceptions thrown in worker threads must be\n"
+                                 "caught before control returns to Qt Concurrent.");
+                        registerThreadInactive();
+                        throw;
+                    }
 #endif
 
-                if (del)
-                    delete r;
+                    if (del)
+                        delete r;
+
+                    // runnables this thread queued for itself do not need the pool's lock
+                    r = takeLocal();
+                } while (r);
                 locker.relock();
             }
 
@@ -83,6 +103,15 @@ void QThreadPoolThread::run()
             if (manager->tooManyThreadsActive())
                 break;
 
+            if (manager->workStealing.loadRelaxed()) {
+                r = manager->takeQueuedBatch(this);
+                if (!r)
+                    r = manager->steal(this);
+                if (!r)
+                    break;
+                continue;
+            }
+
             // all work is done, time to wait for more
             if (manager->queue.isEmpty())
                 break;
@@ -105,10 +134,22 @@ void QThreadPoolThread::run()
         // if too many threads are active, expire this thread
         if (manager->tooManyThreadsActive()) {
             manager->expiredThreads.enqueue(this);
+            manager->updateSaturation();
             registerThreadInactive();
             return;
         }
         manager->waitingThreads.enqueue(this);
+        manager->updateSaturation();
+        if (manager->workStealing.loadRelaxed()) {
+            // A worker that saw the pool saturated may have queued a runnable
+            // locally after we last looked; now that the pool is no longer
+            // saturated it will wake us instead, so one more look suffices.
+            if ((runnable = manager->steal(this))) {
+                manager->waitingThreads.removeOne(this);
+                manager->updateSaturation();
+                continue;
+            }
+        }
         registerThreadInactive();
         // wait for work, exiting after the expiry timeout is reached
         runnableReady.wait(locker.mutex(), QDeadlineTimer(manager->expiryTimeout));
@@ -131,6 +172,18 @@ void QThreadPoolThread::registerThreadInactive()
         manager->noActiveThreads.wakeAll();
 }
 
+QRunnable *QThreadPoolThread::takeLocal()
+{
+    QMutexLocker locker(&localMutex);
+    return localQueue.isEmpty() ? nullptr : localQueue.takeLast();
+}
+
+QRunnable *QThreadPoolThread::stealLocal()
+{
+    QMutexLocker locker(&localMutex);
+    return localQueue.isEmpty() ? nullptr : localQueue.takeFirst();
+}
+
 
 /*
     \internal
@@ -155,6 +208,7 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
         // recycle an available thread
         enqueueTask(task);
         waitingThreads.takeFirst()->runnableReady.wakeOne();
+        updateSaturation();
         return true;
     }
 
@@ -172,6 +226,7 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
         thread->wait();
         Q_ASSERT(thread->isFinished());
         thread->start(threadPriority);
+        updateSaturation();
         return true;
     }
 
@@ -221,6 +276,20 @@ void QThreadPoolPrivate::tryToStartMoreThreads()
             delete page;
         }
     }
+
+    // runnables waiting in the local queue of a busy (possibly blocked) worker
+    if (workStealing.loadRelaxed()) {
+        while (!areAllThreadsActive()) {
+            QRunnable *r = steal(nullptr);
+            if (!r)
+                break;
+            if (!tryStart(r)) {
+                enqueueTask(r);
+                break;
+            }
+        }
+    }
+    updateSaturation();
 }
 
 bool QThreadPoolPrivate::areAllThreadsActive() const
@@ -251,6 +320,7 @@ void QThreadPoolPrivate::startThread(QRunnable *runnable)
 
     thread->runnable = runnable;
     thread.release()->start(threadPriority);
+    updateSaturation();
 }
 
 /*!
@@ -266,6 +336,7 @@ void QThreadPoolPrivate::reset()
     auto allThreadsCopy = std::exchange(allThreads, {});
     expiredThreads.clear();
     waitingThreads.clear();
+    updateSaturation();
 
     mutex.unlock();
 
@@ -321,6 +392,115 @@ void QThreadPoolPrivate::clear()
         }
         delete page;
     }
+
+    // runnables that workers started for themselves in work-stealing mode
+    QList<QRunnable *> local;
+    for (QThreadPoolThread *thread : qAsConst(allThreads)) {
+        QMutexLocker localLocker(&thread->localMutex);
+        local += std::exchange(thread->localQueue, {});
+    }
+    locker.unlock();
+    for (QRunnable *r : qAsConst(local)) {
+        if (r->autoDelete())
+            delete r;
+    }
+}
+
+/*!
+    \internal
+
+    Work-stealing counterpart of popping the queue: returns the first queued
+    runnable and moves a share of the ones behind it with the same priority to
+    the local queue of \a thread, so that a busy worker does not have to take
+    the mutex again for each of them.
+*/
+QRunnable *QThreadPoolPrivate::takeQueuedBatch(QThreadPoolThread *thread)
+{
+    if (queue.isEmpty())
+        return nullptr;
+
+    QueuePage *page = queue.first();
+    QRunnable *r = page->pop();
+
+    int batchSize = qMin(page->size() / maxThreadCount(), MaxLocalBatch);
+    if (batchSize > 0) {
+        QVarLengthArray<QRunnable *, MaxLocalBatch> batch;
+        while (batchSize-- > 0 && !page->isFinished())
+            batch.append(page->pop());
+        // the owner takes from the back, so keep the queue order by reversing
+        QMutexLocker locker(&thread->localMutex);
+        thread->localQueue.append(QList<QRunnable *>(batch.crbegin(), batch.crend()));
+    }
+
+    if (page->isFinished()) {
+        queue.removeFirst();
+        delete page;
+    }
+    return r;
+}
+
+/*!
+    \internal
+
+    Takes the oldest runnable from the local queue of some worker other than
+    \a thief, or returns \nullptr if all of them are empty. The victims are
+    visited round-robin, so that concurrent thieves spread out.
+*/
+QRunnable *QThreadPoolPrivate::steal(QThreadPoolThread *thief)
+{
+    const qsizetype count = allThreads.size();
+    if (count == 0)
+        return nullptr;
+
+    const qsizetype first = stealHint++ % count;
+    for (int pass = 0; pass < 2; ++pass) {
+        qsizetype i = 0;
+        for (QThreadPoolThread *victim : qAsConst(allThreads)) {
+            const bool inPass = pass == 0 ? i >= first : i < first;
+            ++i;
+            if (!inPass || victim == thief)
+                continue;
+            if (QRunnable *r = victim->stealLocal())
+                return r;
+        }
+    }
+    return nullptr;
+}
+
+/*!
+    \internal
+
+    Called without the mutex held. If the calling thread is a worker of this
+    pool, appends \a runnable to the worker's local queue and returns \c true.
+    The mutex is only needed if some thread is idle, or could be started, to
+    take over work from the local queue.
+*/
+bool QThreadPoolPrivate::tryStartLocal(QRunnable *runnable)
+{
+    QThreadPoolThread *thread = currentPoolThread;
+    if (!thread || thread->manager != this)
+        return false;
+
+    {
+        QMutexLocker locker(&thread->localMutex);
+        thread->localQueue.append(runnable);
+    }
+
+    if (saturated.loadAcquire())
+        return true;
+
+    QMutexLocker locker(&mutex);
+    if (!areAllThreadsActive()) {
+        if (!waitingThreads.isEmpty()) {
+            // the woken thread steals the runnable
+            waitingThreads.takeFirst()->runnableReady.wakeOne();
+            updateSaturation();
+        } else if (QRunnable *r = thread->stealLocal()) {
+            if (!tryStart(r))
+                enqueueTask(r);
+        }
+    }
+    return true;
 }
 
 /*!
@@ -358,6 +538,12 @@ bool QThreadPool::tryTake(QRunnable *runnable)
         }
     }
 
+    for (QThreadPoolThread *thread : qAsConst(d->allThreads)) {
+        QMutexLocker localLocker(&thread->localMutex);
+        if (thread->localQueue.removeOne(runnable))
+            return true;
+    }
+
     return false;
 }
 
@@ -495,6 +681,9 @@ void QThreadPool::start(QRunnable *runnable, int priority)
         return;
 
     Q_D(QThreadPool);
+    if (d->workStealing.loadRelaxed() && d->tryStartLocal(runnable))
+        return;
+
     QMutexLocker locker(&d->mutex);
 
     if (!d->tryStart(runnable))
@@ -668,6 +857,7 @@ void QThreadPool::reserveThread()
     Q_D(QThreadPool);
     QMutexLocker locker(&d->mutex);
     ++d->reservedThreads;
+    d->updateSaturation();
 }
 
 /*! \property QThreadPool::stackSize
@@ -720,6 +910,57 @@ QThread::Priority QThreadPool::threadPriority() const
     return d->threadPriority;
 }
 
+/*! \property QThreadPool::workStealingEnabled
+    \brief whether runnables started from the pool's worker threads are
+    scheduled by work stealing.
+
+    By default, all runnables passed to start() go through a single queue
+    guarded by one lock, which worker threads take after every runnable.
+    With work stealing enabled, a runnable started from one of this pool's
+    own threads is instead appended to a queue local to that thread, which
+    the thread processes newest first. Idle threads steal the oldest entries
+    from the local queues of busy threads. Runnables started from other
+    threads still go through the shared queue, from which busy workers take
+    several at a time. This reduces lock contention considerably when
+    runnables are small and spawn further runnables, as in divide-and-conquer
+    algorithms.
+
+    The \c priority passed to start() is only honored for the shared queue;
+    runnables in local queues are run without regard to their priority.
+    reserveThread() and releaseThread() work in both modes.
+
+    Disabling work stealing moves runnables that are still waiting in local
+    queues back to the shared queue.
+
+    The default value is \c false.
+
+    \since 6.5
+*/
+
+void QThreadPool::setWorkStealingEnabled(bool enable)
+{
+    Q_D(QThreadPool);
+    QMutexLocker locker(&d->mutex);
+    if (bool(d->workStealing.loadRelaxed()) == enable)
+        return;
+    d->workStealing.storeRelaxed(enable);
+    if (enable)
+        return;
+
+    for (QThreadPoolThread *thread : qAsConst(d->allThreads)) {
+        QMutexLocker localLocker(&thread->localMutex);
+        for (QRunnable *r : std::exchange(thread->localQueue, {}))
+            d->enqueueTask(r);
+    }
+    d->tryToStartMoreThreads();
+}
+
+bool QThreadPool::isWorkStealingEnabled() const
+{
+    Q_D(const QThreadPool);
+    return d->workStealing.loadRelaxed();
+}
+
 /*!
     Releases a thread previously reserved by a call to reserveThread().
 
@@ -774,6 +1015,7 @@ void QThreadPool::startOnReservedThread(QRunnable *runnable)
         // and something took the one minimum thread.
         d->enqueueTask(runnable, INT_MAX);
     }
+    d->updateSaturation();
 }
 
 /*!
@@ -16,6 +16,7 @@
 //
 //
 
+#include "QtCore/qatomic.h"
 #include "QtCore/qmutex.h"
 #include "QtCore/qthread.h"
 #include "QtCore/qwaitcondition.h"
@@ -43,6 +44,9 @@ public:
 
     bool isFinished() { return m_firstIndex > m_lastIndex; }
 
+    // upper bound, entries removed by tryTake() are still counted
+    int size() const { return m_lastIndex - m_firstIndex + 1; }
+
     void push(QRunnable *runnable)
     {
         Q_ASSERT(runnable != nullptr);
@@ -134,6 +138,12 @@ public:
     void stealAndRunRunnable(QRunnable *runnable);
     void deletePageIfFinished(QueuePage *page);
 
+    // work-stealing mode
+    bool tryStartLocal(QRunnable *runnable);
+    QRunnable *takeQueuedBatch(QThreadPoolThread *thread);
+    QRunnable *steal(QThreadPoolThread *thief);
+    void updateSaturation() { saturated.storeRelease(areAllThreadsActive()); }
+
     mutable QMutex mutex;
     QSet<QThreadPoolThread *> allThreads;
     QQueue<QThreadPoolThread *> waitingThreads;
@@ -148,6 +158,12 @@ public:
     int activeThreads = 0;
     uint stackSize = 0;
     QThread::Priority threadPriority = QThread::InheritPriority;
+
+    QAtomicInt workStealing; // bool
+    // mirrors areAllThreadsActive(), so that runnables started from a worker
+    // thread can be queued without taking the mutex
+    QAtomicInt saturated; // bool
+    uint stealHint = 0;
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,869 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QBTREEMAP_H
+#define QBTREEMAP_H
+
+#include <QtCore/qlist.h>
+#include <QtCore/qmap.h>
+#include <QtCore/qshareddata.h>
+#include <QtCore/qshareddata_impl.h>
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+
+QT_BEGIN_NAMESPACE
+
+namespace QBTreeMapPrivate {
+
+// The map is a B+tree: all elements are stored in the leaves, sorted and in
+// contiguous arrays, and the leaves are linked to their neighbors so that
+// iteration never has to go back up the tree. The branches only hold copies
+// of the first key of each of their children except the first one, which
+// separate the children: children[i] holds the keys k with
+// keys[i - 1] <= k < keys[i].
+//
+// Insertion splits full nodes and removal refills nodes that are at their
+// minimum size on the way down, so that neither ever has to walk back up.
+template <typename Key, typename T>
+struct Data : public QSharedData
+{
+    // a leaf holds about 1 KiB worth of elements
+    static constexpr int LeafCapacity = qBound(8, int(1024 / (sizeof(Key) + sizeof(T))), 128);
+    static constexpr int LeafMinimum = LeafCapacity / 2;
+    // number of children of a branch
+    static constexpr int BranchCapacity = 32;
+    static constexpr int BranchMinimum = BranchCapacity / 2;
+
+    struct Node
+    {
+        Node(bool isLeaf) : isLeaf(isLeaf) {}
+        int count = 0;      // number of elements, or of children
+        const bool isLeaf;
+    };
+
+    struct Leaf : Node
+    {
+        Leaf() : Node(true) {}
+        ~Leaf()
+        {
+            std::destroy_n(keys(), this->count);
+            std::destroy_n(values(), this->count);
+        }
+        Q_DISABLE_COPY_MOVE(Leaf)
+
+        Key *keys() { return reinterpret_cast<Key *>(keyStorage); }
+        const Key *keys() const { return reinterpret_cast<const Key *>(keyStorage); }
+        T *values() { return reinterpret_cast<T *>(valueStorage); }
+        const T *values() const { return reinterpret_cast<const T *>(valueStorage); }
+
+        Leaf *prev = nullptr;
+        Leaf *next = nullptr;
+        alignas(Key) unsigned char keyStorage[LeafCapacity * sizeof(Key)];
+        alignas(T) unsigned char valueStorage[LeafCapacity * sizeof(T)];
+    };
+
+    struct Branch : Node
+    {
+        Branch() : Node(false) {}
+        ~Branch() { std::destroy_n(keys(), qMax(this->count - 1, 0)); }
+        Q_DISABLE_COPY_MOVE(Branch)
+
+        Key *keys() { return reinterpret_cast<Key *>(keyStorage); }
+        const Key *keys() const { return reinterpret_cast<const Key *>(keyStorage); }
+
+        Node *children[BranchCapacity];
+        alignas(Key) unsigned char keyStorage[(BranchCapacity - 1) * sizeof(Key)];
+    };
+
+    struct Position
+    {
+        Leaf *leaf;
+        int index;
+    };
+
+    Node *root = nullptr;
+    Leaf *first = nullptr;
+    Leaf *last = nullptr;
+    qsizetype size = 0;
+
+    Data() = default;
+    Data(const Data &other)
+        : QSharedData(), size(other.size)
+    {
+        if (other.root)
+            root = copyNode(other.root);
+    }
+    ~Data() { destroyNode(root); }
+    Data &operator=(const Data &) = delete;
+
+    static bool isFull(const Node *node)
+    { return node->count == (node->isLeaf ? LeafCapacity : BranchCapacity); }
+    static bool isAtMinimum(const Node *node)
+    { return node->count <= (node->isLeaf ? LeafMinimum : BranchMinimum); }
+
+    static int childIndex(const Branch *branch, const Key &key)
+    {
+        const Key *keys = branch->keys();
+        return int(std::upper_bound(keys, keys + branch->count - 1, key, std::less<Key>()) - keys);
+    }
+
+    // array helpers; the arrays hold count constructed elements
+    template <typename U>
+    static void insertInto(U *array, int count, int i, U &&value)
+    {
+        if (i == count) {
+            new (array + count) U(std::move(value));
+            return;
+        }
+        new (array + count) U(std::move(array[count - 1]));
+        std::move_backward(array + i, array + count - 1, array + count);
+        array[i] = std::move(value);
+    }
+
+    template <typename U>
+    static void eraseFrom(U *array, int count, int i)
+    {
+        std::move(array + i + 1, array + count, array + i);
+        array[count - 1].~U();
+    }
+
+    // moves n elements from src to the uninitialized dst and destroys them in src
+    template <typename U>
+    static void relocate(U *src, int n, U *dst)
+    {
+        for (int i = 0; i < n; ++i) {
+            new (dst + i) U(std::move(src[i]));
+            src[i].~U();
+        }
+    }
+
+    Node *copyNode(const Node *node)
+    {
+        if (node->isLeaf) {
+            const Leaf *from = static_cast<const Leaf *>(node);
+            Leaf *leaf = new Leaf;
+            std::uninitialized_copy_n(from->keys(), from->count, leaf->keys());
+            std::uninitialized_copy_n(from->values(), from->count, leaf->values());
+            leaf->count = from->count;
+            // the leaves are copied from left to right
+            leaf->prev = last;
+            if (last)
+                last->next = leaf;
+            else
+                first = leaf;
+            last = leaf;
+            return leaf;
+        }
+
+        const Branch *from = static_cast<const Branch *>(node);
+        Branch *branch = new Branch;
+        for (int i = 0; i < from->count; ++i) {
+            branch->children[i] = copyNode(from->children[i]);
+            if (i > 0)
+                new (branch->keys() + i - 1) Key(from->keys()[i - 1]);
+            branch->count = i + 1;
+        }
+        return branch;
+    }
+
+    static void destroyNode(Node *node)
+    {
+        if (!node)
+            return;
+        if (node->isLeaf) {
+            delete static_cast<Leaf *>(node);
+            return;
+        }
+        Branch *branch = static_cast<Branch *>(node);
+        for (int i = 0; i < branch->count; ++i)
+            destroyNode(branch->children[i]);
+        delete branch;
+    }
+
+    void clear()
+    {
+        destroyNode(root);
+        root = nullptr;
+        first = last = nullptr;
+        size = 0;
+    }
+
+    Position begin() const { return { first, 0 }; }
+    Position end() const { return { last, last ? last->count : 0 }; }
+
+    // the position past the end of a leaf is the beginning of the next one
+    static Position normalized(Leaf *leaf, int index)
+    {
+        if (index == leaf->count && leaf->next)
+            return { leaf->next, 0 };
+        return { leaf, index };
+    }
+
+    Leaf *findLeaf(const Key &key) const
+    {
+        Node *node = root;
+        while (!node->isLeaf) {
+            const Branch *branch = static_cast<const Branch *>(node);
+            node = branch->children[childIndex(branch, key)];
+        }
+        return static_cast<Leaf *>(node);
+    }
+
+    Position lowerBound(const Key &key) const
+    {
+        if (!root)
+            return end();
+        Leaf *leaf = findLeaf(key);
+        const Key *keys = leaf->keys();
+        return normalized(leaf, int(std::lower_bound(keys, keys + leaf->count, key,
+                                                     std::less<Key>()) - keys));
+    }
+
+    Position upperBound(const Key &key) const
+    {
+        if (!root)
+            return end();
+        Leaf *leaf = findLeaf(key);
+        const Key *keys = leaf->keys();
+        return normalized(leaf, int(std::upper_bound(keys, keys + leaf->count, key,
+                                                     std::less<Key>()) - keys));
+    }
+
+    // returns a null position if there is no element with key
+    Position find(const Key &key) const
+    {
+        const Position pos = lowerBound(key);
+        if (!pos.leaf || pos.index == pos.leaf->count
+                || std::less<Key>()(key, pos.leaf->keys()[pos.index]))
+            return { nullptr, 0 };
+        return pos;
+    }
+
+    // moves the second half of the full child c of branch into a new node
+    // right after it
+    void splitChild(Branch *branch, int c)
+    {
+        Node *child = branch->children[c];
+        if (child->isLeaf) {
+            Leaf *left = static_cast<Leaf *>(child);
+            Leaf *newLeaf = new Leaf;
+            const int keep = LeafCapacity / 2;
+            relocate(left->keys() + keep, left->count - keep, newLeaf->keys());
+            relocate(left->values() + keep, left->count - keep, newLeaf->values());
+            newLeaf->count = left->count - keep;
+            left->count = keep;
+
+            newLeaf->prev = left;
+            newLeaf->next = left->next;
+            if (left->next)
+                left->next->prev = newLeaf;
+            else
+                last = newLeaf;
+            left->next = newLeaf;
+
+            insertChild(branch, c, Key(newLeaf->keys()[0]), newLeaf);
+        } else {
+            Branch *left = static_cast<Branch *>(child);
+            Branch *newBranch = new Branch;
+            const int keep = BranchCapacity / 2;
+            relocate(left->keys() + keep, left->count - keep - 1, newBranch->keys());
+            std::copy(left->children + keep, left->children + left->count, newBranch->children);
+            newBranch->count = left->count - keep;
+            left->count = keep;
+            // the key between the halves moves up into branch
+            Key &separator = left->keys()[keep - 1];
+            insertChild(branch, c, std::move(separator), newBranch);
+            separator.~Key();
+        }
+    }
+
+    // inserts the separator key c and the child c + 1 into branch
+    static void insertChild(Branch *branch, int c, Key &&separator, Node *child)
+    {
+        insertInto(branch->keys(), branch->count - 1, c, std::move(separator));
+        std::move_backward(branch->children + c + 1, branch->children + branch->count,
+                           branch->children + branch->count + 1);
+        branch->children[c + 1] = child;
+        ++branch->count;
+    }
+
+    // removes the key i and the child i + 1 from branch
+    static void eraseFromBranch(Branch *branch, int i)
+    {
+        eraseFrom(branch->keys(), branch->count - 1, i);
+        std::move(branch->children + i + 2, branch->children + branch->count,
+                  branch->children + i + 1);
+        --branch->count;
+    }
+
+    // merges child i + 1 of branch into child i
+    void mergeChildren(Branch *branch, int i)
+    {
+        Node *leftNode = branch->children[i];
+        Node *rightNode = branch->children[i + 1];
+        if (leftNode->isLeaf) {
+            Leaf *left = static_cast<Leaf *>(leftNode);
+            Leaf *right = static_cast<Leaf *>(rightNode);
+            relocate(right->keys(), right->count, left->keys() + left->count);
+            relocate(right->values(), right->count, left->values() + left->count);
+            left->count += right->count;
+            right->count = 0;
+            left->next = right->next;
+            if (right->next)
+                right->next->prev = left;
+            else
+                last = left;
+            delete right;
+        } else {
+            Branch *left = static_cast<Branch *>(leftNode);
+            Branch *right = static_cast<Branch *>(rightNode);
+            new (left->keys() + left->count - 1) Key(std::move(branch->keys()[i]));
+            relocate(right->keys(), right->count - 1, left->keys() + left->count);
+            std::copy(right->children, right->children + right->count,
+                      left->children + left->count);
+            left->count += right->count;
+            right->count = 0;
+            delete right;
+        }
+        eraseFromBranch(branch, i);
+    }
+
+    // moves the last element of child c - 1 to the front of child c
+    static void borrowFromLeft(Branch *branch, int c)
+    {
+        Node *node = branch->children[c];
+        Node *siblingNode = branch->children[c - 1];
+        if (node->isLeaf) {
+            Leaf *leaf = static_cast<Leaf *>(node);
+            Leaf *sibling = static_cast<Leaf *>(siblingNode);
+            const int last = sibling->count - 1;
+            insertInto(leaf->keys(), leaf->count, 0, std::move(sibling->keys()[last]));
+            insertInto(leaf->values(), leaf->count, 0, std::move(sibling->values()[last]));
+            sibling->keys()[last].~Key();
+            sibling->values()[last].~T();
+            --sibling->count;
+            ++leaf->count;
+            branch->keys()[c - 1] = leaf->keys()[0];
+        } else {
+            Branch *child = static_cast<Branch *>(node);
+            Branch *sibling = static_cast<Branch *>(siblingNode);
+            insertInto(child->keys(), child->count - 1, 0, std::move(branch->keys()[c - 1]));
+            std::move_backward(child->children, child->children + child->count,
+                               child->children + child->count + 1);
+            child->children[0] = sibling->children[sibling->count - 1];
+            ++child->count;
+            Key &lastKey = sibling->keys()[sibling->count - 2];
+            branch->keys()[c - 1] = std::move(lastKey);
+            lastKey.~Key();
+            --sibling->count;
+        }
+    }
+
+    // moves the first element of child c + 1 to the end of child c
+    static void borrowFromRight(Branch *branch, int c)
+    {
+        Node *node = branch->children[c];
+        Node *siblingNode = branch->children[c + 1];
+        if (node->isLeaf) {
+            Leaf *leaf = static_cast<Leaf *>(node);
+            Leaf *sibling = static_cast<Leaf *>(siblingNode);
+            new (leaf->keys() + leaf->count) Key(std::move(sibling->keys()[0]));
+            new (leaf->values() + leaf->count) T(std::move(sibling->values()[0]));
+            ++leaf->count;
+            eraseFrom(sibling->keys(), sibling->count, 0);
+            eraseFrom(sibling->values(), sibling->count, 0);
+            --sibling->count;
+            branch->keys()[c] = sibling->keys()[0];
+        } else {
+            Branch *child = static_cast<Branch *>(node);
+            Branch *sibling = static_cast<Branch *>(siblingNode);
+            new (child->keys() + child->count - 1) Key(std::move(branch->keys()[c]));
+            child->children[child->count] = sibling->children[0];
+            ++child->count;
+            branch->keys()[c] = std::move(sibling->keys()[0]);
+            eraseFrom(sibling->keys(), sibling->count - 1, 0);
+            std::move(sibling->children + 1, sibling->children + sibling->count,
+                      sibling->children);
+            --sibling->count;
+        }
+    }
+
+    // makes sure that child c of branch can lose an element
+    void refillChild(Branch *branch, int c)
+    {
+        if (c > 0 && !isAtMinimum(branch->children[c - 1]))
+            borrowFromLeft(branch, c);
+        else if (c + 1 < branch->count && !isAtMinimum(branch->children[c + 1]))
+            borrowFromRight(branch, c);
+        else if (c > 0)
+            mergeChildren(branch, c - 1);
+        else
+            mergeChildren(branch, c);
+    }
+
+    // Inserts key and value, or replaces the value if the key exists and
+    // overwrite is true. key and value must not refer to elements of the
+    // tree, as the nodes are reorganized before they are inserted.
+    Position insert(Key &&key, T &&value, bool overwrite)
+    {
+        if (!root)
+            root = first = last = new Leaf;
+
+        if (isFull(root)) {
+            Branch *branch = new Branch;
+            branch->children[0] = root;
+            branch->count = 1;
+            root = branch;
+            splitChild(branch, 0);
+        }
+
+        Node *node = root;
+        while (!node->isLeaf) {
+            Branch *branch = static_cast<Branch *>(node);
+            int c = childIndex(branch, key);
+            if (isFull(branch->children[c])) {
+                splitChild(branch, c);
+                if (!std::less<Key>()(key, branch->keys()[c]))
+                    ++c;
+            }
+            node = branch->children[c];
+        }
+
+        Leaf *leaf = static_cast<Leaf *>(node);
+        Key *keys = leaf->keys();
+        const int i = int(std::lower_bound(keys, keys + leaf->count, key, std::less<Key>()) - keys);
+        if (i < leaf->count && !std::less<Key>()(key, keys[i])) {
+            if (overwrite)
+                leaf->values()[i] = std::move(value);
+            return { leaf, i };
+        }
+        insertInto(keys, leaf->count, i, std::move(key));
+        insertInto(leaf->values(), leaf->count, i, std::move(value));
+        ++leaf->count;
+        ++size;
+        return { leaf, i };
+    }
+
+    // removes the element with key; key must not refer to an element of the
+    // tree, as the nodes are reorganized before it is removed
+    bool erase(const Key &key)
+    {
+        if (!root)
+            return false;
+
+        Node *node = root;
+        while (!node->isLeaf) {
+            Branch *branch = static_cast<Branch *>(node);
+            int c = childIndex(branch, key);
+            if (isAtMinimum(branch->children[c])) {
+                refillChild(branch, c);
+                if (branch == root && branch->count == 1) {
+                    // the root lost its last separator, its child takes over
+                    root = branch->children[0];
+                    branch->count = 0;
+                    delete branch;
+                    node = root;
+                    continue;
+                }
+                c = childIndex(branch, key);
+            }
+            node = branch->children[c];
+        }
+
+        Leaf *leaf = static_cast<Leaf *>(node);
+        Key *keys = leaf->keys();
+        const int i = int(std::lower_bound(keys, keys + leaf->count, key, std::less<Key>()) - keys);
+        if (i == leaf->count || std::less<Key>()(key, keys[i]))
+            return false;
+        eraseFrom(keys, leaf->count, i);
+        eraseFrom(leaf->values(), leaf->count, i);
+        --leaf->count;
+        --size;
+        if (leaf->count == 0) {
+            // only the root can run empty
+            Q_ASSERT(leaf == root);
+            clear();
+        }
+        return true;
+    }
+};
+
+} // namespace QBTreeMapPrivate
+
+template <class Key, class T>
+class QBTreeMap
+{
+    using MapData = QBTreeMapPrivate::Data<Key, T>;
+    using Leaf = typename MapData::Leaf;
+    using Position = typename MapData::Position;
+    QtPrivate::QExplicitlySharedDataPointerV2<MapData> d;
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using difference_type = qptrdiff;
+    using size_type = qsizetype;
+
+    QBTreeMap() = default;
+
+    // implicitly generated special member functions are OK!
+
+    QBTreeMap(std::initializer_list<std::pair<Key, T>> list)
+    {
+        for (auto &p : list)
+            insert(p.first, p.second);
+    }
+
+    explicit QBTreeMap(const QMap<Key, T> &map)
+    {
+        for (auto it = map.cbegin(); it != map.cend(); ++it)
+            insert(it.key(), it.value());
+    }
+
+    QMap<Key, T> toMap() const
+    {
+        QMap<Key, T> result;
+        for (auto it = cbegin(); it != cend(); ++it)
+            result.insert(result.cend(), it.key(), it.value());
+        return result;
+    }
+
+    void swap(QBTreeMap &other) noexcept { d.swap(other.d); }
+
+#ifndef Q_CLANG_QDOC
+    template <typename AKey = Key, typename AT = T> friend
+    QTypeTraits::compare_eq_result_container<QBTreeMap, AKey, AT> operator==(const QBTreeMap &lhs, const QBTreeMap &rhs)
+    {
+        if (lhs.d == rhs.d)
+            return true;
+        if (lhs.size() != rhs.size())
+            return false;
+        for (auto it = lhs.cbegin(), other = rhs.cbegin(); it != lhs.cend(); ++it, ++other) {
+            if (!(it.key() == other.key()) || !(it.value() == other.value()))
+                return false;
+        }
+        return true;
+    }
+
+    template <typename AKey = Key, typename AT = T> friend
+    QTypeTraits::compare_eq_result_container<QBTreeMap, AKey, AT> operator!=(const QBTreeMap &lhs, const QBTreeMap &rhs)
+    {
+        return !(lhs == rhs);
+    }
+#else
+    friend bool operator==(const QBTreeMap &lhs, const QBTreeMap &rhs);
+    friend bool operator!=(const QBTreeMap &lhs, const QBTreeMap &rhs);
+#endif // Q_CLANG_QDOC
+
+    size_type size() const noexcept { return d ? d->size : size_type(0); }
+    size_type count() const noexcept { return size(); }
+    bool isEmpty() const noexcept { return size() == 0; }
+    bool empty() const noexcept { return isEmpty(); }
+
+    void detach() { d.detach(); }
+    bool isDetached() const noexcept { return d ? !d.isShared() : false; }
+    bool isSharedWith(const QBTreeMap &other) const noexcept { return d == other.d; }
+
+    void clear()
+    {
+        if (!d)
+            return;
+        if (!d.isShared())
+            d->clear();
+        else
+            d.reset();
+    }
+
+    size_type remove(const Key &key)
+    {
+        if (!d || !d->find(key).leaf)
+            return 0;
+        const Key copy = key; // key may be an element of this map
+        detach();
+        return d->erase(copy) ? 1 : 0;
+    }
+
+    T take(const Key &key)
+    {
+        if (!d)
+            return T();
+        const Position pos = d->find(key);
+        if (!pos.leaf)
+            return T();
+        T result = pos.leaf->values()[pos.index];
+        remove(key);
+        return result;
+    }
+
+    bool contains(const Key &key) const
+    {
+        return d && d->find(key).leaf;
+    }
+
+    Key key(const T &value, const Key &defaultKey = Key()) const
+    {
+        for (auto it = cbegin(); it != cend(); ++it) {
+            if (it.value() == value)
+                return it.key();
+        }
+        return defaultKey;
+    }
+
+    T value(const Key &key, const T &defaultValue = T()) const
+    {
+        if (!d)
+            return defaultValue;
+        const Position pos = d->find(key);
+        return pos.leaf ? pos.leaf->values()[pos.index] : defaultValue;
+    }
+
+    T &operator[](const Key &key)
+    {
+        detach();
+        return *insertImpl(Key(key), T(), false);
+    }
+
+    T operator[](const Key &key) const { return value(key); }
+
+    QList<Key> keys() const
+    {
+        QList<Key> result;
+        result.reserve(size());
+        for (auto it = cbegin(); it != cend(); ++it)
+            result.append(it.key());
+        return result;
+    }
+
+    QList<T> values() const
+    {
+        QList<T> result;
+        result.reserve(size());
+        for (auto it = cbegin(); it != cend(); ++it)
+            result.append(it.value());
+        return result;
+    }
+
+    class const_iterator;
+
+    class iterator
+    {
+        friend class QBTreeMap;
+        friend class const_iterator;
+
+        Leaf *leaf = nullptr;
+        int i = 0;
+
+        iterator(Position pos) : leaf(pos.leaf), i(pos.index) {}
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using difference_type = qptrdiff;
+        using value_type = T;
+        using pointer = T *;
+        using reference = T &;
+
+        iterator() = default;
+
+        const Key &key() const { return leaf->keys()[i]; }
+        T &value() const { return leaf->values()[i]; }
+        T &operator*() const { return leaf->values()[i]; }
+        T *operator->() const { return leaf->values() + i; }
+        friend bool operator==(const iterator &lhs, const iterator &rhs)
+        { return lhs.leaf == rhs.leaf && lhs.i == rhs.i; }
+        friend bool operator!=(const iterator &lhs, const iterator &rhs) { return !(lhs == rhs); }
+
+        iterator &operator++()
+        {
+            if (++i == leaf->count && leaf->next) {
+                leaf = leaf->next;
+                i = 0;
+            }
+            return *this;
+        }
+        iterator operator++(int)
+        {
+            iterator r = *this;
+            ++*this;
+            return r;
+        }
+        iterator &operator--()
+        {
+            if (i == 0) {
+                leaf = leaf->prev;
+                i = leaf->count;
+            }
+            --i;
+            return *this;
+        }
+        iterator operator--(int)
+        {
+            iterator r = *this;
+            --*this;
+            return r;
+        }
+    };
+
+    class const_iterator
+    {
+        friend class QBTreeMap;
+
+        const Leaf *leaf = nullptr;
+        int i = 0;
+
+        const_iterator(Position pos) : leaf(pos.leaf), i(pos.index) {}
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using difference_type = qptrdiff;
+        using value_type = T;
+        using pointer = const T *;
+        using reference = const T &;
+
+        const_iterator() = default;
+        Q_IMPLICIT const_iterator(const iterator &o) : leaf(o.leaf), i(o.i) {}
+
+        const Key &key() const { return leaf->keys()[i]; }
+        const T &value() const { return leaf->values()[i]; }
+        const T &operator*() const { return leaf->values()[i]; }
+        const T *operator->() const { return leaf->values() + i; }
+        friend bool operator==(const const_iterator &lhs, const const_iterator &rhs)
+        { return lhs.leaf == rhs.leaf && lhs.i == rhs.i; }
+        friend bool operator!=(const const_iterator &lhs, const const_iterator &rhs)
+        { return !(lhs == rhs); }
+
+        const_iterator &operator++()
+        {
+            if (++i == leaf->count && leaf->next) {
+                leaf = leaf->next;
+                i = 0;
+            }
+            return *this;
+        }
+        const_iterator operator++(int)
+        {
+            const_iterator r = *this;
+            ++*this;
+            return r;
+        }
+        const_iterator &operator--()
+        {
+            if (i == 0) {
+                leaf = leaf->prev;
+                i = leaf->count;
+            }
+            --i;
+            return *this;
+        }
+        const_iterator operator--(int)
+        {
+            const_iterator r = *this;
+            --*this;
+            return r;
+        }
+    };
+
+    using Iterator = iterator;
+    using ConstIterator = const_iterator;
+
+    iterator begin() { detach(); return iterator(d->begin()); }
+    const_iterator begin() const { return d ? const_iterator(d->begin()) : const_iterator(); }
+    const_iterator constBegin() const { return begin(); }
+    const_iterator cbegin() const { return begin(); }
+    iterator end() { detach(); return iterator(d->end()); }
+    const_iterator end() const { return d ? const_iterator(d->end()) : const_iterator(); }
+    const_iterator constEnd() const { return end(); }
+    const_iterator cend() const { return end(); }
+
+    iterator erase(const_iterator it)
+    {
+        Q_ASSERT(it != cend());
+        const Key key = it.key(); // it may be invalidated by the detach
+        detach();
+        d->erase(key);
+        return iterator(d->lowerBound(key));
+    }
+
+    T &first() { Q_ASSERT(!isEmpty()); return *begin(); }
+    const T &first() const { Q_ASSERT(!isEmpty()); return *begin(); }
+    const Key &firstKey() const { Q_ASSERT(!isEmpty()); return begin().key(); }
+    T &last() { Q_ASSERT(!isEmpty()); return *(--end()); }
+    const T &last() const { Q_ASSERT(!isEmpty()); return *(--end()); }
+    const Key &lastKey() const { Q_ASSERT(!isEmpty()); return (--end()).key(); }
+
+    iterator find(const Key &key)
+    {
+        detach();
+        const Position pos = d->find(key);
+        return pos.leaf ? iterator(pos) : end();
+    }
+
+    const_iterator find(const Key &key) const
+    {
+        if (!d)
+            return const_iterator();
+        const Position pos = d->find(key);
+        return pos.leaf ? const_iterator(pos) : end();
+    }
+
+    const_iterator constFind(const Key &key) const { return find(key); }
+
+    iterator lowerBound(const Key &key)
+    {
+        detach();
+        return iterator(d->lowerBound(key));
+    }
+
+    const_iterator lowerBound(const Key &key) const
+    {
+        return d ? const_iterator(d->lowerBound(key)) : const_iterator();
+    }
+
+    iterator upperBound(const Key &key)
+    {
+        detach();
+        return iterator(d->upperBound(key));
+    }
+
+    const_iterator upperBound(const Key &key) const
+    {
+        return d ? const_iterator(d->upperBound(key)) : const_iterator();
+    }
+
+    iterator insert(const Key &key, const T &value)
+    {
+        // copy key and value first, they may be elements of this map
+        Key k(key);
+        T v(value);
+        detach();
+        return insertImpl(std::move(k), std::move(v), true);
+    }
+
+    void insert(const QBTreeMap &map)
+    {
+        if (map.isEmpty() || map.d == d)
+            return;
+        for (auto it = map.cbegin(); it != map.cend(); ++it)
+            insert(it.key(), it.value());
+    }
+
+private:
+    iterator insertImpl(Key &&key, T &&value, bool overwrite)
+    {
+        return iterator(d->insert(std::move(key), std::move(value), overwrite));
+    }
+};
+
+template <typename Key, typename T>
+void swap(QBTreeMap<Key, T> &lhs, QBTreeMap<Key, T> &rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+QT_END_NAMESPACE
+
+#endif // QBTREEMAP_H
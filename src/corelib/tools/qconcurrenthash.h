@@ -0,0 +1,284 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QCONCURRENTHASH_H
+#define QCONCURRENTHASH_H
+
+#include <QtCore/qhash.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qreadwritelock.h>
+
+#include <iterator>
+#include <limits>
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+template <typename Key, typename T>
+class QConcurrentHash
+{
+    // Each shard sits on cache lines of its own, so that threads working on
+    // different shards don't contend for the same line.
+    struct alignas(64) Shard
+    {
+        mutable QReadWriteLock lock;
+        QHash<Key, T> hash;
+    };
+
+    // The shard is selected by the top bits of the hash, QHash uses the low
+    // bits to select the bucket inside the shard.
+    static size_t shardIndex(const Key &key, size_t seed, size_t mask)
+    {
+        const size_t hash = QHashPrivate::calculateHash(key, seed);
+        return (hash >> (std::numeric_limits<size_t>::digits - MaxShardBits)) & mask;
+    }
+
+    Shard &shardFor(const Key &key) const
+    { return shards[shardIndex(key, seed, shardMask)]; }
+
+public:
+    enum : qsizetype {
+        DefaultShardCount = 16,
+        MaxShardBits = 8,
+        MaxShardCount = qsizetype(1) << MaxShardBits
+    };
+
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef qsizetype size_type;
+
+    class Snapshot
+    {
+        friend class QConcurrentHash;
+
+        QList<QHash<Key, T>> hashes;
+        size_t seed = 0;
+
+        const QHash<Key, T> &hashFor(const Key &key) const
+        { return hashes.at(shardIndex(key, seed, size_t(hashes.size() - 1))); }
+
+    public:
+        class const_iterator
+        {
+            friend class Snapshot;
+
+            const QHash<Key, T> *hash = nullptr;
+            const QHash<Key, T> *hashesEnd = nullptr;
+            typename QHash<Key, T>::const_iterator it;
+
+            const_iterator(const QHash<Key, T> *hash, const QHash<Key, T> *hashesEnd)
+                : hash(hash), hashesEnd(hashesEnd)
+            {
+                if (hash != hashesEnd)
+                    it = hash->cbegin();
+                skipEmpty();
+            }
+
+            void skipEmpty()
+            {
+                while (hash != hashesEnd && it == hash->cend()) {
+                    if (++hash != hashesEnd)
+                        it = hash->cbegin();
+                }
+            }
+
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef qptrdiff difference_type;
+            typedef T value_type;
+            typedef const T *pointer;
+            typedef const T &reference;
+
+            const_iterator() = default;
+
+            const Key &key() const noexcept { return it.key(); }
+            const T &value() const noexcept { return it.value(); }
+            const T &operator*() const noexcept { return it.value(); }
+            const T *operator->() const noexcept { return &it.value(); }
+            bool operator==(const const_iterator &other) const noexcept
+            { return hash == other.hash && (hash == hashesEnd || it == other.it); }
+            bool operator!=(const const_iterator &other) const noexcept
+            { return !(*this == other); }
+
+            const_iterator &operator++()
+            {
+                ++it;
+                skipEmpty();
+                return *this;
+            }
+            const_iterator operator++(int)
+            {
+                const_iterator r = *this;
+                ++*this;
+                return r;
+            }
+        };
+        typedef const_iterator ConstIterator;
+
+        Snapshot() = default;
+
+        qsizetype size() const noexcept
+        {
+            qsizetype n = 0;
+            for (const QHash<Key, T> &hash : hashes)
+                n += hash.size();
+            return n;
+        }
+        qsizetype count() const noexcept { return size(); }
+        bool isEmpty() const noexcept { return size() == 0; }
+
+        bool contains(const Key &key) const noexcept
+        { return !hashes.isEmpty() && hashFor(key).contains(key); }
+        T value(const Key &key) const noexcept
+        { return hashes.isEmpty() ? T() : hashFor(key).value(key); }
+        T value(const Key &key, const T &defaultValue) const noexcept
+        { return hashes.isEmpty() ? defaultValue : hashFor(key).value(key, defaultValue); }
+
+        const_iterator begin() const noexcept { return cbegin(); }
+        const_iterator cbegin() const noexcept
+        { return const_iterator(hashes.constData(), hashes.constData() + hashes.size()); }
+        const_iterator constBegin() const noexcept { return cbegin(); }
+        const_iterator end() const noexcept { return cend(); }
+        const_iterator cend() const noexcept
+        {
+            const QHash<Key, T> *hashesEnd = hashes.constData() + hashes.size();
+            return const_iterator(hashesEnd, hashesEnd);
+        }
+        const_iterator constEnd() const noexcept { return cend(); }
+
+        QHash<Key, T> toHash() const
+        {
+            QHash<Key, T> result;
+            result.reserve(size());
+            for (const QHash<Key, T> &hash : hashes) {
+                for (auto it = hash.cbegin(); it != hash.cend(); ++it)
+                    result.insert(it.key(), it.value());
+            }
+            return result;
+        }
+    };
+
+    explicit QConcurrentHash(qsizetype shardCount = DefaultShardCount)
+        : seed(QHashSeed::globalSeed())
+    {
+        Q_ASSERT(shardCount > 0 && shardCount <= MaxShardCount);
+        shardCount = qBound(qsizetype(1), shardCount, qsizetype(MaxShardCount));
+        size_t count = 1;
+        while (count < size_t(shardCount))
+            count <<= 1;
+        shards.reset(new Shard[count]);
+        shardMask = count - 1;
+    }
+    ~QConcurrentHash() = default;
+
+    qsizetype shardCount() const noexcept { return qsizetype(shardMask + 1); }
+
+    qsizetype size() const
+    {
+        qsizetype n = 0;
+        for (size_t i = 0; i <= shardMask; ++i) {
+            QReadLocker locker(&shards[i].lock);
+            n += shards[i].hash.size();
+        }
+        return n;
+    }
+    qsizetype count() const { return size(); }
+    bool isEmpty() const { return size() == 0; }
+
+    void clear()
+    {
+        for (size_t i = 0; i <= shardMask; ++i) {
+            // destroy the elements outside of the lock
+            QHash<Key, T> old;
+            QWriteLocker locker(&shards[i].lock);
+            old.swap(shards[i].hash);
+        }
+    }
+
+    void reserve(qsizetype size)
+    {
+        const qsizetype count = shardCount();
+        const qsizetype perShard = (size + count - 1) / count;
+        for (size_t i = 0; i <= shardMask; ++i) {
+            QWriteLocker locker(&shards[i].lock);
+            shards[i].hash.reserve(perShard);
+        }
+    }
+
+    bool contains(const Key &key) const
+    {
+        const Shard &shard = shardFor(key);
+        QReadLocker locker(&shard.lock);
+        return shard.hash.contains(key);
+    }
+
+    T value(const Key &key) const
+    {
+        const Shard &shard = shardFor(key);
+        QReadLocker locker(&shard.lock);
+        return shard.hash.value(key);
+    }
+
+    T value(const Key &key, const T &defaultValue) const
+    {
+        const Shard &shard = shardFor(key);
+        QReadLocker locker(&shard.lock);
+        return shard.hash.value(key, defaultValue);
+    }
+
+    void insert(const Key &key, const T &value)
+    {
+        Shard &shard = shardFor(key);
+        QWriteLocker locker(&shard.lock);
+        shard.hash.insert(key, value);
+    }
+
+    bool tryInsert(const Key &key, const T &value)
+    {
+        Shard &shard = shardFor(key);
+        QWriteLocker locker(&shard.lock);
+        if (shard.hash.contains(key))
+            return false;
+        shard.hash.emplace(key, value);
+        return true;
+    }
+
+    bool remove(const Key &key)
+    {
+        Shard &shard = shardFor(key);
+        QWriteLocker locker(&shard.lock);
+        return shard.hash.remove(key);
+    }
+
+    T take(const Key &key)
+    {
+        Shard &shard = shardFor(key);
+        QWriteLocker locker(&shard.lock);
+        return shard.hash.take(key);
+    }
+
+    Snapshot snapshot() const
+    {
+        Snapshot s;
+        s.seed = seed;
+        s.hashes.reserve(shardCount());
+        for (size_t i = 0; i <= shardMask; ++i) {
+            QReadLocker locker(&shards[i].lock);
+            s.hashes.append(shards[i].hash);
+        }
+        return s;
+    }
+
+    QHash<Key, T> toHash() const { return snapshot().toHash(); }
+
+private:
+    Q_DISABLE_COPY_MOVE(QConcurrentHash)
+
+    std::unique_ptr<Shard[]> shards;
+    size_t shardMask = 0;
+    size_t seed = 0;
+};
+
+QT_END_NAMESPACE
+
+#endif // QCONCURRENTHASH_H
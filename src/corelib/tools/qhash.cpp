@@ -750,17 +750,27 @@ aeshash256(const uchar *p, size_t len, size_t seed, size_t seed2) noexcept
     if (len <= sizeof(__m256i))
         return aeshash128_16to32(state.state0, state.state1(), src, srcend);
 
-    return aeshash256_ge32(state.state0_256(), p, len);
+    size_t hash = aeshash256_ge32(state.state0_256(), p, len);
+    // The compiler doesn't clear the upper halves of the YMM registers when
+    // returning from functions that take 256-bit arguments. Leaving them dirty
+    // slows down the SSE code that usually runs right after hashing, such as
+    // the lookups in QHash.
+    _mm256_zeroupper();
+    return hash;
 }
 
 static size_t QT_FUNCTION_TARGET(VAES_AVX512)
 aeshash256_avx256(const uchar *p, size_t len, size_t seed, size_t seed2) noexcept
 {
     AESHashSeed state(seed, seed2);
+    size_t hash;
     if (len <= sizeof(__m256i))
-        return aeshash256_lt32_avx256(state.state0_256(), p, len);
-
-    return aeshash256_ge32(state.state0_256(), p, len);
+        hash = aeshash256_lt32_avx256(state.state0_256(), p, len);
+    else
+        hash = aeshash256_ge32(state.state0_256(), p, len);
+    // see aeshash256()
+    _mm256_zeroupper();
+    return hash;
 }
 #  endif // VAES
 
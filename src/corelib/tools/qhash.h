@@ -5,12 +5,14 @@
 #ifndef QHASH_H
 #define QHASH_H
 
+#include <QtCore/qalgorithms.h>
 #include <QtCore/qcontainertools_impl.h>
 #include <QtCore/qhashfunctions.h>
 #include <QtCore/qiterator.h>
 #include <QtCore/qlist.h>
 #include <QtCore/qmath.h>
 #include <QtCore/qrefcount.h>
+#include <QtCore/qsimd.h>
 
 #include <initializer_list>
 #include <functional> // for std::hash
@@ -218,13 +220,75 @@ constexpr bool isRelocatable()
     return QTypeInfo<typename Node::KeyType>::isRelocatable && QTypeInfo<typename Node::ValueType>::isRelocatable;
 }
 
+// Keys that are as cheap to compare as a control byte are compared directly while probing, as
+// filtering the buckets by their hash fragment first would only add work.
+template <typename Key>
+constexpr bool isCheapToCompare()
+{
+    return std::is_arithmetic_v<Key> || std::is_enum_v<Key> || std::is_pointer_v<Key>;
+}
+
 struct SpanConstants {
     static constexpr size_t SpanShift = 7;
     static constexpr size_t NEntries = (1 << SpanShift);
     static constexpr size_t LocalBucketMask = (NEntries - 1);
     static constexpr size_t UnusedEntry = 0xff;
+    static constexpr size_t GroupSize = 16;
+    static constexpr size_t GroupMask = (GroupSize - 1);
 
     static_assert ((NEntries & LocalBucketMask) == 0, "NEntries must be a power of two.");
+    static_assert ((NEntries % GroupSize) == 0, "A Span must consist of whole groups.");
+
+    // The fragment of the hash stored in the control byte of a bucket. It is taken from the top
+    // bits of the hash after a multiplicative mix, as the low bits select the bucket and are
+    // therefore often the same for all nodes in a probe sequence. It never equals UnusedEntry.
+    static constexpr unsigned char hashFragment(size_t hash) noexcept
+    {
+        constexpr size_t Multiplier = sizeof(size_t) == 8 ? size_t(0x9e3779b97f4a7c15ULL)
+                                                          : size_t(0x9e3779b9U);
+        return static_cast<unsigned char>((hash * Multiplier) >> (std::numeric_limits<size_t>::digits - 7));
+    }
+};
+
+// Returns a mask with bit i set if group[i] == byte, for the GroupSize bytes starting at group.
+inline uint matchGroup(const unsigned char *group, unsigned char byte) noexcept
+{
+#if QT_COMPILER_USES(sse2)
+    const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(group));
+    return uint(_mm_movemask_epi8(_mm_cmpeq_epi8(data, _mm_set1_epi8(char(byte)))));
+#elif QT_COMPILER_USES(neon) && defined(Q_PROCESSOR_ARM_64)
+    static const uint8_t laneBits[16] = { 1, 2, 4, 8, 16, 32, 64, 128,
+                                          1, 2, 4, 8, 16, 32, 64, 128 };
+    const uint8x16_t matches = vandq_u8(vceqq_u8(vld1q_u8(group), vdupq_n_u8(byte)),
+                                        vld1q_u8(laneBits));
+    return uint(vaddv_u8(vget_low_u8(matches))) | (uint(vaddv_u8(vget_high_u8(matches))) << 8);
+#else
+    uint mask = 0;
+    for (size_t i = 0; i < SpanConstants::GroupSize; ++i)
+        mask |= uint(group[i] == byte) << i;
+    return mask;
+#endif
+}
+
+// The control bytes of a Span, for keys that are not cheap to compare
+template <bool HasControlBytes>
+struct SpanControlBytes
+{
+    unsigned char control[SpanConstants::NEntries];
+
+    SpanControlBytes() noexcept
+    {
+        memset(control, SpanConstants::UnusedEntry, sizeof(control));
+    }
+    unsigned char controlByte(size_t i) const noexcept { return control[i]; }
+    void setControlByte(size_t i, unsigned char c) noexcept { control[i] = c; }
+};
+
+template <>
+struct SpanControlBytes<false>
+{
+    unsigned char controlByte(size_t) const noexcept { return 0; }
+    void setControlByte(size_t, unsigned char) noexcept {}
 };
 
 // Regular hash tables consist of a list of buckets that can store Nodes. But simply allocating one large array of buckets
@@ -235,8 +299,15 @@ struct SpanConstants {
 // actual storage space for the Nodes (the 'entries' member) or 0xff (UnusedEntry) to flag that the bucket is empty.
 // As we have only 128 entries per Span, the offset array can be represented using an unsigned char. This trick makes the hash
 // table have a very small memory overhead compared to many other implementations.
+//
+// Unless the keys are cheap to compare, each bucket also has a control byte that holds 7 bits of the hash of its Node,
+// or UnusedEntry if it is empty. Lookups compare the control bytes of a whole group of GroupSize buckets at once with
+// the fragment of the hash they search for, and only compare the keys of the Nodes whose fragment matches.
 template<typename Node>
-struct Span {
+struct Span : SpanControlBytes<!isCheapToCompare<typename Node::KeyType>()> {
+    using SpanControlBytes<!isCheapToCompare<typename Node::KeyType>()>::controlByte;
+    using SpanControlBytes<!isCheapToCompare<typename Node::KeyType>()>::setControlByte;
+
     // Entry is a slot available for storing a Node. The Span holds a pointer to
     // an array of Entries. Upon construction of the array, those entries are
     // unused, and nextFree() is being used to set up a singly linked list
@@ -275,15 +346,17 @@ struct Span {
             entries = nullptr;
         }
     }
-    Node *insert(size_t i)
+    Node *insert(size_t i, unsigned char fragment)
     {
         Q_ASSERT(i < SpanConstants::NEntries);
         Q_ASSERT(offsets[i] == SpanConstants::UnusedEntry);
+        Q_ASSERT(fragment != SpanConstants::UnusedEntry);
         if (nextFree == allocated)
             addStorage();
         unsigned char entry = nextFree;
         Q_ASSERT(entry < allocated);
         nextFree = entries[entry].nextFree();
+        setControlByte(i, fragment);
         offsets[i] = entry;
         return &entries[entry].node();
     }
@@ -293,6 +366,7 @@ struct Span {
         Q_ASSERT(offsets[bucket] != SpanConstants::UnusedEntry);
 
         unsigned char entry = offsets[bucket];
+        setControlByte(bucket, SpanConstants::UnusedEntry);
         offsets[bucket] = SpanConstants::UnusedEntry;
 
         entries[entry].node().~Node();
@@ -337,7 +411,9 @@ struct Span {
     {
         Q_ASSERT(offsets[from] != SpanConstants::UnusedEntry);
         Q_ASSERT(offsets[to] == SpanConstants::UnusedEntry);
+        setControlByte(to, controlByte(from));
         offsets[to] = offsets[from];
+        setControlByte(from, SpanConstants::UnusedEntry);
         offsets[from] = SpanConstants::UnusedEntry;
     }
     void moveFromSpan(Span &fromSpan, size_t fromIndex, size_t to) noexcept(std::is_nothrow_move_constructible_v<Node>)
@@ -349,11 +425,13 @@ struct Span {
         if (nextFree == allocated)
             addStorage();
         Q_ASSERT(nextFree < allocated);
+        setControlByte(to, fromSpan.controlByte(fromIndex));
         offsets[to] = nextFree;
         Entry &toEntry = entries[nextFree];
         nextFree = toEntry.nextFree();
 
         size_t fromOffset = fromSpan.offsets[fromIndex];
+        fromSpan.setControlByte(fromIndex, SpanConstants::UnusedEntry);
         fromSpan.offsets[fromIndex] = SpanConstants::UnusedEntry;
         Entry &fromEntry = fromSpan.entries[fromOffset];
 
@@ -416,16 +494,18 @@ struct Span {
 namespace GrowthPolicy {
 inline constexpr size_t maxNumBuckets() noexcept
 {
-    // ensure the size of a Span does not depend on the template parameters
+    // ensure the size of a Span only depends on whether it has control bytes
     using Node1 = Node<int, int>;
     using Node2 = Node<char, void *>;
     using Node3 = Node<qsizetype, QHashDummyValue>;
+    using Node4 = Node<QHashDummyValue, int>;
     static_assert(sizeof(Span<Node1>) == sizeof(Span<Node2>));
     static_assert(sizeof(Span<Node1>) == sizeof(Span<Node3>));
+    static_assert(sizeof(Span<Node4>) == sizeof(Span<Node1>) + SpanConstants::NEntries);
 
     // Maximum is 2^31-1 or 2^63-1 bytes (limited by qsizetype and ptrdiff_t)
     size_t max = (std::numeric_limits<ptrdiff_t>::max)();
-    return max / sizeof(Span<Node1>) * SpanConstants::NEntries;
+    return max / sizeof(Span<Node4>) * SpanConstants::NEntries;
 }
 inline constexpr size_t bucketsForCapacity(size_t requestedCapacity) noexcept
 {
@@ -504,9 +584,9 @@ struct Data
         {
             return &span->at(index);
         }
-        Node *insert() const
+        Node *insert(unsigned char fragment) const
         {
-            return span->insert(index);
+            return span->insert(index, fragment);
         }
 
     private:
@@ -547,7 +627,7 @@ struct Data
                 const Node &n = span.at(index);
                 auto it = resized ? findBucket(n.key) : Bucket { spans + s, index };
                 Q_ASSERT(it.isUnused());
-                Node *newNode = it.insert();
+                Node *newNode = it.insert(span.controlByte(index));
                 new (newNode) Node(n);
             }
         }
@@ -634,7 +714,7 @@ struct Data
                 Node &n = span.at(index);
                 auto it = findBucket(n.key);
                 Q_ASSERT(it.isUnused());
-                Node *newNode = it.insert();
+                Node *newNode = it.insert(span.controlByte(index));
                 new (newNode) Node(std::move(n));
             }
             span.freeData();
@@ -660,22 +740,60 @@ struct Data
     }
 
     Bucket findBucket(const Key &key) const noexcept
+    {
+        return findBucket(key, QHashPrivate::calculateHash(key, seed));
+    }
+
+    Bucket findBucket(const Key &key, size_t hash) const noexcept
     {
         Q_ASSERT(numBuckets > 0);
-        size_t hash = QHashPrivate::calculateHash(key, seed);
         Bucket bucket(this, GrowthPolicy::bucketForHash(numBuckets, hash));
-        // loop over the buckets until we find the entry we search for
-        // or an empty slot, in which case we know the entry doesn't exist
-        while (true) {
-            size_t offset = bucket.offset();
-            if (offset == SpanConstants::UnusedEntry) {
-                return bucket;
-            } else {
-                Node &n = bucket.nodeAtOffset(offset);
-                if (qHashEquals(n.key, key))
+        if constexpr (isCheapToCompare<Key>()) {
+            // loop over the buckets until we find the entry we search for
+            // or an empty slot, in which case we know the entry doesn't exist
+            while (true) {
+                size_t offset = bucket.offset();
+                if (offset == SpanConstants::UnusedEntry) {
                     return bucket;
+                } else {
+                    Node &n = bucket.nodeAtOffset(offset);
+                    if (qHashEquals(n.key, key))
+                        return bucket;
+                }
+                bucket.advanceWrapped(this);
+            }
+        } else {
+            const unsigned char fragment = SpanConstants::hashFragment(hash);
+            size_t group = bucket.index & ~SpanConstants::GroupMask;
+            // ignore the buckets of the first group that come before the one we start at
+            uint skipped = (1u << (bucket.index & SpanConstants::GroupMask)) - 1;
+            // loop over the groups of buckets until we find the entry we search for
+            // or an empty slot, in which case we know the entry doesn't exist
+            while (true) {
+                const unsigned char *control = bucket.span->control + group;
+                // Candidates after an unused bucket can't hold the key, but as the
+                // key is unique, comparing them anyway is harmless and keeps the
+                // path short for the common case of a hit.
+                uint candidates = matchGroup(control, fragment) & ~skipped;
+                while (candidates) {
+                    bucket.index = group + qCountTrailingZeroBits(candidates);
+                    if (qHashEquals(bucket.node()->key, key))
+                        return bucket;
+                    candidates &= candidates - 1;
+                }
+                if (uint unused = matchGroup(control, SpanConstants::UnusedEntry) & ~skipped) {
+                    bucket.index = group + qCountTrailingZeroBits(unused);
+                    return bucket;
+                }
+                skipped = 0;
+                group += SpanConstants::GroupSize;
+                if (group == SpanConstants::NEntries) {
+                    group = 0;
+                    ++bucket.span;
+                    if (bucket.span - spans == ptrdiff_t(numBuckets >> SpanConstants::SpanShift))
+                        bucket.span = spans;
+                }
             }
-            bucket.advanceWrapped(this);
         }
     }
 
@@ -684,18 +802,45 @@ struct Data
         Q_ASSERT(numBuckets > 0);
         size_t hash = QHashPrivate::calculateHash(key, seed);
         Bucket bucket(this, GrowthPolicy::bucketForHash(numBuckets, hash));
-        // loop over the buckets until we find the entry we search for
-        // or an empty slot, in which case we know the entry doesn't exist
-        while (true) {
-            size_t offset = bucket.offset();
-            if (offset == SpanConstants::UnusedEntry) {
-                return nullptr;
-            } else {
-                Node &n = bucket.nodeAtOffset(offset);
-                if (qHashEquals(n.key, key))
-                    return &n;
+        if constexpr (isCheapToCompare<Key>()) {
+            // loop over the buckets until we find the entry we search for
+            // or an empty slot, in which case we know the entry doesn't exist
+            while (true) {
+                size_t offset = bucket.offset();
+                if (offset == SpanConstants::UnusedEntry) {
+                    return nullptr;
+                } else {
+                    Node &n = bucket.nodeAtOffset(offset);
+                    if (qHashEquals(n.key, key))
+                        return &n;
+                }
+                bucket.advanceWrapped(this);
+            }
+        } else {
+            // same as findBucket(), but returns the node directly
+            const unsigned char fragment = SpanConstants::hashFragment(hash);
+            size_t group = bucket.index & ~SpanConstants::GroupMask;
+            uint skipped = (1u << (bucket.index & SpanConstants::GroupMask)) - 1;
+            while (true) {
+                const unsigned char *control = bucket.span->control + group;
+                uint candidates = matchGroup(control, fragment) & ~skipped;
+                while (candidates) {
+                    Node &n = bucket.span->at(group + qCountTrailingZeroBits(candidates));
+                    if (qHashEquals(n.key, key))
+                        return &n;
+                    candidates &= candidates - 1;
+                }
+                if (matchGroup(control, SpanConstants::UnusedEntry) & ~skipped)
+                    return nullptr;
+                skipped = 0;
+                group += SpanConstants::GroupSize;
+                if (group == SpanConstants::NEntries) {
+                    group = 0;
+                    ++bucket.span;
+                    if (bucket.span - spans == ptrdiff_t(numBuckets >> SpanConstants::SpanShift))
+                        bucket.span = spans;
+                }
             }
-            bucket.advanceWrapped(this);
         }
     }
 
@@ -708,18 +853,19 @@ struct Data
     InsertionResult findOrInsert(const Key &key) noexcept
     {
         Bucket it(static_cast<Span *>(nullptr), 0);
+        const size_t hash = QHashPrivate::calculateHash(key, seed);
         if (numBuckets > 0) {
-            it = findBucket(key);
+            it = findBucket(key, hash);
             if (!it.isUnused())
                 return { it.toIterator(this), true };
         }
         if (shouldGrow()) {
             rehash(size + 1);
-            it = findBucket(key); // need to get a new iterator after rehashing
+            it = findBucket(key, hash); // need to get a new iterator after rehashing
         }
         Q_ASSERT(it.span != nullptr);
         Q_ASSERT(it.isUnused());
-        it.insert();
+        it.insert(SpanConstants::hashFragment(hash));
         ++size;
         return { it.toIterator(this), false };
     }
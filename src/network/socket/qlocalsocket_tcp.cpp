@@ -279,6 +279,15 @@ qint64 QLocalSocket::skipData(qint64 maxSize)
     return d_func()->tcpSocket->skip(maxSize);
 }
 
+QByteArrayView QLocalSocketPrivate::peekChunk()
+{
+    // The data is buffered by the wrapped socket, so hand out a view of its
+    // buffer as long as ours isn't needed.
+    if (buffer.isEmpty() && !transactionStarted && (openMode & QIODevice::Text) == 0)
+        return tcpSocket->peekChunk();
+    return QIODevicePrivate::peekChunk();
+}
+
 qint64 QLocalSocket::writeData(const char *data, qint64 c)
 {
     Q_D(QLocalSocket);
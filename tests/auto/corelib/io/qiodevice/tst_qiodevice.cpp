@@ -34,6 +34,9 @@ private slots:
     void skip();
     void skipAfterPeek_data();
     void skipAfterPeek();
+    void peekChunk_data();
+    void peekChunk();
+    void peekChunkInTransaction();
 
     void transaction_data();
     void transaction();
@@ -711,6 +714,86 @@ void tst_QIODevice::skipAfterPeek()
     QCOMPARE(readSoFar, data.size());
 }
 
+void tst_QIODevice::peekChunk_data()
+{
+    QTest::addColumn<QString>("deviceType");
+
+    QTest::newRow("sequential") << QStringLiteral("sequential");
+    QTest::newRow("random-access") << QStringLiteral("random-access");
+    QTest::newRow("QBuffer") << QStringLiteral("QBuffer");
+}
+
+void tst_QIODevice::peekChunk()
+{
+    QFETCH(QString, deviceType);
+
+    QByteArray data;
+    for (int i = 0; i < 2000; ++i)
+        data += "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+    QScopedPointer<QIODevice> dev;
+    if (deviceType == "sequential")
+        dev.reset(new SequentialReadBuffer(&data));
+    else if (deviceType == "random-access")
+        dev.reset(new RandomAccessBuffer(data.constData()));
+    else
+        dev.reset(new QBuffer(&data));
+
+    const QByteArray warning = QByteArray("QIODevice::peekChunk (")
+            + dev->metaObject()->className() + "): device not open";
+    QTest::ignoreMessage(QtWarningMsg, warning.constData());
+    QVERIFY(dev->peekChunk().isEmpty());
+    QVERIFY(dev->open(QIODevice::ReadOnly));
+
+    QByteArrayView chunk = dev->peekChunk();
+    QVERIFY(!chunk.isEmpty());
+    QVERIFY(data.startsWith(chunk));
+    QCOMPARE(dev->peek(chunk.size()), chunk);
+    const QByteArray firstChunk = dev->read(chunk.size());
+    QCOMPARE(firstChunk, chunk);
+    // reading a whole chunk from the QIODevice buffer shares it
+    if (deviceType != "QBuffer")
+        QVERIFY(firstChunk.constData() == chunk.data());
+    else
+        QVERIFY(chunk.data() == data.constData());
+
+    // consume the rest in steps that don't match the chunk boundaries
+    QByteArray result = firstChunk;
+    while (!(chunk = dev->peekChunk()).isEmpty()) {
+        QCOMPARE(chunk, QByteArrayView(data).sliced(result.size(), chunk.size()));
+        const qsizetype consumed = qMin(chunk.size(), qsizetype(1000));
+        result += chunk.first(consumed);
+        QCOMPARE(dev->skip(consumed), qint64(consumed));
+    }
+    QCOMPARE(result, data);
+    QVERIFY(dev->atEnd());
+}
+
+void tst_QIODevice::peekChunkInTransaction()
+{
+    QByteArray data;
+    for (int i = 0; i < 1000; ++i)
+        data += "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+    SequentialReadBuffer dev(&data);
+    QVERIFY(dev.open(QIODevice::ReadOnly));
+    dev.startTransaction();
+
+    QByteArrayView chunk = dev.peekChunk();
+    QVERIFY(chunk.size() > 10);
+    QVERIFY(data.startsWith(chunk));
+    QCOMPARE(dev.skip(10), qint64(10));
+    chunk = dev.peekChunk();
+    QVERIFY(QByteArrayView(data).sliced(10).startsWith(chunk));
+
+    // skipping past the buffered data reads more into the buffer
+    QCOMPARE(dev.skip(data.size()), qint64(data.size() - 10));
+    QVERIFY(dev.peekChunk().isEmpty());
+
+    dev.rollbackTransaction();
+    QCOMPARE(dev.readAll(), data);
+}
+
 void tst_QIODevice::transaction_data()
 {
     QTest::addColumn<bool>("sequential");
@@ -509,6 +509,83 @@ void tst_QCoreApplication::deliverInDefinedOrder()
 }
 #endif // QT_CONFIG(thread)
 
+#if QT_CONFIG(cxx11_future)
+class OrderEvent : public QEvent
+{
+public:
+    explicit OrderEvent(int value) : QEvent(QEvent::User), value(value) { }
+    const int value;
+};
+
+class EventOrderObject : public QObject
+{
+public:
+    QList<int> received;
+
+    bool event(QEvent *event) override
+    {
+        if (event->type() == QEvent::User) {
+            received.append(static_cast<OrderEvent *>(event)->value);
+            return true;
+        }
+        return QObject::event(event);
+    }
+};
+
+// queued calls bypass the lock of the receiving thread's event queue
+void tst_QCoreApplication::queuedCallsFromThread()
+{
+    int argc = 1;
+    char *argv[] = { const_cast<char*>(QTest::currentAppName()) };
+    TestApplication app(argc, argv);
+
+    // interleaved with events posted by the same thread, they keep their order
+    EventOrderObject receiver;
+    constexpr int count = 1000;
+    std::unique_ptr<QThread> thread(QThread::create([&receiver] {
+        for (int i = 0; i < count; i += 2) {
+            QMetaObject::invokeMethod(&receiver, [&receiver, i] { receiver.received.append(i); },
+                                      Qt::QueuedConnection);
+            QCoreApplication::postEvent(&receiver, new OrderEvent(i + 1));
+        }
+    }));
+    thread->start();
+    QVERIFY(thread->wait());
+    QCoreApplication::sendPostedEvents();
+    QCOMPARE(receiver.received.size(), count);
+    for (int i = 0; i < count; ++i)
+        QCOMPARE(receiver.received.at(i), i);
+
+    // they can be removed before they are delivered
+    QAtomicInt calls;
+    auto callTenTimes = [&calls](QObject *receiver) {
+        for (int i = 0; i < 10; ++i)
+            QMetaObject::invokeMethod(receiver, [&calls] { ++calls; }, Qt::QueuedConnection);
+    };
+    thread.reset(QThread::create(callTenTimes, &receiver));
+    thread->start();
+    QVERIFY(thread->wait());
+    QCoreApplication::removePostedEvents(&receiver, QEvent::MetaCall);
+    QCoreApplication::sendPostedEvents();
+    QCOMPARE(calls.loadRelaxed(), 0);
+
+    // and they follow the receiver to another thread
+    QThread target;
+    auto movedReceiver = new QObject;
+    thread.reset(QThread::create(callTenTimes, movedReceiver));
+    thread->start();
+    QVERIFY(thread->wait());
+    movedReceiver->moveToThread(&target);
+    QCoreApplication::sendPostedEvents();
+    QCOMPARE(calls.loadRelaxed(), 0);
+    target.start();
+    QTRY_COMPARE(calls.loadRelaxed(), 10);
+    movedReceiver->deleteLater();
+    target.quit();
+    QVERIFY(target.wait());
+}
+#endif // QT_CONFIG(cxx11_future)
+
 void tst_QCoreApplication::applicationPid()
 {
     QVERIFY(QCoreApplication::applicationPid() > 0);
@@ -20,6 +20,9 @@ private slots:
     void removePostedEvents();
 #if QT_CONFIG(thread)
     void deliverInDefinedOrder();
+#endif
+#if QT_CONFIG(cxx11_future)
+    void queuedCallsFromThread();
 #endif
     void applicationPid();
 #ifdef QT_BUILD_INTERNAL
@@ -26,6 +26,7 @@
 #include <QThread>
 #include <QMutex>
 #include <QWaitCondition>
+#include <QSemaphore>
 #include <QScopedPointer>
 #if QT_CONFIG(process)
 # include <QProcess>
@@ -145,6 +146,11 @@ private slots:
     void functorReferencesConnection();
     void disconnectDisconnects();
     void singleShotConnection();
+    void batchedConnection();
+    void coalescedConnection();
+    void metaCallEventRecycling();
+    void manyReceiversWhileConnecting();
+    void manyReceiversFromThreads();
     void objectNameBinding();
     void emitToDestroyedClass();
 };
@@ -8148,6 +8154,306 @@ void tst_QObject::singleShotConnection()
     }
 }
 
+class BatchSender : public QObject
+{
+    Q_OBJECT
+signals:
+    void value(int i);
+    void text(int i, const QString &s);
+    void ping();
+};
+
+class MetaCallCounter : public QObject
+{
+public:
+    int metaCalls = 0;
+
+protected:
+    bool eventFilter(QObject *, QEvent *e) override
+    {
+        if (e->type() == QEvent::MetaCall)
+            ++metaCalls;
+        return false;
+    }
+};
+
+void tst_QObject::batchedConnection()
+{
+    const auto type = static_cast<Qt::ConnectionType>(Qt::QueuedConnection | Qt::BatchedConnection);
+
+    {
+        // every emission is delivered, in order, through a single event
+        BatchSender sender;
+        QObject receiver;
+        MetaCallCounter counter;
+        receiver.installEventFilter(&counter);
+        QList<int> values;
+        QStringList strings;
+        QVERIFY(connect(&sender, &BatchSender::text, &receiver, [&](int i, const QString &s) {
+            values << i;
+            strings << s;
+        }, type));
+
+        for (int i = 0; i < 100; ++i)
+            emit sender.text(i, QString::number(i));
+        QVERIFY(values.isEmpty());
+
+        QCoreApplication::processEvents();
+        QCOMPARE(counter.metaCalls, 1);
+        QCOMPARE(values.size(), 100);
+        for (int i = 0; i < 100; ++i) {
+            QCOMPARE(values.at(i), i);
+            QCOMPARE(strings.at(i), QString::number(i));
+        }
+
+        // the next emission starts a new batch
+        emit sender.text(100, QStringLiteral("again"));
+        QCoreApplication::processEvents();
+        QCOMPARE(counter.metaCalls, 2);
+        QCOMPARE(values.size(), 101);
+        QCOMPARE(strings.last(), QStringLiteral("again"));
+    }
+
+    {
+        // string-based connections and signals without arguments
+        SenderObject sender;
+        ReceiverObject receiver;
+        receiver.reset();
+        QVERIFY(connect(&sender, SIGNAL(signal1()), &receiver, SLOT(slot1()), type));
+
+        sender.emitSignal1();
+        sender.emitSignal1();
+        sender.emitSignal1();
+        QCOMPARE(receiver.count_slot1, 0);
+        QCoreApplication::processEvents();
+        QCOMPARE(receiver.count_slot1, 3);
+    }
+
+    {
+        // removing the posted event drops the calls it carries
+        BatchSender sender;
+        QObject receiver;
+        int calls = 0;
+        QVERIFY(connect(&sender, &BatchSender::value, &receiver, [&] { ++calls; }, type));
+
+        emit sender.value(1);
+        emit sender.value(2);
+        QCoreApplication::removePostedEvents(&receiver, QEvent::MetaCall);
+        QCoreApplication::processEvents();
+        QCOMPARE(calls, 0);
+
+        emit sender.value(3);
+        QCoreApplication::processEvents();
+        QCOMPARE(calls, 1);
+    }
+
+    {
+        // with an AutoConnection in the same thread the slot is called directly
+        BatchSender sender;
+        QObject receiver;
+        int calls = 0;
+        QVERIFY(connect(&sender, &BatchSender::value, &receiver, [&] { ++calls; },
+                        static_cast<Qt::ConnectionType>(Qt::AutoConnection | Qt::BatchedConnection)));
+        emit sender.value(1);
+        emit sender.value(2);
+        QCOMPARE(calls, 2);
+    }
+
+    {
+        // delete the receiver from inside the slot
+        SenderObject sender;
+        QPointer<DeleteThisReceiver> p = new DeleteThisReceiver;
+        DeleteThisReceiver::counter = 0;
+        QVERIFY(connect(&sender, &SenderObject::signal1,
+                        p.get(), &DeleteThisReceiver::deleteThis, type));
+
+        sender.emitSignal1();
+        sender.emitSignal1();
+        sender.emitSignal1();
+        QTRY_COMPARE(DeleteThisReceiver::counter, 1);
+        QVERIFY(!p);
+        QTest::qWait(0);
+        QCOMPARE(DeleteThisReceiver::counter, 1);
+    }
+
+#if QT_CONFIG(cxx11_future)
+    {
+        // emissions from another thread
+        constexpr int Count = 10000;
+        BatchSender sender;
+        QObject receiver;
+        QList<int> values;
+        QVERIFY(connect(&sender, &BatchSender::value, &receiver, [&](int i) { values << i; }, type));
+
+        QScopedPointer<QThread> producer(QThread::create([&] {
+            for (int i = 0; i < Count; ++i)
+                emit sender.value(i);
+        }));
+        producer->start();
+        QVERIFY(producer->wait());
+        QTRY_COMPARE(values.size(), Count);
+        for (int i = 0; i < Count; ++i)
+            QCOMPARE(values.at(i), i);
+    }
+#endif
+}
+
+void tst_QObject::coalescedConnection()
+{
+    const auto type = static_cast<Qt::ConnectionType>(Qt::QueuedConnection | Qt::CoalescedConnection);
+
+    BatchSender sender;
+    QObject receiver;
+    QList<int> values;
+    QStringList strings;
+    QVERIFY(connect(&sender, &BatchSender::text, &receiver, [&](int i, const QString &s) {
+        values << i;
+        strings << s;
+    }, type));
+
+    for (int i = 0; i < 100; ++i)
+        emit sender.text(i, QString::number(i));
+    QCoreApplication::processEvents();
+    QCOMPARE(values, QList<int>{ 99 });
+    QCOMPARE(strings, QStringList{ QStringLiteral("99") });
+
+    emit sender.text(100, QStringLiteral("100"));
+    QCoreApplication::processEvents();
+    QCOMPARE(values, (QList<int>{ 99, 100 }));
+    QCOMPARE(strings.last(), QStringLiteral("100"));
+
+    // without a receiver left, the pending value is simply dropped
+    emit sender.text(101, QStringLiteral("101"));
+    QVERIFY(QObject::disconnect(&sender, nullptr, &receiver, nullptr));
+    QCoreApplication::removePostedEvents(&receiver, QEvent::MetaCall);
+    QCoreApplication::processEvents();
+    QCOMPARE(values.size(), 2);
+}
+
+void tst_QObject::metaCallEventRecycling()
+{
+#ifdef QT_BUILD_INTERNAL
+    using Statistics = QAbstractMetaCallEvent::AllocationStatistics;
+
+    BatchSender sender;
+    QObject receiver;
+    int calls = 0;
+    connect(&sender, &BatchSender::value, &receiver, [&] { ++calls; }, Qt::QueuedConnection);
+
+    auto round = [&] {
+        for (int i = 0; i < 100; ++i)
+            emit sender.value(i);
+        QCoreApplication::processEvents();
+    };
+
+    // warm up the cache of this thread
+    round();
+    const Statistics before = QAbstractMetaCallEvent::allocationStatistics();
+    for (int i = 0; i < 10; ++i)
+        round();
+    const Statistics after = QAbstractMetaCallEvent::allocationStatistics();
+    QCOMPARE(calls, 1100);
+    QCOMPARE(after.allocations - before.allocations, 1000u);
+    QCOMPARE(after.heapAllocations, before.heapAllocations);
+
+#if QT_CONFIG(cxx11_future)
+    // events deleted by the receiving thread go back to the emitting one
+    calls = 0;
+    Statistics producerBefore, producerAfter;
+    QSemaphore delivered;
+    connect(&sender, &BatchSender::ping, &receiver, [&] { delivered.release(); },
+            Qt::QueuedConnection);
+    QScopedPointer<QThread> producer(QThread::create([&] {
+        auto threadRound = [&] {
+            for (int i = 0; i < 100; ++i)
+                emit sender.value(i);
+            emit sender.ping();
+            delivered.acquire();
+        };
+        producerBefore = QAbstractMetaCallEvent::allocationStatistics();
+        threadRound();
+        for (int i = 0; i < 10; ++i)
+            threadRound();
+        producerAfter = QAbstractMetaCallEvent::allocationStatistics();
+    }));
+    producer->start();
+    QTRY_VERIFY(producer->wait(0));
+    QCOMPARE(calls, 1100);
+    QCOMPARE(producerAfter.allocations - producerBefore.allocations, 1111u);
+    // memory for one round is enough; the ping event of a round may still be
+    // on its way back when the next one starts, so allow for one more per round
+    QVERIFY(producerAfter.heapAllocations - producerBefore.heapAllocations <= 101u + 11u);
+#endif
+#else
+    QSKIP("Needs QT_BUILD_INTERNAL");
+#endif
+}
+
+void tst_QObject::manyReceiversWhileConnecting()
+{
+    SenderObject sender;
+    QList<int> calls(10);
+    QList<QMetaObject::Connection> connections;
+    QObject late;
+    int lateCalls = 0;
+    for (int i = 0; i < calls.size(); ++i) {
+        connections << connect(&sender, &SenderObject::signal1, &sender, [&, i] {
+            ++calls[i];
+            if (i == 2) {
+                // neither affects the emission that is in progress
+                QVERIFY(QObject::disconnect(connections.at(5)));
+                connect(&sender, &SenderObject::signal1, &late, [&] { ++lateCalls; });
+            }
+        });
+    }
+
+    sender.emitSignal1();
+    QCOMPARE(calls, QList<int>({1, 1, 1, 1, 1, 0, 1, 1, 1, 1}));
+    QCOMPARE(lateCalls, 0);
+
+    QObject::disconnect(connections.at(2));
+    sender.emitSignal1();
+    QCOMPARE(calls, QList<int>({2, 2, 1, 2, 2, 0, 2, 2, 2, 2}));
+    QCOMPARE(lateCalls, 1);
+}
+
+void tst_QObject::manyReceiversFromThreads()
+{
+#if QT_CONFIG(cxx11_future)
+    constexpr int ThreadCount = 4;
+    constexpr int Emissions = 1000;
+    constexpr int ReceiverCount = 20;
+
+    SenderObject sender;
+    QObject receivers[ReceiverCount];
+    QAtomicInt calls;
+    for (QObject &receiver : receivers) {
+        connect(&sender, &SenderObject::signal1, &receiver, [&] { calls.ref(); },
+                Qt::DirectConnection);
+    }
+
+    std::vector<std::unique_ptr<QThread>> threads;
+    for (int i = 0; i < ThreadCount; ++i) {
+        threads.emplace_back(QThread::create([&] {
+            for (int j = 0; j < Emissions; ++j)
+                sender.emitSignal1();
+        }));
+    }
+    for (const auto &thread : threads)
+        thread->start();
+    // keep changing the list while the threads are emitting
+    QObject extra;
+    for (int j = 0; j < 100; ++j) {
+        auto connection = connect(&sender, &SenderObject::signal1, &extra, [] {},
+                                  Qt::DirectConnection);
+        QObject::disconnect(connection);
+    }
+    for (const auto &thread : threads)
+        QVERIFY(thread->wait());
+    QCOMPARE(calls.loadRelaxed(), ThreadCount * Emissions * ReceiverCount);
+#endif
+}
+
 void tst_QObject::objectNameBinding()
 {
     QObject obj;
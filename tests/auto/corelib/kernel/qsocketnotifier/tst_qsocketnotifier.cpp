@@ -8,6 +8,7 @@
 #include <QtCore/QCoreApplication>
 #include <QtCore/QTimer>
 #include <QtCore/QSocketNotifier>
+#include <QtCore/QTemporaryFile>
 #include <QtNetwork/QTcpServer>
 #include <QtNetwork/QTcpSocket>
 #include <QtNetwork/QUdpSocket>
@@ -15,6 +16,7 @@
 #define NATIVESOCKETENGINE QNativeSocketEngine
 #ifdef Q_OS_UNIX
 #include <private/qnet_unix_p.h>
+#include <private/qeventdispatcher_unix_p.h>
 #include <sys/select.h>
 #endif
 #include <limits>
@@ -34,6 +36,9 @@ private slots:
     void mixingWithTimers();
 #ifdef Q_OS_UNIX
     void posixSockets();
+#endif
+#if defined(Q_OS_UNIX) && QT_CONFIG(epoll)
+    void epollDispatcher();
 #endif
     void asyncMultipleDatagram();
     void activationReason_data();
@@ -337,6 +342,65 @@ void tst_QSocketNotifier::posixSockets()
 }
 #endif
 
+#if defined(Q_OS_UNIX) && QT_CONFIG(epoll)
+void tst_QSocketNotifier::epollDispatcher()
+{
+    qputenv("QT_EVENT_DISPATCHER_EPOLL", "1");
+    QEventDispatcherUNIX dispatcher;
+    qunsetenv("QT_EVENT_DISPATCHER_EPOLL");
+
+    int fds[2];
+    QCOMPARE(qt_safe_pipe(fds, O_NONBLOCK), 0);
+
+    // drive the notifiers through our dispatcher instead of the thread's
+    QSocketNotifier rn(fds[0], QSocketNotifier::Read);
+    rn.setEnabled(false);
+    dispatcher.registerSocketNotifier(&rn);
+    QSignalSpy readSpy(&rn, &QSocketNotifier::activated);
+
+    QSocketNotifier wn(fds[1], QSocketNotifier::Write);
+    wn.setEnabled(false);
+    dispatcher.registerSocketNotifier(&wn);
+    QSignalSpy writeSpy(&wn, &QSocketNotifier::activated);
+
+    // only the write end is ready
+    QVERIFY(dispatcher.processEvents(QEventLoop::AllEvents));
+    QCOMPARE(readSpy.count(), 0);
+    QCOMPARE(writeSpy.count(), 1);
+
+    // removing a notifier updates the interest set
+    dispatcher.unregisterSocketNotifier(&wn);
+    QCOMPARE(qt_safe_write(fds[1], "x", 1), 1);
+    QVERIFY(dispatcher.processEvents(QEventLoop::AllEvents));
+    QCOMPARE(readSpy.count(), 1);
+    QCOMPARE(writeSpy.count(), 1);
+
+    // level-triggered, like poll(): still readable until drained
+    QVERIFY(dispatcher.processEvents(QEventLoop::AllEvents));
+    QCOMPARE(readSpy.count(), 2);
+
+    char c;
+    QCOMPARE(qt_safe_read(fds[0], &c, 1), 1);
+    QVERIFY(!dispatcher.processEvents(QEventLoop::AllEvents));
+    QCOMPARE(readSpy.count(), 2);
+
+    // regular files can't be watched by epoll, but poll() reports them as ready
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QSocketNotifier fn(file.handle(), QSocketNotifier::Read);
+    fn.setEnabled(false);
+    dispatcher.registerSocketNotifier(&fn);
+    QSignalSpy fileSpy(&fn, &QSocketNotifier::activated);
+    QVERIFY(dispatcher.processEvents(QEventLoop::AllEvents));
+    QCOMPARE(fileSpy.count(), 1);
+
+    dispatcher.unregisterSocketNotifier(&fn);
+    dispatcher.unregisterSocketNotifier(&rn);
+    qt_safe_close(fds[0]);
+    qt_safe_close(fds[1]);
+}
+#endif
+
 void tst_QSocketNotifier::async_readDatagramSlot()
 {
     char buf[1];
@@ -35,6 +35,7 @@ private slots:
     void remainingTime();
     void remainingTimeInitial_data();
     void remainingTimeInitial();
+    void longTimers();
     void remainingTimeDuringActivation_data();
     void remainingTimeDuringActivation();
     void basic_chrono();
@@ -170,6 +171,37 @@ void tst_QTimer::remainingTime()
                               testedInterval * desiredTestCount * 2);
 }
 
+void tst_QTimer::longTimers()
+{
+    // timers far in the future must neither fire early nor delay short ones
+    const int intervals[] = { 10 * 3600 * 1000, 3600 * 1000, 300 * 1000, 5000 };
+    QList<QTimer *> longTimers;
+    for (int interval : intervals) {
+        QTimer *timer = new QTimer(this);
+        timer->setTimerType(Qt::PreciseTimer);
+        timer->start(interval);
+        longTimers << timer;
+    }
+
+    QTimer shortTimer;
+    shortTimer.setTimerType(Qt::PreciseTimer);
+    shortTimer.setSingleShot(true);
+    QSignalSpy timeoutSpy(&shortTimer, &QTimer::timeout);
+    QElapsedTimer elapsed;
+    elapsed.start();
+    shortTimer.start(50);
+
+    QVERIFY(timeoutSpy.wait(5000));
+    QVERIFY(elapsed.elapsed() >= 50);
+
+    for (int i = 0; i < longTimers.size(); ++i) {
+        const int remaining = longTimers.at(i)->remainingTime();
+        QVERIFY2(remaining > intervals[i] - 5000 && remaining <= intervals[i],
+                 qPrintable(QString::number(remaining)));
+        delete longTimers.at(i);
+    }
+}
+
 void tst_QTimer::remainingTimeInitial_data()
 {
     QTest::addColumn<int>("startTimeMs");
@@ -12,6 +12,9 @@ QT_WARNING_DISABLE_DEPRECATED
 #include "qjsonobject.h"
 #include "qjsonvalue.h"
 #include "qjsondocument.h"
+#include "qjsonlazyvalue.h"
+#include "qcbormap.h"
+#include "qstringpool.h"
 #include "qregularexpression.h"
 #include "private/qnumeric_p.h"
 #include <limits>
@@ -78,6 +81,7 @@ private Q_SLOTS:
     void fromVariantHash();
     void toVariantMap();
     void toVariantHash();
+    void toVariantMapKeyPool();
     void toVariantList();
 
     void toJson();
@@ -99,6 +103,7 @@ private Q_SLOTS:
 
     void parseEscapes_data();
     void parseEscapes();
+    void parseLongStrings();
     void makeEscapes_data();
     void makeEscapes();
 
@@ -158,6 +163,12 @@ private Q_SLOTS:
     void noLeakOnNameClash_data();
     void noLeakOnNameClash();
 
+    void lazyValue_data();
+    void lazyValue();
+    void lazyValueErrors_data();
+    void lazyValueErrors();
+    void lazyValueAccess();
+
 private:
     QString testDataDir;
 };
@@ -1713,6 +1724,48 @@ void tst_QtJson::toVariantHash()
     QCOMPARE(list.at(3), QVariant::fromValue(nullptr));
 }
 
+void tst_QtJson::toVariantMapKeyPool()
+{
+    const QJsonDocument doc = QJsonDocument::fromJson(
+            R"({"id": 1, "items": [{"id": 2, "name": "a"}, {"id": 3, "name": "b"}],
+                "child": {"id": 4, "name": "c"}})");
+    QVERIFY(doc.isObject());
+    const QJsonObject object = doc.object();
+
+    QStringPool pool;
+    const QVariantMap map = object.toVariantMap(&pool);
+    QCOMPARE(map, object.toVariantMap());
+    QCOMPARE(pool.size(), 4);
+
+    const QString id = pool.intern(u"id");
+    const QString name = pool.intern(u"name");
+    auto checkKeys = [&](const QVariantMap &map) {
+        for (auto it = map.keyBegin(); it != map.keyEnd(); ++it)
+            QCOMPARE(it->constData(), pool.intern(*it).constData());
+    };
+    checkKeys(map);
+    checkKeys(map.value("child").toMap());
+    for (const QVariant &item : map.value("items").toList())
+        checkKeys(item.toMap());
+    QCOMPARE(map.value("child").toMap().firstKey().constData(), id.constData());
+    QCOMPARE(map.value("child").toMap().lastKey().constData(), name.constData());
+
+    const QVariantHash hash = object.toVariantHash(&pool);
+    QCOMPARE(hash, object.toVariantHash());
+    QCOMPARE(pool.size(), 4);
+    for (auto it = hash.keyBegin(); it != hash.keyEnd(); ++it)
+        QCOMPARE(it->constData(), pool.intern(*it).constData());
+
+    // the same through QCborMap, with a tagged map
+    QCborMap cbor = QCborMap::fromJsonObject(object);
+    cbor.insert(QStringLiteral("tagged"),
+                QCborValue(QCborTag(1000), QCborMap{ { QStringLiteral("id"), 5 } }));
+    const QVariantMap cborMap = cbor.toVariantMap(&pool);
+    QCOMPARE(cborMap, cbor.toVariantMap());
+    QCOMPARE(pool.size(), 5);
+    QCOMPARE(cborMap.value("tagged").toMap().firstKey().constData(), id.constData());
+}
+
 void tst_QtJson::toVariantList()
 {
     QCOMPARE(QMetaType::Type(QJsonValue(QJsonArray()).toVariant().type()), QMetaType::QVariantList); // QTBUG-32524
@@ -2633,6 +2686,43 @@ void tst_QtJson::parseEscapes()
     QCOMPARE(array.first().toString(), result);
 }
 
+void tst_QtJson::parseLongStrings()
+{
+    // the parser scans strings and whitespace in blocks, so check that
+    // special characters are found at every position within and across them
+    for (int length = 0; length < 40; ++length) {
+        const QByteArray ascii(length, 'a');
+        const QByteArray spaces = QByteArray(length, ' ') + '\n' + QByteArray(length, '\t');
+
+        QJsonParseError error;
+        QByteArray json = '[' + spaces + '"' + ascii + "\\\"" + ascii + '"' + spaces + ']';
+        QJsonDocument doc = QJsonDocument::fromJson(json, &error);
+        QCOMPARE(error.error, QJsonParseError::NoError);
+        QCOMPARE(doc.array().first().toString(), QString::fromLatin1(ascii + '"' + ascii));
+
+        json = "{\"" + ascii + "\\u00e4\":\"" + ascii + "\xc3\xa4" + ascii + "\"}";
+        doc = QJsonDocument::fromJson(json, &error);
+        QCOMPARE(error.error, QJsonParseError::NoError);
+        const QString latin1 = QString::fromLatin1(ascii);
+        QCOMPARE(doc.object().value(latin1 + u'\u00e4').toString(), latin1 + u'\u00e4' + latin1);
+
+        json = "[\"" + ascii + "\xff" + ascii + "\"]";
+        doc = QJsonDocument::fromJson(json, &error);
+        QCOMPARE(error.error, QJsonParseError::IllegalUTF8String);
+        QCOMPARE(error.offset, length + 2);
+
+        json = "[\"" + ascii + spaces;
+        doc = QJsonDocument::fromJson(json, &error);
+        QCOMPARE(error.error, QJsonParseError::UnterminatedString);
+        QCOMPARE(error.offset, json.size() + 1);
+
+        json = "[" + spaces + "1" + spaces + ",";
+        doc = QJsonDocument::fromJson(json, &error);
+        QCOMPARE(error.error, QJsonParseError::UnterminatedArray);
+        QCOMPARE(error.offset, json.size());
+    }
+}
+
 void tst_QtJson::makeEscapes_data()
 {
     QTest::addColumn<QString>("input");
@@ -3826,5 +3916,148 @@ void tst_QtJson::noLeakOnNameClash()
     // In particular it should not forget to deref the container for the inner objects.
 }
 
+// compares the lazily indexed value with the one QJsonDocument produces
+static void compareLazyValue(const QJsonLazyValue &lazy, const QJsonValue &value)
+{
+    QCOMPARE(lazy.type(), value.type());
+    QCOMPARE(lazy.toJsonValue(), value);
+    QCOMPARE(lazy.toBool(), value.toBool());
+    QCOMPARE(lazy.toInteger(-1), value.toInteger(-1));
+    QCOMPARE(lazy.toDouble(-1), value.toDouble(-1));
+    QCOMPARE(lazy.toString(), value.toString());
+
+    if (value.isArray()) {
+        const QJsonArray array = value.toArray();
+        QCOMPARE(lazy.size(), array.size());
+        for (qsizetype i = 0; i < array.size(); ++i) {
+            compareLazyValue(lazy.at(i), array.at(i));
+            if (QTest::currentTestFailed())
+                return;
+        }
+        QVERIFY(lazy.at(array.size()).isUndefined());
+    } else if (value.isObject()) {
+        const QJsonObject object = value.toObject();
+        QStringList keys = lazy.keys();
+        QCOMPARE(keys.size(), lazy.size());
+        keys.sort();
+        keys.removeDuplicates();
+        QCOMPARE(keys, object.keys());
+        for (const QString &key : keys) {
+            QVERIFY(lazy.contains(key));
+            compareLazyValue(lazy[key], object.value(key));
+            if (QTest::currentTestFailed())
+                return;
+        }
+        QVERIFY(!lazy.contains(u"no such key"));
+    }
+}
+
+void tst_QtJson::lazyValue_data()
+{
+    QTest::addColumn<QString>("fileName");
+
+    for (const char *fileName : { "test.json", "test2.json", "test3.json", "bom.json",
+                                  "simple.duplicates.json", "test.duplicates.json",
+                                  "test3.duplicates.json" }) {
+        QTest::newRow(fileName) << QString::fromLatin1(fileName);
+    }
+}
+
+void tst_QtJson::lazyValue()
+{
+    QFETCH(QString, fileName);
+
+    QFile file(testDataDir + u'/' + fileName);
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QByteArray testJson = file.readAll();
+
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(testJson, &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    const QJsonLazyValue lazy = QJsonLazyValue::fromJson(testJson, &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+
+    compareLazyValue(lazy, doc.isArray() ? QJsonValue(doc.array()) : QJsonValue(doc.object()));
+}
+
+void tst_QtJson::lazyValueErrors_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QTest::newRow("empty") << QByteArray();
+    QTest::newRow("scalar") << QByteArray("42");
+    QTest::newRow("unterminated-object") << QByteArray("{ \"a\": 1");
+    QTest::newRow("unterminated-array") << QByteArray("[ 1, 2");
+    QTest::newRow("unterminated-string") << QByteArray("[ \"abc ]");
+    QTest::newRow("missing-separator") << QByteArray("{ \"a\" 1 }");
+    QTest::newRow("illegal-number") << QByteArray("[ -, 1 ]");
+    QTest::newRow("illegal-value") << QByteArray("[ nul ]");
+    QTest::newRow("invalid-escape") << QByteArray("[ \"\\u12\" ]");
+    QTest::newRow("invalid-utf8") << QByteArray("[ \"" INVALID_UNICODE "\" ]");
+    QTest::newRow("garbage-at-end") << QByteArray("[] x");
+    QTest::newRow("deep-nesting") << QByteArray(2000, '[') + QByteArray(2000, ']');
+    QTest::newRow("trailing-comma") << QByteArray("{ \"value\": false, }");
+}
+
+void tst_QtJson::lazyValueErrors()
+{
+    QFETCH(QByteArray, json);
+
+    QJsonParseError expected;
+    QJsonDocument::fromJson(json, &expected);
+    QVERIFY(expected.error != QJsonParseError::NoError);
+
+    QJsonParseError error;
+    const QJsonLazyValue lazy = QJsonLazyValue::fromJson(json, &error);
+    QCOMPARE(error.error, expected.error);
+    QCOMPARE(error.offset, expected.offset);
+    QVERIFY(lazy.isUndefined());
+    QVERIFY(lazy.rawJson().isNull());
+}
+
+void tst_QtJson::lazyValueAccess()
+{
+    const QByteArray json = R"( {
+        "name": "Qt", "version": [6, 5], "nested": { "a": [ true, null ] },
+        "esc\u0061ped": "line\nbreak", "dup": 1, "dup": 2, "big": 1e300
+    } )";
+    const QJsonLazyValue root = QJsonLazyValue::fromJson(json);
+
+    QVERIFY(root.isObject());
+    QCOMPARE(root.size(), 7);
+    QCOMPARE(root.keys(), QStringList({ "name", "version", "nested", "escaped", "dup", "dup",
+                                        "big" }));
+    QCOMPARE(root.rawJson().toByteArray(), json.trimmed());
+
+    QCOMPARE(root["name"].toString(), QStringLiteral("Qt"));
+    QCOMPARE(root[QLatin1StringView("name")].rawJson().toByteArray(), QByteArray("\"Qt\""));
+    QCOMPARE(root["version"][1].toInt(), 5);
+    QCOMPARE(root["nested"].rawJson().toByteArray(), QByteArray(R"({ "a": [ true, null ] })"));
+    QVERIFY(root["nested"]["a"][0].toBool());
+    QVERIFY(root["nested"]["a"][1].isNull());
+    QCOMPARE(root["escaped"].toString(), QStringLiteral("line\nbreak"));
+    QCOMPARE(root["dup"].toInt(), 2);
+    QCOMPARE(root["big"].toDouble(), 1e300);
+    QCOMPARE(root["big"].toInt(-1), -1);
+
+    // lookups of anything that isn't there give undefined values
+    QVERIFY(root["missing"].isUndefined());
+    QVERIFY(root["name"]["missing"].isUndefined());
+    QVERIFY(root["version"][2].isUndefined());
+    QVERIFY(root["version"][-1].isUndefined());
+    QVERIFY(root[0].isUndefined());
+    QCOMPARE(root["missing"].toString(QStringLiteral("default")), QStringLiteral("default"));
+    QCOMPARE(root["missing"].toJsonValue(), QJsonValue(QJsonValue::Undefined));
+
+    // the values keep the document alive
+    QJsonLazyValue nested;
+    {
+        QJsonLazyValue copy = root;
+        nested = copy["nested"];
+    }
+    QCOMPARE(nested.toJsonValue(), QJsonValue(QJsonObject { { "a", QJsonArray { true,
+                                                                                QJsonValue() } } }));
+}
+
 QTEST_MAIN(tst_QtJson)
 #include "tst_qtjson.moc"
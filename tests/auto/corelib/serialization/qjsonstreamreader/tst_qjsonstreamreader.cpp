@@ -0,0 +1,541 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QTest>
+#include <QBuffer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonStreamReader>
+#include <QStringPool>
+
+class tst_QJsonStreamReader : public QObject
+{
+    Q_OBJECT
+private slots:
+    void tokens_data();
+    void tokens();
+    void numbers_data();
+    void numbers();
+    void matchesDocument_data();
+    void matchesDocument();
+    void errors_data();
+    void errors();
+    void prematureEnd_data();
+    void prematureEnd();
+    void incremental_data() { matchesDocument_data(); }
+    void incremental();
+    void sequentialDevice();
+    void largeStrings();
+    void skipValue();
+    void clear();
+    void namePool();
+};
+
+// a sequential device that returns the data fed to it, like a socket
+class FeedDevice : public QIODevice
+{
+public:
+    FeedDevice() { open(ReadOnly | Unbuffered); }
+    bool isSequential() const override { return true; }
+    void feed(const QByteArray &data) { pending += data; }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override
+    {
+        const qint64 size = qMin(maxSize, qint64(pending.size()));
+        memcpy(data, pending.constData(), size);
+        pending.remove(0, size);
+        return size;
+    }
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+    QByteArray pending;
+};
+
+static QString describeToken(const QJsonStreamReader &reader)
+{
+    switch (reader.tokenType()) {
+    case QJsonStreamReader::StartArray:
+        return QStringLiteral("[");
+    case QJsonStreamReader::EndArray:
+        return QStringLiteral("]");
+    case QJsonStreamReader::StartObject:
+        return QStringLiteral("{");
+    case QJsonStreamReader::EndObject:
+        return QStringLiteral("}");
+    case QJsonStreamReader::Name:
+        return reader.text() + u':';
+    case QJsonStreamReader::String:
+        return u'"' + reader.text() + u'"';
+    case QJsonStreamReader::Number:
+        return u'#' + reader.text();
+    case QJsonStreamReader::Bool:
+        return reader.toBool() ? QStringLiteral("true") : QStringLiteral("false");
+    case QJsonStreamReader::Null:
+        return QStringLiteral("null");
+    case QJsonStreamReader::NoToken:
+    case QJsonStreamReader::Invalid:
+        break;
+    }
+    return QStringLiteral("<invalid>");
+}
+
+// reads tokens up to the end of the available input
+static QString readTokens(QJsonStreamReader &reader)
+{
+    QStringList tokens;
+    while (reader.readNext() != QJsonStreamReader::NoToken) {
+        if (reader.hasError())
+            return QLatin1StringView("error: ") + reader.errorString();
+        tokens.append(describeToken(reader));
+    }
+    return tokens.join(u' ');
+}
+
+// builds the value whose first token is the current one
+static QJsonValue readValue(QJsonStreamReader &reader)
+{
+    switch (reader.tokenType()) {
+    case QJsonStreamReader::StartArray: {
+        QJsonArray array;
+        while (reader.readNext() != QJsonStreamReader::EndArray && !reader.hasError())
+            array.append(readValue(reader));
+        return array;
+    }
+    case QJsonStreamReader::StartObject: {
+        QJsonObject object;
+        while (reader.readNext() == QJsonStreamReader::Name) {
+            const QString name = reader.text();
+            reader.readNext();
+            object.insert(name, readValue(reader));
+        }
+        return object;
+    }
+    case QJsonStreamReader::String:
+        return reader.text();
+    case QJsonStreamReader::Number:
+        if (reader.isInteger())
+            return reader.toInteger();
+        return reader.toDouble();
+    case QJsonStreamReader::Bool:
+        return reader.toBool();
+    case QJsonStreamReader::Null:
+        return QJsonValue::Null;
+    default:
+        return QJsonValue::Undefined;
+    }
+}
+
+void tst_QJsonStreamReader::tokens_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("empty") << QByteArray() << QString();
+    QTest::newRow("whitespace") << QByteArray(" \r\n\t ") << QString();
+    QTest::newRow("empty-object") << QByteArray("{}") << "{ }";
+    QTest::newRow("empty-array") << QByteArray("[ ]") << "[ ]";
+    QTest::newRow("scalars")
+            << QByteArray("[true, false, null, \"text\", 1, -2.5]")
+            << "[ true false null \"text\" #1 #-2.5 ]";
+    QTest::newRow("object")
+            << QByteArray("{\"a\": 1, \"b\": {\"c\": []}, \"d\": [{}]}")
+            << "{ a: #1 b: { c: [ ] } d: [ { } ] }";
+    QTest::newRow("indented")
+            << QJsonDocument(QJsonObject{ { "list", QJsonArray{ 1, 2 } } }).toJson()
+            << "{ list: [ #1 #2 ] }";
+    QTest::newRow("duplicate-names")
+            << QByteArray("{\"a\":1,\"a\":2}") << "{ a: #1 a: #2 }";
+    QTest::newRow("escapes")
+            << QByteArray(R"(["\"\\\/\b\f\n\r\t", "ä€😀"])")
+            << QStringLiteral("[ \"\"\\/\b\f\n\r\t\" \"ä€\U0001f600\" ]");
+    QTest::newRow("utf8")
+            << QByteArray("{\"\xc3\xa4\": \"\xe2\x82\xac\"}")
+            << QStringLiteral("{ ä: \"€\" }");
+    QTest::newRow("byte-order-mark")
+            << QByteArray("\xef\xbb\xbf[1]") << "[ #1 ]";
+    QTest::newRow("top-level-scalars")
+            << QByteArray("\"a\" 1 true null") << "\"a\" #1 true null";
+    QTest::newRow("ndjson")
+            << QByteArray("{\"id\":1}\n{\"id\":2}\n[3]\n")
+            << "{ id: #1 } { id: #2 } [ #3 ]";
+    QTest::newRow("adjacent-values")
+            << QByteArray("{}[]\"x\"") << "{ } [ ] \"x\"";
+}
+
+void tst_QJsonStreamReader::tokens()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QString, expected);
+
+    QJsonStreamReader reader(json);
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::NoToken);
+    QVERIFY(!reader.atEnd());
+    QCOMPARE(readTokens(reader), expected);
+    QVERIFY(reader.atEnd());
+    QVERIFY(!reader.hasError());
+    QCOMPARE(reader.depth(), 0);
+
+    // reading from a device gives the same result
+    QBuffer buffer(&json);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader deviceReader(&buffer);
+    QCOMPARE(readTokens(deviceReader), expected);
+    QVERIFY(deviceReader.atEnd());
+}
+
+void tst_QJsonStreamReader::numbers_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<bool>("isInteger");
+    QTest::addColumn<qint64>("integer");
+    QTest::addColumn<double>("real");
+
+    QTest::newRow("zero") << QByteArray("0") << true << qint64(0) << 0.;
+    QTest::newRow("negative") << QByteArray("-42") << true << qint64(-42) << -42.;
+    QTest::newRow("max") << QByteArray("9223372036854775807") << true
+                         << std::numeric_limits<qint64>::max() << 9223372036854775807.;
+    QTest::newRow("min") << QByteArray("-9223372036854775808") << true
+                         << std::numeric_limits<qint64>::min() << -9223372036854775808.;
+    QTest::newRow("too-large") << QByteArray("18446744073709551616") << false
+                               << qint64(0) << 18446744073709551616.;
+    QTest::newRow("fraction") << QByteArray("1.25") << false << qint64(0) << 1.25;
+    QTest::newRow("zero-fraction") << QByteArray("3.0") << true << qint64(3) << 3.;
+    QTest::newRow("exponent") << QByteArray("1e3") << true << qint64(1000) << 1000.;
+    QTest::newRow("negative-exponent") << QByteArray("-5E-1") << false << qint64(0) << -0.5;
+}
+
+void tst_QJsonStreamReader::numbers()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(bool, isInteger);
+    QFETCH(qint64, integer);
+    QFETCH(double, real);
+
+    QJsonStreamReader reader('[' + json + ']');
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.text(), QString::fromLatin1(json));
+    QCOMPARE(reader.isInteger(), isInteger);
+    QCOMPARE(reader.toInteger(), integer);
+    QCOMPARE(reader.toDouble(), real);
+    QCOMPARE(reader.offset(), 1);
+
+    // the same as QJsonDocument
+    const QJsonValue value = QJsonDocument::fromJson('[' + json + ']').array().at(0);
+    QCOMPARE(value.toDouble(), real);
+    if (isInteger)
+        QCOMPARE(value.toInteger(), integer);
+}
+
+static QByteArray generatedDocument()
+{
+    QJsonArray users;
+    for (int i = 0; i < 1000; ++i) {
+        users.append(QJsonObject{
+            { "id", i },
+            { "name", QStringLiteral("User \"%1\"\n").arg(i) },
+            { "score", i / 7. },
+            { "active", i % 3 == 0 },
+            { "tags", QJsonArray{ "a", QStringLiteral("ä€"), QJsonValue::Null } },
+        });
+    }
+    return QJsonDocument(QJsonObject{ { "users", users } }).toJson();
+}
+
+void tst_QJsonStreamReader::matchesDocument_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QTest::newRow("object") << QByteArray(R"({"a": [1, 2.5, "x"], "b": {"c": null, "d": true}})");
+    QTest::newRow("array") << QByteArray(R"([[], {}, [[["deep"]]], -0.0, 1e-7, "A"])");
+    QTest::newRow("generated") << generatedDocument();
+}
+
+void tst_QJsonStreamReader::matchesDocument()
+{
+    QFETCH(QByteArray, json);
+
+    QJsonStreamReader reader(json);
+    reader.readNext();
+    const QJsonValue value = readValue(reader);
+    QVERIFY(!reader.hasError());
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+
+    const QJsonDocument document = QJsonDocument::fromJson(json);
+    QCOMPARE(value, document.isArray() ? QJsonValue(document.array())
+                                       : QJsonValue(document.object()));
+}
+
+void tst_QJsonStreamReader::errors_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QJsonParseError::ParseError>("error");
+    QTest::addColumn<qint64>("offset");
+
+    QTest::newRow("missing-value-separator") << QByteArray("[1 2]")
+                                             << QJsonParseError::MissingValueSeparator << qint64(3);
+    QTest::newRow("missing-name-separator") << QByteArray(R"({"a" 1})")
+                                            << QJsonParseError::MissingNameSeparator << qint64(5);
+    QTest::newRow("missing-member-separator") << QByteArray(R"({"a": 1 "b": 2})")
+                                              << QJsonParseError::UnterminatedObject << qint64(8);
+    QTest::newRow("name-not-string") << QByteArray("{1: 2}")
+                                     << QJsonParseError::UnterminatedObject << qint64(1);
+    QTest::newRow("trailing-comma-array") << QByteArray("[1,]")
+                                          << QJsonParseError::MissingObject << qint64(3);
+    QTest::newRow("trailing-comma-object") << QByteArray(R"({"a": 1,})")
+                                           << QJsonParseError::MissingObject << qint64(8);
+    QTest::newRow("missing-value") << QByteArray(R"({"a":,})")
+                                   << QJsonParseError::IllegalValue << qint64(5);
+    QTest::newRow("mismatched-end") << QByteArray("[1} ]")
+                                    << QJsonParseError::MissingValueSeparator << qint64(2);
+    QTest::newRow("bad-literal") << QByteArray("[tru ]")
+                                 << QJsonParseError::IllegalValue << qint64(1);
+    QTest::newRow("bad-number") << QByteArray("[-]")
+                                << QJsonParseError::IllegalNumber << qint64(1);
+    QTest::newRow("bad-escape") << QByteArray(R"(["\u12x4"])")
+                                << QJsonParseError::IllegalEscapeSequence << qint64(6);
+    QTest::newRow("bad-utf8") << QByteArray("[\"\xff\"]")
+                              << QJsonParseError::IllegalUTF8String << qint64(2);
+    QTest::newRow("deep-nesting") << QByteArray(1025, '[')
+                                  << QJsonParseError::DeepNesting << qint64(1024);
+}
+
+void tst_QJsonStreamReader::errors()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QJsonParseError::ParseError, error);
+    QFETCH(qint64, offset);
+
+    QJsonStreamReader reader(json);
+    while (reader.readNext() != QJsonStreamReader::Invalid)
+        QVERIFY(reader.tokenType() != QJsonStreamReader::NoToken);
+    QCOMPARE(reader.error(), error);
+    QVERIFY(reader.hasError());
+    QVERIFY(!reader.errorString().isEmpty());
+    QCOMPARE(reader.offset(), offset);
+    QVERIFY(reader.atEnd());
+
+    // the same error as QJsonDocument
+    QJsonParseError documentError;
+    QJsonDocument::fromJson(json, &documentError);
+    QCOMPARE(documentError.error, error);
+
+    // errors are fatal
+    reader.addData("[]");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), error);
+}
+
+void tst_QJsonStreamReader::prematureEnd_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QByteArray>("rest");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("array") << QByteArray("[1,") << QByteArray("2]") << "[ #1 #2 ]";
+    QTest::newRow("object") << QByteArray(R"({"a")") << QByteArray(":1}") << "{ a: #1 }";
+    QTest::newRow("name") << QByteArray(R"({"ab)") << QByteArray(R"(c":1})") << "{ abc: #1 }";
+    QTest::newRow("string") << QByteArray(R"(["ab)") << QByteArray(R"(c"])") << "[ \"abc\" ]";
+    QTest::newRow("escape") << QByteArray(R"(["\u00)") << QByteArray(R"(e4"])")
+                            << QStringLiteral("[ \"ä\" ]");
+    QTest::newRow("utf8") << QByteArray("[\"\xe2\x82") << QByteArray("\xac\"]")
+                          << QStringLiteral("[ \"€\" ]");
+    QTest::newRow("literal") << QByteArray("[tr") << QByteArray("ue]") << "[ true ]";
+    QTest::newRow("number") << QByteArray("[12") << QByteArray("3]") << "[ #123 ]";
+}
+
+void tst_QJsonStreamReader::prematureEnd()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QByteArray, rest);
+    QFETCH(QString, expected);
+
+    QStringList tokens;
+    QJsonStreamReader reader(json);
+    while (reader.readNext() != QJsonStreamReader::Invalid)
+        tokens.append(describeToken(reader));
+    QCOMPARE(reader.error(), QJsonParseError::PrematureEndOfDocument);
+    QVERIFY(reader.atEnd());
+
+    // the reader continues where it stopped
+    reader.addData(rest);
+    QVERIFY(!reader.atEnd());
+    while (reader.readNext() != QJsonStreamReader::NoToken) {
+        QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+        tokens.append(describeToken(reader));
+    }
+    QCOMPARE(tokens.join(u' '), expected);
+    QVERIFY(reader.atEnd());
+}
+
+void tst_QJsonStreamReader::incremental()
+{
+    QFETCH(QByteArray, json);
+
+    QJsonStreamReader reference(json);
+    const QString expected = readTokens(reference);
+
+    // supply the data one byte at a time
+    QStringList tokens;
+    QList<qint64> offsets;
+    QJsonStreamReader reader;
+    for (char c : std::as_const(json)) {
+        reader.addData(QByteArray(1, c));
+        while (reader.readNext() != QJsonStreamReader::NoToken) {
+            if (reader.hasError()) {
+                QCOMPARE(reader.error(), QJsonParseError::PrematureEndOfDocument);
+                break;
+            }
+            tokens.append(describeToken(reader));
+            offsets.append(reader.offset());
+        }
+    }
+    QCOMPARE(tokens.join(u' '), expected);
+
+    QJsonStreamReader whole(json);
+    for (qint64 offset : std::as_const(offsets)) {
+        whole.readNext();
+        QCOMPARE(whole.offset(), offset);
+    }
+}
+
+void tst_QJsonStreamReader::sequentialDevice()
+{
+    FeedDevice device;
+    QJsonStreamReader reader(&device);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+    QVERIFY(reader.atEnd());
+
+    device.feed("{\"n\": 1}\n12");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.depth(), 0);
+
+    // the number might continue
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), QJsonParseError::PrematureEndOfDocument);
+    QVERIFY(reader.atEnd());
+
+    device.feed("3\n");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.toInteger(), 123);
+    QCOMPARE(reader.offset(), 9);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+    QVERIFY(!reader.hasError());
+
+    // on a QByteArray, a number at the end is complete
+    QJsonStreamReader byteArrayReader(QByteArray("12"));
+    QCOMPARE(byteArrayReader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(byteArrayReader.toInteger(), 12);
+}
+
+void tst_QJsonStreamReader::largeStrings()
+{
+    // longer than what the reader reads from the device at once
+    const QString longString = QString(100000, u'x') + u'ä' + QString(100000, u'\n');
+    QByteArray json = QJsonDocument(QJsonArray{ longString, longString, 1 }).toJson();
+
+    QBuffer buffer(&json);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader reader(&buffer);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QCOMPARE(reader.text(), longString);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QCOMPARE(reader.text(), longString);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.offset(), json.lastIndexOf('1'));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+    QVERIFY(!reader.hasError());
+}
+
+void tst_QJsonStreamReader::skipValue()
+{
+    QJsonStreamReader reader(R"({"a": [1, {"b": [2]}], "c": {}, "d": 3, "e": "f"} 4)");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QVERIFY(reader.skipValue());
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::EndArray);
+    QCOMPARE(reader.depth(), 1);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QVERIFY(reader.skipValue());
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QVERIFY(reader.skipValue());
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::Number);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.text(), QStringLiteral("e"));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QVERIFY(reader.skipValue());
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::String);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.toInteger(), 4);
+
+    QJsonStreamReader incomplete(QByteArray("[[1, 2]"));
+    QCOMPARE(incomplete.readNext(), QJsonStreamReader::StartArray);
+    QVERIFY(!incomplete.skipValue());
+    QCOMPARE(incomplete.error(), QJsonParseError::PrematureEndOfDocument);
+}
+
+void tst_QJsonStreamReader::clear()
+{
+    QJsonStreamReader reader(QByteArray("[1,"));
+    reader.readNext();
+    reader.readNext();
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+
+    reader.clear();
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::NoToken);
+    QVERIFY(!reader.hasError());
+    QCOMPARE(reader.depth(), 0);
+    reader.addData("{}");
+    QCOMPARE(readTokens(reader), QStringLiteral("{ }"));
+
+    QByteArray json("[true]");
+    QBuffer buffer(&json);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    reader.setDevice(&buffer);
+    QCOMPARE(reader.device(), &buffer);
+    QCOMPARE(readTokens(reader), QStringLiteral("[ true ]"));
+
+    QTest::ignoreMessage(QtWarningMsg, "QJsonStreamReader: addData() with device()");
+    reader.addData("[]");
+}
+
+void tst_QJsonStreamReader::namePool()
+{
+    QStringPool pool;
+    QJsonStreamReader reader(QByteArray(R"([{"key": "key"}, {"k\u0065y": 1}])"));
+    QCOMPARE(reader.namePool(), nullptr);
+    reader.setNamePool(&pool);
+    QCOMPARE(reader.namePool(), &pool);
+
+    QList<QString> names;
+    QString value;
+    while (!reader.atEnd() && !reader.hasError()) {
+        const auto type = reader.readNext();
+        if (type == QJsonStreamReader::Name)
+            names.append(reader.text());
+        else if (type == QJsonStreamReader::String)
+            value = reader.text();
+    }
+    QVERIFY(!reader.hasError());
+    QCOMPARE(names, QStringList({ QStringLiteral("key"), QStringLiteral("key") }));
+    QCOMPARE(names.at(1).constData(), names.at(0).constData());
+    QCOMPARE(pool.size(), 1);
+
+    // only names are interned
+    QCOMPARE(value, u"key");
+    QVERIFY(value.constData() != names.at(0).constData());
+}
+
+QTEST_APPLESS_MAIN(tst_QJsonStreamReader)
+#include "tst_qjsonstreamreader.moc"
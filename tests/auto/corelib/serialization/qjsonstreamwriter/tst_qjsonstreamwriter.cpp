@@ -0,0 +1,283 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QTest>
+#include <QBuffer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonStreamWriter>
+
+class tst_QJsonStreamWriter : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase_data();
+    void matchesDocument_data();
+    void matchesDocument();
+    void appendValue_data() { matchesDocument_data(); }
+    void appendValue();
+    void scalars_data();
+    void scalars();
+    void strings();
+    void ndjson();
+    void device();
+    void misuse();
+};
+
+// writes \a value token by token
+static void writeValue(QJsonStreamWriter &writer, const QJsonValue &value)
+{
+    switch (value.type()) {
+    case QJsonValue::Array:
+        writer.startArray();
+        for (const QJsonValue element : value.toArray())
+            writeValue(writer, element);
+        QVERIFY(writer.endArray());
+        break;
+    case QJsonValue::Object: {
+        writer.startObject();
+        const QJsonObject object = value.toObject();
+        for (auto it = object.begin(); it != object.end(); ++it) {
+            writer.writeName(it.key());
+            writeValue(writer, it.value());
+        }
+        QVERIFY(writer.endObject());
+        break;
+    }
+    case QJsonValue::String:
+        writer.append(value.toString());
+        break;
+    case QJsonValue::Double:
+        if (value.toDouble() == double(value.toInteger()))
+            writer.append(value.toInteger());
+        else
+            writer.append(value.toDouble());
+        break;
+    case QJsonValue::Bool:
+        writer.append(value.toBool());
+        break;
+    case QJsonValue::Null:
+    case QJsonValue::Undefined:
+        writer.appendNull();
+        break;
+    }
+}
+
+static QByteArray toJson(const QJsonValue &value, QJsonDocument::JsonFormat format)
+{
+    const QJsonDocument document = value.isArray() ? QJsonDocument(value.toArray())
+                                                   : QJsonDocument(value.toObject());
+    QByteArray json = document.toJson(format);
+    if (format == QJsonDocument::Compact)
+        json += '\n';
+    return json;
+}
+
+void tst_QJsonStreamWriter::initTestCase_data()
+{
+    QTest::addColumn<QJsonDocument::JsonFormat>("format");
+
+    QTest::newRow("indented") << QJsonDocument::Indented;
+    QTest::newRow("compact") << QJsonDocument::Compact;
+}
+
+void tst_QJsonStreamWriter::matchesDocument_data()
+{
+    QTest::addColumn<QJsonValue>("value");
+
+    QTest::newRow("empty-array") << QJsonValue(QJsonArray());
+    QTest::newRow("empty-object") << QJsonValue(QJsonObject());
+    QTest::newRow("scalars")
+            << QJsonValue(QJsonArray{ true, false, QJsonValue::Null, 0, -1, 2.5, 1e100,
+                                      "text", QStringLiteral("ä€\U0001f600"), "\"\\\n\t\x01" });
+    QTest::newRow("nested")
+            << QJsonValue(QJsonObject{
+                   { "a", QJsonArray{ QJsonArray{}, QJsonObject{}, QJsonArray{ QJsonArray{ 1 } } } },
+                   { "b", QJsonObject{ { "c", QJsonObject{ { "d", "e" } } } } },
+                   { "escaped \"name\"", 3 },
+               });
+
+    QJsonArray users;
+    for (int i = 0; i < 100; ++i) {
+        users.append(QJsonObject{ { "id", i }, { "name", QStringLiteral("User %1").arg(i) },
+                                  { "score", i / 7. }, { "tags", QJsonArray{ "x", "y" } } });
+    }
+    QTest::newRow("generated") << QJsonValue(QJsonObject{ { "users", users } });
+}
+
+void tst_QJsonStreamWriter::matchesDocument()
+{
+    QFETCH_GLOBAL(QJsonDocument::JsonFormat, format);
+    QFETCH(QJsonValue, value);
+
+    QByteArray json;
+    {
+        QJsonStreamWriter writer(&json);
+        writer.setFormat(format);
+        QCOMPARE(writer.format(), format);
+        writeValue(writer, value);
+    }
+    QCOMPARE(json, toJson(value, format));
+}
+
+void tst_QJsonStreamWriter::appendValue()
+{
+    QFETCH_GLOBAL(QJsonDocument::JsonFormat, format);
+    QFETCH(QJsonValue, value);
+
+    QByteArray json;
+    QJsonStreamWriter writer(&json);
+    writer.setFormat(format);
+    writer.append(value);
+    QCOMPARE(json, toJson(value, format));
+
+    // nested in containers written by the stream writer
+    json.clear();
+    writer.startObject();
+    writer.writeName("outer");
+    writer.startArray();
+    writer.append(value);
+    writer.append(value);
+    QVERIFY(writer.endArray());
+    QVERIFY(writer.endObject());
+    QCOMPARE(json, toJson(QJsonObject{ { "outer", QJsonArray{ value, value } } }, format));
+}
+
+void tst_QJsonStreamWriter::scalars_data()
+{
+    QTest::addColumn<QJsonValue>("value");
+    QTest::addColumn<QByteArray>("expected");
+
+    QTest::newRow("null") << QJsonValue(QJsonValue::Null) << QByteArray("null\n");
+    QTest::newRow("undefined") << QJsonValue(QJsonValue::Undefined) << QByteArray("null\n");
+    QTest::newRow("true") << QJsonValue(true) << QByteArray("true\n");
+    QTest::newRow("integer") << QJsonValue(-42) << QByteArray("-42\n");
+    QTest::newRow("double") << QJsonValue(0.1) << QByteArray("0.1\n");
+    QTest::newRow("infinity") << QJsonValue(qInf()) << QByteArray("null\n");
+    QTest::newRow("string") << QJsonValue("a\"b") << QByteArray("\"a\\\"b\"\n");
+}
+
+void tst_QJsonStreamWriter::scalars()
+{
+    QFETCH_GLOBAL(QJsonDocument::JsonFormat, format);
+    QFETCH(QJsonValue, value);
+    QFETCH(QByteArray, expected);
+
+    QByteArray json;
+    QJsonStreamWriter writer(&json);
+    writer.setFormat(format);
+    writer.append(value);
+    QCOMPARE(json, expected);
+
+    if (value.isDouble()) {
+        json.clear();
+        writer.append(value.toDouble());
+        QCOMPARE(json, expected);
+    }
+}
+
+void tst_QJsonStreamWriter::strings()
+{
+    QFETCH_GLOBAL(QJsonDocument::JsonFormat, format);
+
+    QByteArray json;
+    QJsonStreamWriter writer(&json);
+    writer.setFormat(format);
+    writer.startArray();
+    writer.append("utf8 \xc3\xa4");
+    writer.append(QLatin1StringView("latin1 \xe4"));
+    writer.append(u"utf16 ä");
+    writer.append(QStringLiteral("string ä"));
+    writer.append(QUtf8StringView("view \xc3\xa4"));
+    QVERIFY(writer.endArray());
+
+    const QJsonArray expected{ QStringLiteral("utf8 ä"), QStringLiteral("latin1 ä"),
+                               QStringLiteral("utf16 ä"), QStringLiteral("string ä"),
+                               QStringLiteral("view ä") };
+    QCOMPARE(json, toJson(expected, format));
+}
+
+void tst_QJsonStreamWriter::ndjson()
+{
+    QFETCH_GLOBAL(QJsonDocument::JsonFormat, format);
+    if (format != QJsonDocument::Compact)
+        QSKIP("NDJSON requires the compact format");
+
+    QByteArray json;
+    QJsonStreamWriter writer(&json);
+    writer.setFormat(format);
+    for (int i = 0; i < 3; ++i) {
+        writer.startObject();
+        writer.writeName("id");
+        writer.append(i);
+        QVERIFY(writer.endObject());
+    }
+    writer.append(4);
+    QCOMPARE(json, QByteArray("{\"id\":0}\n{\"id\":1}\n{\"id\":2}\n4\n"));
+}
+
+void tst_QJsonStreamWriter::device()
+{
+    QFETCH_GLOBAL(QJsonDocument::JsonFormat, format);
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QJsonArray expected;
+    {
+        QJsonStreamWriter writer(&buffer);
+        QCOMPARE(writer.device(), &buffer);
+        writer.setFormat(format);
+        writer.startArray();
+        writer.append(1);
+        // the output is written in chunks
+        QVERIFY(buffer.data().size() < 2);
+        writer.flush();
+        QVERIFY(buffer.data().startsWith('['));
+        expected.append(1);
+
+        // more than a chunk
+        const QString text(1000, u'x');
+        for (int i = 0; i < 100; ++i) {
+            writer.append(text);
+            expected.append(text);
+        }
+        QVERIFY(buffer.data().size() > 16384);
+        QVERIFY(writer.endArray());
+        // a complete top-level value is written right away
+        QCOMPARE(buffer.data(), toJson(expected, format));
+
+        writer.startArray();
+    }
+    // the rest was written when the writer was destroyed
+    QCOMPARE(buffer.data(), toJson(expected, format)
+             + (format == QJsonDocument::Compact ? "[" : "[\n"));
+}
+
+void tst_QJsonStreamWriter::misuse()
+{
+    QByteArray json;
+    QJsonStreamWriter writer(&json);
+
+    QVERIFY(!writer.endArray());
+    QVERIFY(!writer.endObject());
+    QTest::ignoreMessage(QtWarningMsg, "QJsonStreamWriter: writeName() must be followed by a "
+                                       "value and can only be used inside an object");
+    writer.writeName("outside");
+    QVERIFY(json.isEmpty());
+
+    writer.startArray();
+    QVERIFY(!writer.endObject());
+    QVERIFY(writer.endArray());
+
+    writer.startObject();
+    writer.writeName("a");
+    // the value is missing
+    QVERIFY(!writer.endObject());
+    writer.append(1);
+    QVERIFY(writer.endObject());
+    QCOMPARE(json, QByteArray("[\n]\n{\n    \"a\": 1\n}\n"));
+}
+
+QTEST_APPLESS_MAIN(tst_QJsonStreamWriter)
+#include "tst_qjsonstreamwriter.moc"
@@ -133,6 +133,8 @@ private slots:
 
     void utf8Codec_data();
     void utf8Codec();
+    void utf8LongText_data();
+    void utf8LongText();
 
     void utf8bom_data();
     void utf8bom();
@@ -1464,6 +1466,53 @@ void tst_QStringConverter::utf8Codec()
     QCOMPARE(str, res);
 }
 
+void tst_QStringConverter::utf8LongText_data()
+{
+    QTest::addColumn<QByteArray>("error");
+
+    QTest::newRow("none") << QByteArray();
+    QTest::newRow("invalid-byte") << QByteArray("\xff");
+    QTest::newRow("continuation") << QByteArray("\x80");
+    QTest::newRow("truncated-2") << QByteArray("\xd0");
+    QTest::newRow("truncated-3") << QByteArray("\xe6\x96");
+    QTest::newRow("truncated-4") << QByteArray("\xf0\x9f\x98");
+    QTest::newRow("overlong-2") << QByteArray("\xc1\xbf");
+    QTest::newRow("overlong-3") << QByteArray("\xe0\x9f\xbf");
+    QTest::newRow("overlong-4") << QByteArray("\xf0\x8f\xbf\xbf");
+    QTest::newRow("surrogate") << QByteArray("\xed\xa0\x80");
+    QTest::newRow("too-large") << QByteArray("\xf4\x90\x80\x80");
+}
+
+void tst_QStringConverter::utf8LongText()
+{
+    // long enough and with few enough US-ASCII characters to go through the
+    // SIMD code, if any
+    QFETCH(QByteArray, error);
+    QString text;
+    while (text.size() < 300)
+        text += u"Grün слово 文字列 \U0001F600 текст Ærø ελληνικά ";
+    const QByteArray utf8 = text.toUtf8();
+    QCOMPARE(QString::fromUtf8(utf8), text);
+    QVERIFY(QUtf8StringView(utf8).isValidUtf8());
+
+    if (error.isEmpty())
+        return;
+
+    for (qsizetype i = 0; i < utf8.size(); ++i) {
+        if ((utf8.at(i) & 0xc0) == 0x80)
+            continue;
+
+        // the error never swallows the character that follows it
+        const QByteArray invalid = utf8.first(i) + error + utf8.sliced(i);
+        const QString expected = QString::fromUtf8(utf8.first(i)) + QString::fromUtf8(error)
+                + QString::fromUtf8(utf8.sliced(i));
+        QVERIFY(expected.contains(QChar::ReplacementCharacter));
+
+        QCOMPARE(QString::fromUtf8(invalid), expected);
+        QVERIFY(!QUtf8StringView(invalid).isValidUtf8());
+    }
+}
+
 QT_WARNING_PUSH
 QT_WARNING_DISABLE_DEPRECATED
 void tst_QStringConverter::utf8bom_data()
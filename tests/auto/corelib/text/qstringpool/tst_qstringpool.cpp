@@ -0,0 +1,152 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QTest>
+#include <QStringPool>
+#include <QThread>
+
+#include <memory>
+#include <vector>
+
+class tst_QStringPool : public QObject
+{
+    Q_OBJECT
+private slots:
+    void intern();
+    void internByteArray();
+    void sharesOrCopies();
+    void empty();
+    void containsAndClear();
+    void globalInstance();
+    void concurrentIntern();
+};
+
+void tst_QStringPool::intern()
+{
+    QStringPool pool;
+    QVERIFY(pool.isEmpty());
+
+    const QString first = pool.intern(u"name");
+    const QString second = pool.intern(QStringLiteral("name"));
+    const QString third = pool.intern(QStringView(u"a name").mid(2));
+    QCOMPARE(first, u"name");
+    QCOMPARE(second.constData(), first.constData());
+    QCOMPARE(third.constData(), first.constData());
+
+    const QString other = pool.intern(u"value");
+    QCOMPARE(other, u"value");
+    QVERIFY(other.constData() != first.constData());
+    QCOMPARE(pool.size(), 2);
+}
+
+void tst_QStringPool::internByteArray()
+{
+    QStringPool pool;
+    const QByteArray first = pool.intern(QByteArrayView("text/plain"));
+    const QByteArray second = pool.intern(QByteArray("text/plain"));
+    QCOMPARE(first, "text/plain");
+    QCOMPARE(second.constData(), first.constData());
+
+    // strings and byte arrays are pooled separately
+    QVERIFY(!pool.contains(QStringView(u"text/plain")));
+    QCOMPARE(pool.size(), 1);
+}
+
+void tst_QStringPool::sharesOrCopies()
+{
+    QStringPool pool;
+
+    // a compact, reference-counted string is kept as it is
+    const QString owned = QString::number(123456);
+    QCOMPARE(owned.capacity(), owned.size());
+    QCOMPARE(pool.intern(owned).constData(), owned.constData());
+
+    // raw data may be freed by the caller, so it is copied
+    static const QChar data[] = { u'r', u'a', u'w' };
+    const QString raw = QString::fromRawData(data, 3);
+    const QString interned = pool.intern(raw);
+    QCOMPARE(interned, u"raw");
+    QVERIFY(interned.constData() != data);
+
+    // unused capacity is not kept alive by the pool
+    QString large = QStringLiteral("large");
+    large.reserve(1000);
+    const QString compact = pool.intern(large);
+    QCOMPARE(compact, large);
+    QVERIFY(compact.constData() != large.constData());
+    QVERIFY(compact.capacity() < 1000);
+
+    // modifying an interned string detaches it
+    QString copy = pool.intern(owned);
+    copy[0] = u'x';
+    QCOMPARE(pool.intern(u"123456").constData(), owned.constData());
+}
+
+void tst_QStringPool::empty()
+{
+    QStringPool pool;
+    QVERIFY(pool.intern(QString()).isNull());
+    QVERIFY(pool.intern(u"").isEmpty());
+    QVERIFY(pool.intern(QByteArray()).isNull());
+    QVERIFY(pool.intern(QByteArrayView("")).isEmpty());
+    QVERIFY(pool.isEmpty());
+}
+
+void tst_QStringPool::containsAndClear()
+{
+    QStringPool pool;
+    const QString key = pool.intern(u"key");
+    pool.intern(QByteArrayView("key"));
+    QVERIFY(pool.contains(QStringView(u"key")));
+    QVERIFY(pool.contains(QByteArrayView("key")));
+    QVERIFY(!pool.contains(QStringView(u"other")));
+    QCOMPARE(pool.size(), 2);
+
+    pool.clear();
+    QVERIFY(pool.isEmpty());
+    QVERIFY(!pool.contains(QStringView(u"key")));
+    QCOMPARE(key, u"key");
+
+    // strings interned before clear() are not shared with those interned after
+    QVERIFY(pool.intern(u"key").constData() != key.constData());
+}
+
+void tst_QStringPool::globalInstance()
+{
+    QStringPool *pool = QStringPool::globalInstance();
+    QVERIFY(pool);
+    QCOMPARE(QStringPool::globalInstance(), pool);
+
+    const QString first = pool->intern(u"tst_QStringPool::globalInstance");
+    const QString second = QStringPool::globalInstance()->intern(QString(first));
+    QCOMPARE(second.constData(), first.constData());
+}
+
+void tst_QStringPool::concurrentIntern()
+{
+    constexpr int ThreadCount = 8;
+    constexpr int KeyCount = 500;
+    QStringPool pool;
+    QList<QString> results[ThreadCount];
+
+    std::vector<std::unique_ptr<QThread>> threads;
+    for (int t = 0; t < ThreadCount; ++t) {
+        threads.emplace_back(QThread::create([&pool, &results, t] {
+            for (int i = 0; i < KeyCount; ++i)
+                results[t].append(pool.intern(QString::number(i)));
+        }));
+    }
+    for (auto &thread : threads)
+        thread->start();
+    for (auto &thread : threads)
+        QVERIFY(thread->wait(60000));
+
+    QCOMPARE(pool.size(), KeyCount);
+    for (int t = 1; t < ThreadCount; ++t) {
+        for (int i = 0; i < KeyCount; ++i)
+            QCOMPARE(results[t].at(i).constData(), results[0].at(i).constData());
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_QStringPool)
+#include "tst_qstringpool.moc"
@@ -224,6 +224,8 @@ private slots:
 
     void unwrap();
 
+    void coroutines();
+
 private:
     using size_type = std::vector<int>::size_type;
 
@@ -4906,5 +4908,103 @@ void tst_QFuture::unwrap()
     }
 }
 
+#if defined(__cpp_impl_coroutine) && defined(__cpp_lib_coroutine)
+static QFuture<int> addOne(QFuture<int> future)
+{
+    co_return co_await future + 1;
+}
+
+static QFuture<void> hopThreads(QThreadPool *pool, QObject *context, QThread **poolThread,
+                                QThread **contextThread)
+{
+    co_await QtFuture::resumeOn(pool);
+    *poolThread = QThread::currentThread();
+    co_await QtFuture::resumeOn(context);
+    *contextThread = QThread::currentThread();
+}
+
+static QFuture<int> resumeOnContext(QObject *context)
+{
+    co_await QtFuture::resumeOn(context);
+    co_return 1;
+}
+#endif
+
+void tst_QFuture::coroutines()
+{
+#if defined(__cpp_impl_coroutine) && defined(__cpp_lib_coroutine)
+    {
+        // a finished future doesn't suspend the coroutine
+        QFuture<int> f = addOne(QtFuture::makeReadyFuture(41));
+        QVERIFY(f.isFinished());
+        QCOMPARE(f.result(), 42);
+    }
+
+    {
+        // resume when the promise delivers
+        QPromise<int> promise;
+        promise.start();
+        QFuture<int> f = addOne(promise.future());
+        QVERIFY(f.isStarted());
+        QVERIFY(!f.isFinished());
+        promise.addResult(1);
+        promise.finish();
+        QVERIFY(f.isFinished());
+        QCOMPARE(f.result(), 2);
+    }
+
+    {
+        // cancellation propagates
+        QPromise<int> promise;
+        promise.start();
+        QFuture<int> f = addOne(promise.future());
+        promise.future().cancel();
+        promise.finish();
+        QVERIFY(f.isFinished());
+        QVERIFY(f.isCanceled());
+    }
+
+#ifndef QT_NO_EXCEPTIONS
+    {
+        // so do exceptions
+        QPromise<int> promise;
+        promise.start();
+        QFuture<int> f = addOne(promise.future());
+        promise.setException(QException());
+        promise.finish();
+        QVERIFY(f.isFinished());
+        QVERIFY_THROWS_EXCEPTION(QException, f.waitForFinished());
+    }
+#endif
+
+    {
+        // move between threads
+        QThreadPool pool;
+        QObject context;
+        QThread *poolThread = nullptr;
+        QThread *contextThread = nullptr;
+        QFuture<void> f = hopThreads(&pool, &context, &poolThread, &contextThread);
+        QTRY_VERIFY(f.isFinished());
+        QVERIFY(poolThread);
+        QVERIFY(poolThread != QThread::currentThread());
+        QCOMPARE(contextThread, QThread::currentThread());
+    }
+
+    {
+        // destroying the context before the coroutine could resume cancels it
+        QThread thread;
+        QObject *context = new QObject;
+        context->moveToThread(&thread);
+        QFuture<int> f = resumeOnContext(context);
+        QVERIFY(!f.isFinished());
+        delete context;
+        QVERIFY(f.isFinished());
+        QVERIFY(f.isCanceled());
+    }
+#else
+    QSKIP("This test requires C++20 coroutines");
+#endif
+}
+
 QTEST_MAIN(tst_QFuture)
 #include "tst_qfuture.moc"
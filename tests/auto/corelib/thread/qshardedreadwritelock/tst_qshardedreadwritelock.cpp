@@ -0,0 +1,226 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QTest>
+#include <QAtomicInt>
+#include <QSemaphore>
+#include <QShardedReadWriteLock>
+#include <QThread>
+
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+class tst_QShardedReadWriteLock : public QObject
+{
+    Q_OBJECT
+private slots:
+    void readLockUnlock();
+    void writeLockUnlock();
+    void readersShareTheLock();
+    void writerExcludesEveryone();
+    void writerWaitsForReaders();
+    void waitingWriterBlocksNewReaders();
+    void timedWriteGivesUp();
+    void stdLockers();
+    void readersAndWriters();
+};
+
+// runs \a function in a new thread and returns its result
+template <typename Function>
+static bool inOtherThread(Function function)
+{
+    bool result = false;
+    std::unique_ptr<QThread> thread(QThread::create([&] { result = function(); }));
+    thread->start();
+    thread->wait();
+    return result;
+}
+
+void tst_QShardedReadWriteLock::readLockUnlock()
+{
+    QShardedReadWriteLock lock;
+    for (int i = 0; i < 100; ++i) {
+        lock.lockForRead();
+        lock.unlock();
+    }
+    QVERIFY(lock.tryLockForRead());
+    lock.unlock_shared();
+    QVERIFY(lock.tryLockForRead(10ms));
+    lock.unlock();
+}
+
+void tst_QShardedReadWriteLock::writeLockUnlock()
+{
+    QShardedReadWriteLock lock;
+    for (int i = 0; i < 100; ++i) {
+        lock.lockForWrite();
+        lock.unlock();
+    }
+    QVERIFY(lock.tryLockForWrite());
+    lock.unlock();
+    // after unlocking for write, reading is possible again
+    QVERIFY(lock.tryLockForRead());
+    lock.unlock();
+}
+
+void tst_QShardedReadWriteLock::readersShareTheLock()
+{
+    QShardedReadWriteLock lock;
+    lock.lockForRead();
+    QVERIFY(inOtherThread([&] {
+        if (!lock.tryLockForRead())
+            return false;
+        lock.unlock();
+        return true;
+    }));
+    QVERIFY(inOtherThread([&] { return !lock.tryLockForWrite(); }));
+    QVERIFY(inOtherThread([&] { return !lock.tryLockForWrite(10); }));
+    lock.unlock();
+    QVERIFY(inOtherThread([&] {
+        if (!lock.tryLockForWrite())
+            return false;
+        lock.unlock();
+        return true;
+    }));
+}
+
+void tst_QShardedReadWriteLock::writerExcludesEveryone()
+{
+    QShardedReadWriteLock lock;
+    lock.lockForWrite();
+    QVERIFY(inOtherThread([&] { return !lock.tryLockForRead(); }));
+    QVERIFY(inOtherThread([&] { return !lock.tryLockForRead(10); }));
+    QVERIFY(inOtherThread([&] { return !lock.tryLockForWrite(); }));
+    QVERIFY(inOtherThread([&] { return !lock.tryLockForWrite(10); }));
+    lock.unlock();
+    QVERIFY(inOtherThread([&] {
+        if (!lock.tryLockForRead())
+            return false;
+        lock.unlock();
+        return true;
+    }));
+}
+
+void tst_QShardedReadWriteLock::writerWaitsForReaders()
+{
+    QShardedReadWriteLock lock;
+    QAtomicInt writing;
+    lock.lockForRead();
+    std::unique_ptr<QThread> writer(QThread::create([&] {
+        lock.lockForWrite();
+        writing.storeRelaxed(1);
+        lock.unlock();
+    }));
+    writer->start();
+    QVERIFY(!writer->wait(50));
+    QCOMPARE(writing.loadRelaxed(), 0);
+    lock.unlock();
+    QVERIFY(writer->wait());
+    QCOMPARE(writing.loadRelaxed(), 1);
+}
+
+void tst_QShardedReadWriteLock::waitingWriterBlocksNewReaders()
+{
+    QShardedReadWriteLock lock;
+    lock.lockForRead();
+    std::unique_ptr<QThread> writer(QThread::create([&] {
+        lock.lockForWrite();
+        lock.unlock();
+    }));
+    writer->start();
+    // once the writer is waiting, other readers have to wait for it
+    QTRY_VERIFY(inOtherThread([&] {
+        if (!lock.tryLockForRead())
+            return true;
+        lock.unlock();
+        return false;
+    }));
+    lock.unlock();
+    QVERIFY(writer->wait());
+}
+
+void tst_QShardedReadWriteLock::timedWriteGivesUp()
+{
+    QShardedReadWriteLock lock;
+    lock.lockForRead();
+    QVERIFY(inOtherThread([&] { return !lock.tryLockForWrite(20ms); }));
+    // the readers that were turned away meanwhile aren't blocked anymore
+    QVERIFY(inOtherThread([&] {
+        if (!lock.tryLockForRead())
+            return false;
+        lock.unlock();
+        return true;
+    }));
+    lock.unlock();
+}
+
+void tst_QShardedReadWriteLock::stdLockers()
+{
+    QShardedReadWriteLock lock;
+    {
+        std::shared_lock reader(lock);
+        QVERIFY(inOtherThread([&] {
+            std::shared_lock otherReader(lock, std::try_to_lock);
+            return otherReader.owns_lock();
+        }));
+        QVERIFY(inOtherThread([&] {
+            std::unique_lock writer(lock, std::try_to_lock);
+            return !writer.owns_lock();
+        }));
+    }
+    {
+        std::unique_lock writer(lock);
+        QVERIFY(inOtherThread([&] {
+            std::shared_lock reader(lock, std::try_to_lock);
+            return !reader.owns_lock();
+        }));
+    }
+    QVERIFY(lock.tryLockForWrite());
+    lock.unlock();
+}
+
+void tst_QShardedReadWriteLock::readersAndWriters()
+{
+    constexpr int ThreadCount = 8;
+    constexpr int Iterations = 2000;
+
+    QShardedReadWriteLock lock;
+    // only ever changed together, under the write lock
+    int first = 0;
+    int second = 0;
+    QAtomicInt inconsistencies;
+
+    std::vector<std::unique_ptr<QThread>> threads;
+    for (int i = 0; i < ThreadCount; ++i) {
+        threads.emplace_back(QThread::create([&, i] {
+            for (int j = 0; j < Iterations; ++j) {
+                if (j % 50 == i) {
+                    lock.lockForWrite();
+                    ++first;
+                    ++second;
+                    lock.unlock();
+                } else {
+                    lock.lockForRead();
+                    if (first != second)
+                        inconsistencies.ref();
+                    lock.unlock();
+                }
+            }
+        }));
+    }
+    for (const auto &thread : threads)
+        thread->start();
+    for (const auto &thread : threads)
+        QVERIFY(thread->wait());
+
+    QCOMPARE(inconsistencies.loadRelaxed(), 0);
+    QCOMPARE(first, ThreadCount * (Iterations / 50));
+    QCOMPARE(second, first);
+}
+
+QTEST_MAIN(tst_QShardedReadWriteLock)
+#include "tst_qshardedreadwritelock.moc"
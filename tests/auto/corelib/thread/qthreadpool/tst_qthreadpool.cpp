@@ -83,6 +83,8 @@ private slots:
     void takeAllAndIncreaseMaxThreadCount();
     void waitForDoneAfterTake();
     void threadReuse();
+    void workStealing();
+    void workStealingClearAndTake();
 
 private:
     QMutex m_functionTestMutex;
@@ -1435,5 +1437,88 @@ void tst_QThreadPool::threadReuse()
     }
 }
 
+void tst_QThreadPool::workStealing()
+{
+    QThreadPool pool;
+    pool.setMaxThreadCount(4);
+    QVERIFY(!pool.isWorkStealingEnabled());
+    pool.setWorkStealingEnabled(true);
+    QVERIFY(pool.isWorkStealingEnabled());
+
+    // recursively split a range, starting the upper half of each split from
+    // the worker thread, so that it ends up in the worker's local queue
+    constexpr int count = 10000;
+    QAtomicInt sum;
+    std::function<void(int, int)> split = [&](int begin, int end) {
+        while (end - begin > 1) {
+            const int mid = begin + (end - begin) / 2;
+            pool.start([&split, mid, end] { split(mid, end); });
+            end = mid;
+        }
+        sum.fetchAndAddRelaxed(begin);
+    };
+    pool.start([&split] { split(0, count); });
+    QVERIFY(pool.waitForDone());
+    QCOMPARE(sum.loadRelaxed(), count * (count - 1) / 2);
+
+    // a worker that releases its thread while blocking on runnables it
+    // queued locally must get them run by another thread
+    pool.setMaxThreadCount(1);
+    QSemaphore done;
+    pool.start([&pool, &done] {
+        for (int i = 0; i < 10; ++i)
+            pool.start([&done] { done.release(); });
+        pool.releaseThread();
+        const bool acquired = done.tryAcquire(10, 10000);
+        pool.reserveThread();
+        QVERIFY(acquired);
+    });
+    QVERIFY(pool.waitForDone());
+    QCOMPARE(done.available(), 0);
+}
+
+void tst_QThreadPool::workStealingClearAndTake()
+{
+    QThreadPool pool;
+    pool.setMaxThreadCount(1);
+    pool.setWorkStealingEnabled(true);
+
+    QSemaphore queued;
+    QSemaphore proceed;
+    QAtomicInt runs;
+    auto counting = [&runs] { runs.ref(); };
+    QRunnable *kept = QRunnable::create(counting);
+    kept->setAutoDelete(false);
+
+    pool.start([&] {
+        for (int i = 0; i < 5; ++i)
+            pool.start(counting);
+        pool.start(kept);
+        queued.release();
+        proceed.acquire();
+    });
+    QVERIFY(queued.tryAcquire(1, 10000));
+    QVERIFY(pool.tryTake(kept));
+    QVERIFY(!pool.tryTake(kept));
+    pool.clear();
+    proceed.release();
+    QVERIFY(pool.waitForDone());
+    QCOMPARE(runs.loadRelaxed(), 0);
+    delete kept;
+
+    // disabling work stealing hands locally queued runnables back to the pool
+    pool.start([&] {
+        for (int i = 0; i < 5; ++i)
+            pool.start(counting);
+        queued.release();
+        proceed.acquire();
+    });
+    QVERIFY(queued.tryAcquire(1, 10000));
+    pool.setWorkStealingEnabled(false);
+    proceed.release();
+    QVERIFY(pool.waitForDone());
+    QCOMPARE(runs.loadRelaxed(), 5);
+}
+
 QTEST_MAIN(tst_QThreadPool);
 #include "tst_qthreadpool.moc"
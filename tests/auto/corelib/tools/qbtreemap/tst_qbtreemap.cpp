@@ -0,0 +1,399 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QTest>
+#include <QBTreeMap>
+#include <QRandomGenerator>
+#include <QString>
+
+#include <map>
+
+class tst_QBTreeMap : public QObject
+{
+    Q_OBJECT
+private slots:
+    void empty();
+    void insertAndLookup();
+    void subscriptOperator();
+    void iteration();
+    void bounds();
+    void firstAndLast();
+    void erase();
+    void removeAndTake();
+    void implicitSharing();
+    void comparison();
+    void qmapConversion();
+    void randomOperations_data();
+    void randomOperations();
+    void elementLifetime();
+};
+
+void tst_QBTreeMap::empty()
+{
+    QBTreeMap<int, int> map;
+    QVERIFY(map.isEmpty());
+    QCOMPARE(map.size(), 0);
+    QVERIFY(!map.contains(1));
+    QCOMPARE(map.value(1, 2), 2);
+    QVERIFY(map.constBegin() == map.constEnd());
+    QVERIFY(map.constFind(1) == map.constEnd());
+    QVERIFY(map.lowerBound(1) == map.end());
+    QVERIFY(map.keys().isEmpty());
+    QCOMPARE(map.remove(1), 0);
+    QCOMPARE(map.take(1), 0);
+    map.clear();
+    QVERIFY(map.isEmpty());
+}
+
+void tst_QBTreeMap::insertAndLookup()
+{
+    QBTreeMap<QString, int> map;
+    for (int i = 0; i < 1000; ++i) {
+        auto it = map.insert(QString::number(i), i);
+        QCOMPARE(it.key(), QString::number(i));
+        QCOMPARE(it.value(), i);
+    }
+    QCOMPARE(map.size(), 1000);
+    for (int i = 0; i < 1000; ++i) {
+        QVERIFY(map.contains(QString::number(i)));
+        QCOMPARE(map.value(QString::number(i)), i);
+        QCOMPARE(map.find(QString::number(i)).value(), i);
+    }
+    QVERIFY(!map.contains(QStringLiteral("x")));
+    QVERIFY(map.find(QStringLiteral("x")) == map.end());
+
+    // insert() replaces the value of an existing key
+    map.insert(QStringLiteral("7"), 70);
+    QCOMPARE(map.size(), 1000);
+    QCOMPARE(map.value(QStringLiteral("7")), 70);
+    QCOMPARE(map.key(70), QStringLiteral("7"));
+    QCOMPARE(map.key(-1, QStringLiteral("none")), QStringLiteral("none"));
+
+    // a key that is an element of the map itself
+    map.insert(map.firstKey(), -1);
+    QCOMPARE(map.first(), -1);
+    QCOMPARE(map.size(), 1000);
+}
+
+void tst_QBTreeMap::subscriptOperator()
+{
+    QBTreeMap<int, QString> map;
+    map[5] = QStringLiteral("five");
+    QCOMPARE(map.size(), 1);
+    QCOMPARE(map[5], QStringLiteral("five"));
+    QCOMPARE(map[6], QString());
+    QCOMPARE(map.size(), 2);
+
+    const QBTreeMap<int, QString> &constMap = map;
+    QCOMPARE(constMap[7], QString());
+    QCOMPARE(map.size(), 2);
+
+    for (int i = 0; i < 1000; ++i)
+        map[i] += QLatin1Char('x');
+    QCOMPARE(map.size(), 1000);
+    QCOMPARE(map[5], QStringLiteral("fivex"));
+    QCOMPARE(map[999], QStringLiteral("x"));
+}
+
+void tst_QBTreeMap::iteration()
+{
+    QBTreeMap<int, int> map;
+    // in an order that exercises all kinds of splits
+    for (int i = 0; i < 5000; ++i)
+        map.insert((i * 7919) % 5000, i);
+    QCOMPARE(map.size(), 5000);
+
+    int expected = 0;
+    for (auto it = map.cbegin(); it != map.cend(); ++it)
+        QCOMPARE(it.key(), expected++);
+    QCOMPARE(expected, 5000);
+
+    // backwards
+    auto it = map.cend();
+    while (it != map.cbegin()) {
+        --it;
+        QCOMPARE(it.key(), --expected);
+    }
+    QCOMPARE(expected, 0);
+
+    // modifying the values through iterators
+    for (auto it = map.begin(); it != map.end(); ++it)
+        it.value() = it.key() * 2;
+    for (int &value : map)
+        value += 1;
+    QCOMPARE(map.value(100), 201);
+
+    QList<int> keys = map.keys();
+    QCOMPARE(keys.size(), 5000);
+    QVERIFY(std::is_sorted(keys.cbegin(), keys.cend()));
+    QCOMPARE(map.values().at(10), 21);
+
+    // STL algorithms
+    QCOMPARE(std::distance(map.cbegin(), map.cend()), 5000);
+    QCOMPARE(*std::prev(map.cend()), 9999);
+}
+
+void tst_QBTreeMap::bounds()
+{
+    QBTreeMap<int, int> map;
+    for (int i = 0; i < 2000; i += 2)
+        map.insert(i, i);
+
+    for (int i = -1; i <= 2000; ++i) {
+        const auto lower = map.lowerBound(i);
+        const auto upper = map.upperBound(i);
+        const int expectedLower = i < 0 ? 0 : (i + 1) / 2 * 2;
+        const int expectedUpper = i < 0 ? 0 : i / 2 * 2 + 2;
+        if (expectedLower >= 2000)
+            QVERIFY(lower == map.cend());
+        else
+            QCOMPARE(lower.key(), expectedLower);
+        if (expectedUpper >= 2000)
+            QVERIFY(upper == map.cend());
+        else
+            QCOMPARE(upper.key(), expectedUpper);
+    }
+}
+
+void tst_QBTreeMap::firstAndLast()
+{
+    QBTreeMap<int, int> map{ { 3, 30 }, { 1, 10 }, { 2, 20 } };
+    QCOMPARE(map.firstKey(), 1);
+    QCOMPARE(map.first(), 10);
+    QCOMPARE(map.lastKey(), 3);
+    QCOMPARE(map.last(), 30);
+    map.first() = 11;
+    map.last() = 31;
+    QCOMPARE(map.value(1), 11);
+    QCOMPARE(map.value(3), 31);
+}
+
+void tst_QBTreeMap::erase()
+{
+    QBTreeMap<int, int> map;
+    for (int i = 0; i < 3000; ++i)
+        map.insert(i, i);
+
+    // remove the multiples of 3 while iterating
+    for (auto it = map.begin(); it != map.end();) {
+        if (it.key() % 3 == 0)
+            it = map.erase(it);
+        else
+            ++it;
+    }
+    QCOMPARE(map.size(), 2000);
+    for (auto it = map.cbegin(); it != map.cend(); ++it)
+        QVERIFY(it.key() % 3 != 0);
+
+    // remove everything from the front
+    while (!map.isEmpty()) {
+        const int first = map.firstKey();
+        auto next = map.erase(map.cbegin());
+        if (!map.isEmpty())
+            QVERIFY(next.key() > first);
+    }
+    QVERIFY(map.cbegin() == map.cend());
+
+    // the map is usable after running empty
+    map.insert(1, 1);
+    QCOMPARE(map.size(), 1);
+}
+
+void tst_QBTreeMap::removeAndTake()
+{
+    QBTreeMap<int, QString> map;
+    for (int i = 0; i < 500; ++i)
+        map.insert(i, QString::number(i));
+
+    QCOMPARE(map.remove(10), 1);
+    QCOMPARE(map.remove(10), 0);
+    QCOMPARE(map.take(20), QStringLiteral("20"));
+    QCOMPARE(map.take(20), QString());
+    QCOMPARE(map.size(), 498);
+
+    // a key that is an element of the map itself
+    QCOMPARE(map.remove(map.lastKey()), 1);
+    QVERIFY(!map.contains(499));
+
+    // remove everything from the back
+    for (int i = 498; i >= 0; --i)
+        map.remove(i);
+    QVERIFY(map.isEmpty());
+}
+
+void tst_QBTreeMap::implicitSharing()
+{
+    QBTreeMap<int, QString> map;
+    for (int i = 0; i < 1000; ++i)
+        map.insert(i, QString::number(i));
+
+    QBTreeMap<int, QString> copy = map;
+    QVERIFY(copy.isSharedWith(map));
+    QVERIFY(!map.isDetached());
+
+    copy.insert(1000, QStringLiteral("new"));
+    QVERIFY(!copy.isSharedWith(map));
+    QVERIFY(map.isDetached());
+    QCOMPARE(map.size(), 1000);
+    QCOMPARE(copy.size(), 1001);
+
+    QBTreeMap<int, QString> copy2 = map;
+    copy2.remove(5);
+    QVERIFY(map.contains(5));
+    QVERIFY(!copy2.contains(5));
+
+    QBTreeMap<int, QString> copy3 = map;
+    *copy3.find(6) = QStringLiteral("six");
+    QCOMPARE(map.value(6), QStringLiteral("6"));
+    QCOMPARE(copy3.value(6), QStringLiteral("six"));
+
+    // erasing through an iterator into the shared data
+    QBTreeMap<int, QString> copy4 = map;
+    auto it = copy4.erase(map.constFind(7));
+    QCOMPARE(it.key(), 8);
+    QVERIFY(map.contains(7));
+    QVERIFY(!copy4.contains(7));
+
+    // the copies iterate in order, including over the leaf links
+    int expected = 0;
+    for (auto it = copy.cbegin(); it != copy.cend(); ++it)
+        QCOMPARE(it.key(), expected++);
+    QCOMPARE(expected, 1001);
+
+    QBTreeMap<int, QString> copy5 = map;
+    copy5.clear();
+    QVERIFY(copy5.isEmpty());
+    QCOMPARE(map.size(), 1000);
+}
+
+void tst_QBTreeMap::comparison()
+{
+    QBTreeMap<int, int> a{ { 1, 1 }, { 2, 2 } };
+    QBTreeMap<int, int> b{ { 2, 2 }, { 1, 1 } };
+    QVERIFY(a == b);
+    b.insert(2, 3);
+    QVERIFY(a != b);
+    b.insert(2, 2);
+    b.insert(3, 3);
+    QVERIFY(a != b);
+    QVERIFY((QBTreeMap<int, int>() == QBTreeMap<int, int>()));
+}
+
+void tst_QBTreeMap::qmapConversion()
+{
+    QMap<QString, QVariant> variantMap;
+    for (int i = 0; i < 300; ++i)
+        variantMap.insert(QString::number(i), i);
+
+    const QBTreeMap<QString, QVariant> map(variantMap);
+    QCOMPARE(map.size(), 300);
+    QCOMPARE(map.keys(), variantMap.keys());
+    QCOMPARE(map.values(), variantMap.values());
+    QCOMPARE(map.toMap(), variantMap);
+}
+
+void tst_QBTreeMap::randomOperations_data()
+{
+    QTest::addColumn<int>("keyRange");
+    QTest::addColumn<int>("operations");
+
+    QTest::newRow("small") << 50 << 2000;
+    QTest::newRow("medium") << 2000 << 20000;
+    QTest::newRow("large") << 50000 << 200000;
+}
+
+void tst_QBTreeMap::randomOperations()
+{
+    QFETCH(int, keyRange);
+    QFETCH(int, operations);
+
+    QRandomGenerator rng(keyRange);
+    std::map<int, int> reference;
+    QBTreeMap<int, int> map;
+    QBTreeMap<int, int> snapshot;
+
+    for (int i = 0; i < operations; ++i) {
+        const int key = int(rng.bounded(keyRange));
+        switch (rng.bounded(8)) {
+        case 0:
+        case 1:
+        case 2:
+            map.insert(key, i);
+            reference[key] = i;
+            break;
+        case 3:
+        case 4:
+            QCOMPARE(map.remove(key), qsizetype(reference.erase(key)));
+            break;
+        case 5:
+            QCOMPARE(map.value(key, -1), reference.count(key) ? reference[key] : -1);
+            break;
+        case 6: {
+            const auto it = map.lowerBound(key);
+            const auto ref = reference.lower_bound(key);
+            QCOMPARE(it == map.cend(), ref == reference.end());
+            if (ref != reference.end())
+                QCOMPARE(it.key(), ref->first);
+            break;
+        }
+        case 7:
+            if (rng.bounded(100) == 0)
+                snapshot = map;
+            break;
+        }
+    }
+
+    QCOMPARE(map.size(), qsizetype(reference.size()));
+    auto ref = reference.cbegin();
+    for (auto it = map.cbegin(); it != map.cend(); ++it, ++ref) {
+        QCOMPARE(it.key(), ref->first);
+        QCOMPARE(it.value(), ref->second);
+    }
+    QVERIFY(ref == reference.cend());
+
+    // drain the map in random order
+    while (!reference.empty()) {
+        auto it = reference.begin();
+        std::advance(it, rng.bounded(int(reference.size())));
+        QCOMPARE(map.remove(it->first), 1);
+        reference.erase(it);
+    }
+    QVERIFY(map.isEmpty());
+}
+
+struct Counted
+{
+    static int alive;
+    Counted(int v = 0) : value(v) { ++alive; }
+    Counted(const Counted &other) : value(other.value) { ++alive; }
+    Counted &operator=(const Counted &other) = default;
+    ~Counted() { --alive; }
+    friend bool operator<(const Counted &lhs, const Counted &rhs) { return lhs.value < rhs.value; }
+    friend bool operator==(const Counted &lhs, const Counted &rhs) { return lhs.value == rhs.value; }
+    int value;
+};
+int Counted::alive = 0;
+
+void tst_QBTreeMap::elementLifetime()
+{
+    {
+        QBTreeMap<Counted, Counted> map;
+        for (int i = 0; i < 3000; ++i)
+            map.insert(Counted((i * 13) % 3000), Counted(i));
+        QCOMPARE(map.size(), 3000);
+        {
+            QBTreeMap<Counted, Counted> copy = map;
+            copy.remove(Counted(5));
+            for (int i = 0; i < 3000; i += 2)
+                map.remove(Counted(i));
+        }
+        for (int i = 0; i < 3000; i += 5)
+            map.take(Counted(i));
+        map[Counted(-1)] = Counted(1);
+        QVERIFY(Counted::alive > 0);
+    }
+    QCOMPARE(Counted::alive, 0);
+}
+
+QTEST_APPLESS_MAIN(tst_QBTreeMap)
+#include "tst_qbtreemap.moc"
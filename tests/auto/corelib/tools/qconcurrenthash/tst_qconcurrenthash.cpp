@@ -0,0 +1,284 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QTest>
+#include <QConcurrentHash>
+#include <QSet>
+#include <QString>
+#include <QThread>
+
+#include <memory>
+#include <vector>
+
+class tst_QConcurrentHash : public QObject
+{
+    Q_OBJECT
+private slots:
+    void shardCount_data();
+    void shardCount();
+    void insertAndLookup();
+    void tryInsert();
+    void removeAndTake();
+    void clear();
+    void snapshot();
+    void emptySnapshot();
+    void concurrentWriters();
+    void readersAndWriters();
+};
+
+void tst_QConcurrentHash::shardCount_data()
+{
+    QTest::addColumn<int>("requested");
+    QTest::addColumn<int>("expected");
+
+    QTest::newRow("1") << 1 << 1;
+    QTest::newRow("3") << 3 << 4;
+    QTest::newRow("16") << 16 << 16;
+    QTest::newRow("100") << 100 << 128;
+    QTest::newRow("256") << 256 << 256;
+}
+
+void tst_QConcurrentHash::shardCount()
+{
+    QFETCH(int, requested);
+    QFETCH(int, expected);
+
+    QConcurrentHash<int, int> hash(requested);
+    QCOMPARE(hash.shardCount(), expected);
+
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, -i);
+    QCOMPARE(hash.size(), 1000);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(hash.value(i), -i);
+
+    typedef QConcurrentHash<int, int> Hash;
+    QCOMPARE(Hash().shardCount(), qsizetype(Hash::DefaultShardCount));
+}
+
+void tst_QConcurrentHash::insertAndLookup()
+{
+    QConcurrentHash<QString, int> hash;
+    QVERIFY(hash.isEmpty());
+    QCOMPARE(hash.size(), 0);
+    QVERIFY(!hash.contains(QStringLiteral("a")));
+    QCOMPARE(hash.value(QStringLiteral("a")), 0);
+    QCOMPARE(hash.value(QStringLiteral("a"), 42), 42);
+
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(QString::number(i), i);
+    QVERIFY(!hash.isEmpty());
+    QCOMPARE(hash.size(), 1000);
+    QCOMPARE(hash.count(), 1000);
+    for (int i = 0; i < 1000; ++i) {
+        QVERIFY(hash.contains(QString::number(i)));
+        QCOMPARE(hash.value(QString::number(i), -1), i);
+    }
+    QVERIFY(!hash.contains(QStringLiteral("1000")));
+
+    // insert() replaces existing values
+    hash.insert(QStringLiteral("7"), 700);
+    QCOMPARE(hash.value(QStringLiteral("7")), 700);
+    QCOMPARE(hash.size(), 1000);
+
+    hash.reserve(10000);
+    QCOMPARE(hash.size(), 1000);
+    QCOMPARE(hash.value(QStringLiteral("8")), 8);
+}
+
+void tst_QConcurrentHash::tryInsert()
+{
+    QConcurrentHash<int, QString> hash;
+    QVERIFY(hash.tryInsert(1, QStringLiteral("one")));
+    QVERIFY(!hash.tryInsert(1, QStringLiteral("uno")));
+    QCOMPARE(hash.value(1), QStringLiteral("one"));
+    QCOMPARE(hash.size(), 1);
+}
+
+void tst_QConcurrentHash::removeAndTake()
+{
+    QConcurrentHash<int, QString> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, QString::number(i));
+
+    QVERIFY(hash.remove(10));
+    QVERIFY(!hash.remove(10));
+    QVERIFY(!hash.contains(10));
+    QCOMPARE(hash.take(20), QStringLiteral("20"));
+    QCOMPARE(hash.take(20), QString());
+    QCOMPARE(hash.size(), 98);
+}
+
+void tst_QConcurrentHash::clear()
+{
+    QConcurrentHash<int, int> hash(4);
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, i);
+    hash.clear();
+    QVERIFY(hash.isEmpty());
+    QVERIFY(!hash.contains(1));
+
+    // still usable
+    hash.insert(1, 2);
+    QCOMPARE(hash.value(1), 2);
+}
+
+void tst_QConcurrentHash::snapshot()
+{
+    QConcurrentHash<QString, int> hash;
+    for (int i = 0; i < 500; ++i)
+        hash.insert(QString::number(i), i);
+
+    const auto snapshot = hash.snapshot();
+
+    // later modifications don't affect the snapshot
+    hash.insert(QStringLiteral("new"), -1);
+    hash.insert(QStringLiteral("5"), -5);
+    hash.remove(QStringLiteral("6"));
+    hash.clear();
+
+    QCOMPARE(snapshot.size(), 500);
+    QCOMPARE(snapshot.count(), 500);
+    QVERIFY(!snapshot.isEmpty());
+    QVERIFY(snapshot.contains(QStringLiteral("6")));
+    QVERIFY(!snapshot.contains(QStringLiteral("new")));
+    QCOMPARE(snapshot.value(QStringLiteral("5")), 5);
+    QCOMPARE(snapshot.value(QStringLiteral("new"), 42), 42);
+
+    QSet<QString> seen;
+    for (auto it = snapshot.begin(); it != snapshot.end(); ++it) {
+        QCOMPARE(it.key(), QString::number(it.value()));
+        QCOMPARE(*it, it.value());
+        QVERIFY(!seen.contains(it.key()));
+        seen.insert(it.key());
+    }
+    QCOMPARE(seen.size(), 500);
+
+    int sum = 0;
+    for (int value : snapshot)
+        sum += value;
+    QCOMPARE(sum, 499 * 500 / 2);
+
+    const QHash<QString, int> copy = snapshot.toHash();
+    QCOMPARE(copy.size(), 500);
+    QCOMPARE(copy.value(QStringLiteral("123")), 123);
+}
+
+void tst_QConcurrentHash::emptySnapshot()
+{
+    QConcurrentHash<int, int>::Snapshot defaultConstructed;
+    QVERIFY(defaultConstructed.isEmpty());
+    QCOMPARE(defaultConstructed.begin(), defaultConstructed.end());
+    QVERIFY(!defaultConstructed.contains(1));
+    QCOMPARE(defaultConstructed.value(1, 2), 2);
+
+    QConcurrentHash<int, int> hash(8);
+    const auto snapshot = hash.snapshot();
+    QVERIFY(snapshot.isEmpty());
+    QCOMPARE(snapshot.begin(), snapshot.end());
+    QVERIFY(hash.toHash().isEmpty());
+
+    // a single element, in whichever shard it lands
+    for (int i = 0; i < 32; ++i) {
+        hash.clear();
+        hash.insert(i, -i);
+        const auto s = hash.snapshot();
+        auto it = s.begin();
+        QVERIFY(it != s.end());
+        QCOMPARE(it.key(), i);
+        QCOMPARE(it.value(), -i);
+        QCOMPARE(++it, s.end());
+    }
+}
+
+// runs \a function in \a count threads at once
+template <typename Function>
+static void inThreads(int count, Function function)
+{
+    std::vector<std::unique_ptr<QThread>> threads;
+    for (int i = 0; i < count; ++i)
+        threads.emplace_back(QThread::create(function, i));
+    for (auto &thread : threads)
+        thread->start();
+    for (auto &thread : threads)
+        QVERIFY(thread->wait(60000));
+}
+
+void tst_QConcurrentHash::concurrentWriters()
+{
+    constexpr int ThreadCount = 8;
+    constexpr int PerThread = 2000;
+    QConcurrentHash<QString, int> hash;
+
+    inThreads(ThreadCount, [&](int thread) {
+        for (int i = 0; i < PerThread; ++i)
+            hash.insert(QString::number(thread * PerThread + i), thread);
+        // every thread competes for the same keys
+        for (int i = 0; i < 100; ++i)
+            hash.tryInsert(QStringLiteral("shared%1").arg(i), thread);
+        // and removes half of its own
+        for (int i = 0; i < PerThread; i += 2)
+            hash.remove(QString::number(thread * PerThread + i));
+    });
+
+    QCOMPARE(hash.size(), ThreadCount * PerThread / 2 + 100);
+    for (int thread = 0; thread < ThreadCount; ++thread) {
+        for (int i = 0; i < PerThread; ++i) {
+            const QString key = QString::number(thread * PerThread + i);
+            QCOMPARE(hash.contains(key), i % 2 == 1);
+            if (i % 2)
+                QCOMPARE(hash.value(key), thread);
+        }
+    }
+}
+
+void tst_QConcurrentHash::readersAndWriters()
+{
+    constexpr int KeyCount = 1000;
+    QConcurrentHash<int, QString> hash;
+    for (int i = 0; i < KeyCount; ++i)
+        hash.insert(i, QString::number(i));
+
+    QAtomicInt failures;
+    inThreads(6, [&](int thread) {
+        for (int round = 0; round < 20; ++round) {
+            if (thread < 2) {
+                // writers keep flipping the odd keys between two valid values
+                for (int i = 1; i < KeyCount; i += 2) {
+                    hash.insert(i, (round % 2) ? QString::number(i) : QString::number(-i));
+                    if (i % 10 == 1)
+                        hash.remove(i);
+                }
+            } else if (thread < 4) {
+                for (int i = 0; i < KeyCount; ++i) {
+                    const QString value = hash.value(i);
+                    const bool ok = (i % 2 == 0) ? value == QString::number(i)
+                                                 : value.isEmpty() || value == QString::number(i)
+                                                         || value == QString::number(-i);
+                    if (!ok)
+                        failures.ref();
+                }
+            } else {
+                // snapshots are consistent per key
+                const auto snapshot = hash.snapshot();
+                int evenKeys = 0;
+                for (auto it = snapshot.begin(); it != snapshot.end(); ++it) {
+                    if (it.key() % 2 == 0) {
+                        ++evenKeys;
+                        if (it.value() != QString::number(it.key()))
+                            failures.ref();
+                    }
+                }
+                if (evenKeys != KeyCount / 2)
+                    failures.ref();
+            }
+        }
+    });
+
+    QCOMPARE(failures.loadRelaxed(), 0);
+    for (int i = 0; i < KeyCount; i += 2)
+        QCOMPARE(hash.value(i), QString::number(i));
+}
+
+QTEST_APPLESS_MAIN(tst_QConcurrentHash)
+#include "tst_qconcurrenthash.moc"
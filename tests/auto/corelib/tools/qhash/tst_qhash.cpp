@@ -65,6 +65,7 @@ private slots:
     void emplace();
 
     void badHashFunction();
+    void longProbeSequences();
     void hashOfHash();
 
     void stdHash();
@@ -2466,6 +2467,59 @@ void tst_QHash::badHashFunction()
 
 }
 
+struct ClusteredKey {
+    int k;
+    ClusteredKey(int i) : k(i) {}
+    bool operator==(const ClusteredKey &other) const
+    {
+        return k == other.k;
+    }
+};
+
+// all keys start probing at the same bucket, but have different hashes
+size_t qHash(ClusteredKey key, size_t seed)
+{
+    return (size_t(key.k) << 24) ^ (seed << 24);
+}
+
+void tst_QHash::longProbeSequences()
+{
+    // the probe sequence crosses many groups of control bytes and several Spans
+    QHash<ClusteredKey, int> hash;
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+    QCOMPARE(hash.size(), 1000);
+
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(hash.value(i, -1), i);
+    for (int i = 1000; i < 2000; ++i)
+        QVERIFY(!hash.contains(i));
+
+    // erasing moves the following entries back, including across Span boundaries
+    for (int i = 0; i < 1000; i += 3)
+        QVERIFY(hash.remove(i));
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(hash.value(i, -1), i % 3 ? i : -1);
+
+    for (int i = 0; i < 1000; i += 3)
+        hash.insert(i, -i);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(hash.value(i), i % 3 ? i : -i);
+
+    int count = 0;
+    for (auto it = hash.cbegin(); it != hash.cend(); ++it, ++count)
+        QCOMPARE(it.value(), it.key().k % 3 ? it.key().k : -it.key().k);
+    QCOMPARE(count, 1000);
+
+    // copies with a different bucket count are rebuilt from the stored hashes
+    QHash<ClusteredKey, int> copy = hash;
+    copy.reserve(5000);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(copy.value(i), hash.value(i));
+    copy.squeeze();
+    QCOMPARE(copy, hash);
+}
+
 void tst_QHash::hashOfHash()
 {
     QHash<int, int> hash;
@@ -3,8 +3,11 @@
 
 #include <QTest>
 #include <QVariantMap>
+#include <qjsonarray.h>
 #include <qjsondocument.h>
+#include <qjsonlazyvalue.h>
 #include <qjsonobject.h>
+#include <qjsonstreamreader.h>
 
 class BenchmarkQtJson: public QObject
 {
@@ -21,6 +24,12 @@ private Q_SLOTS:
     void parseNumbers();
     void parseJson();
     void parseJsonToVariant();
+    void parseApiPayload_data();
+    void parseApiPayload();
+    void streamApiPayload_data() { parseApiPayload_data(); }
+    void streamApiPayload();
+    void readFewFields_data();
+    void readFewFields();
 
     void jsonObjectInsert();
     void variantMapInsert();
@@ -93,6 +102,114 @@ void BenchmarkQtJson::parseJsonToVariant()
     }
 }
 
+// Something like the response of a REST API listing user records, a couple
+// of megabytes in size
+static QJsonDocument makeApiPayload(const QString &description)
+{
+    QJsonArray users;
+    for (int i = 0; i < 5000; ++i) {
+        QJsonObject address;
+        address.insert("street", QStringLiteral("%1 Main Street").arg(i));
+        address.insert("city", "Springfield");
+        address.insert("zip", QString::number(10000 + i));
+        address.insert("geo", QJsonArray { 52.520008 + i / 1000., 13.404954 - i / 1000. });
+
+        QJsonObject user;
+        user.insert("id", i);
+        user.insert("uuid", QStringLiteral("8d5e8a3c-4b0f-4e1d-9f6a-%1").arg(i, 12, 10, QChar('0')));
+        user.insert("name", QStringLiteral("User Number %1").arg(i));
+        user.insert("email", QStringLiteral("user.%1@example.com").arg(i));
+        user.insert("active", i % 3 != 0);
+        user.insert("score", i * 0.75);
+        user.insert("tags", QJsonArray { "alpha", "beta", "gamma" });
+        user.insert("address", address);
+        user.insert("description", description);
+        user.insert("avatar", QJsonValue::Null);
+        users.append(user);
+    }
+    return QJsonDocument(QJsonObject { { "page", 1 }, { "total", users.size() },
+                                       { "users", users } });
+}
+
+void BenchmarkQtJson::parseApiPayload_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    const QString ascii = QStringLiteral("Lorem ipsum dolor sit amet, consectetur adipiscing "
+                                         "elit, sed do eiusmod tempor incididunt ut labore.");
+    const QString unicode = QStringLiteral("Größenänderung der Benutzeroberfläche, "
+                                           "ユーザーインターフェース, интерфейс пользователя");
+    const QString escaped = QStringLiteral("Line one\n\t\"quoted\" C:\\path\\to\\file\nLine two");
+
+    QTest::newRow("compact") << makeApiPayload(ascii).toJson(QJsonDocument::Compact);
+    QTest::newRow("indented") << makeApiPayload(ascii).toJson(QJsonDocument::Indented);
+    QTest::newRow("unicode") << makeApiPayload(unicode).toJson(QJsonDocument::Compact);
+    QTest::newRow("escapes") << makeApiPayload(escaped).toJson(QJsonDocument::Compact);
+
+    // documents, e.g. with embedded HTML, where the parser mostly scans strings
+    QJsonArray pages;
+    for (int i = 0; i < 200; ++i)
+        pages.append(ascii.repeated(100));
+    QTest::newRow("long-strings") << QJsonDocument(pages).toJson(QJsonDocument::Compact);
+}
+
+void BenchmarkQtJson::parseApiPayload()
+{
+    QFETCH(QByteArray, json);
+
+    QBENCHMARK {
+        QJsonDocument doc = QJsonDocument::fromJson(json);
+        QJsonObject object = doc.object();
+    }
+}
+
+void BenchmarkQtJson::streamApiPayload()
+{
+    QFETCH(QByteArray, json);
+
+    QBENCHMARK {
+        QJsonStreamReader reader(json);
+        qsizetype strings = 0;
+        while (reader.readNext() != QJsonStreamReader::NoToken) {
+            QVERIFY(!reader.hasError());
+            if (reader.isString())
+                ++strings;
+        }
+        QVERIFY(strings);
+    }
+}
+
+void BenchmarkQtJson::readFewFields_data()
+{
+    QTest::addColumn<bool>("lazy");
+
+    QTest::newRow("QJsonDocument") << false;
+    QTest::newRow("QJsonLazyValue") << true;
+}
+
+void BenchmarkQtJson::readFewFields()
+{
+    QFETCH(bool, lazy);
+    const QByteArray json = makeApiPayload(QStringLiteral("Lorem ipsum dolor sit amet"))
+            .toJson(QJsonDocument::Compact);
+
+    if (lazy) {
+        QBENCHMARK {
+            const QJsonLazyValue doc = QJsonLazyValue::fromJson(json);
+            QCOMPARE(doc["page"].toInt(), 1);
+            QCOMPARE(doc["total"].toInt(), 5000);
+            QCOMPARE(doc["users"][0]["name"].toString(), QStringLiteral("User Number 0"));
+        }
+    } else {
+        QBENCHMARK {
+            const QJsonObject doc = QJsonDocument::fromJson(json).object();
+            QCOMPARE(doc["page"].toInt(), 1);
+            QCOMPARE(doc["total"].toInt(), 5000);
+            QCOMPARE(doc["users"][0]["name"].toString(), QStringLiteral("User Number 0"));
+        }
+    }
+}
+
 void BenchmarkQtJson::jsonObjectInsert()
 {
     QJsonObject object;
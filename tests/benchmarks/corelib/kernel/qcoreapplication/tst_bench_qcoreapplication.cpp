@@ -4,12 +4,41 @@
 #include <qtest.h>
 #include <qcoreapplication.h>
 
+#include <memory>
+#include <vector>
+
 class tst_QCoreApplication : public QObject
 {
 Q_OBJECT
 private slots:
     void event_posting_benchmark_data();
     void event_posting_benchmark();
+    void queuedSignalsFromThreads_data();
+    void queuedSignalsFromThreads();
+};
+
+class Producer : public QObject
+{
+    Q_OBJECT
+signals:
+    void produced(int value);
+};
+
+class Consumer : public QObject
+{
+    Q_OBJECT
+public slots:
+    void consume(int value)
+    {
+        received += value;
+        if (received == expected)
+            loop.quit();
+    }
+
+public:
+    QEventLoop loop;
+    int received = 0;
+    int expected = 0;
 };
 
 void tst_QCoreApplication::event_posting_benchmark_data()
@@ -39,6 +68,59 @@ void tst_QCoreApplication::event_posting_benchmark()
     }
 }
 
+void tst_QCoreApplication::queuedSignalsFromThreads_data()
+{
+    QTest::addColumn<int>("connectionType");
+    QTest::addColumn<int>("producerCount");
+
+    const struct {
+        const char *name;
+        int type;
+    } types[] = {
+        { "queued", Qt::QueuedConnection },
+        { "batched", Qt::QueuedConnection | Qt::BatchedConnection },
+    };
+    for (const auto &type : types) {
+        for (int count : { 1, 2, 4, 8, 16 })
+            QTest::addRow("%s, %d producers", type.name, count) << type.type << count;
+    }
+}
+
+// producerCount threads emit queued signals into one receiver in the main thread
+void tst_QCoreApplication::queuedSignalsFromThreads()
+{
+    QFETCH(int, connectionType);
+    QFETCH(int, producerCount);
+    const int signalsPerProducer = 100000 / producerCount;
+    const int total = signalsPerProducer * producerCount;
+
+    Consumer consumer;
+    consumer.expected = total;
+    std::vector<std::unique_ptr<Producer>> producers;
+    for (int i = 0; i < producerCount; ++i) {
+        producers.push_back(std::make_unique<Producer>());
+        connect(producers.back().get(), &Producer::produced, &consumer, &Consumer::consume,
+                Qt::ConnectionType(connectionType));
+    }
+
+    QBENCHMARK {
+        consumer.received = 0;
+        std::vector<std::unique_ptr<QThread>> threads;
+        for (const auto &producer : producers) {
+            Producer *p = producer.get();
+            threads.emplace_back(QThread::create([p, signalsPerProducer] {
+                for (int i = 0; i < signalsPerProducer; ++i)
+                    emit p->produced(1);
+            }));
+            threads.back()->start();
+        }
+        consumer.loop.exec();
+        for (const auto &thread : threads)
+            thread->wait();
+    }
+    QCOMPARE(consumer.received, total);
+}
+
 QTEST_MAIN(tst_QCoreApplication)
 
 #include "tst_bench_qcoreapplication.moc"
@@ -20,6 +20,8 @@ private slots:
     void signal_slot_benchmark_data();
     void signal_many_receivers();
     void signal_many_receivers_data();
+    void signal_from_threads();
+    void signal_from_threads_data();
     void qproperty_benchmark_data();
     void qproperty_benchmark();
     void dynamic_property_benchmark();
@@ -173,6 +175,45 @@ void tst_QObject::signal_many_receivers()
     }
 }
 
+void tst_QObject::signal_from_threads_data()
+{
+    QTest::addColumn<int>("receiverCount");
+    QTest::addColumn<int>("threadCount");
+    for (int receiverCount : {1, 10, 100}) {
+        for (int threadCount : {1, 2, 4, 8, 16, 32}) {
+            QTest::addRow("%d receivers, %d threads", receiverCount, threadCount)
+                    << receiverCount << threadCount;
+        }
+    }
+}
+
+void tst_QObject::signal_from_threads()
+{
+    QFETCH(int, receiverCount);
+    QFETCH(int, threadCount);
+    // the same total number of emissions in each row
+    const int emissionsPerThread = 32 * 1024 / threadCount;
+
+    Object sender;
+    std::vector<Object> receivers(receiverCount);
+    for (Object &receiver : receivers)
+        QObject::connect(&sender, &Object::signal0, &receiver, &Object::slot0, Qt::DirectConnection);
+
+    QBENCHMARK {
+        std::vector<std::unique_ptr<QThread>> threads;
+        for (int i = 0; i < threadCount; ++i) {
+            threads.emplace_back(QThread::create([&sender, emissionsPerThread] {
+                for (int j = 0; j < emissionsPerThread; ++j)
+                    sender.emitSignal0();
+            }));
+        }
+        for (const auto &thread : threads)
+            thread->start();
+        for (const auto &thread : threads)
+            thread->wait();
+    }
+}
+
 void tst_QObject::qproperty_benchmark_data()
 {
     QTest::addColumn<QByteArray>("name");
@@ -0,0 +1,116 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QSocketNotifier>
+#include <QTest>
+
+#include <private/qeventdispatcher_unix_p.h>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <vector>
+
+class tst_QSocketNotifier : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void activate_data();
+    void activate();
+
+private:
+    rlim_t fdLimit = 0;
+};
+
+void tst_QSocketNotifier::initTestCase()
+{
+    // allow as many idle notifiers as the hard limit lets us have
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+        fdLimit = limit.rlim_cur;
+    }
+}
+
+void tst_QSocketNotifier::activate_data()
+{
+    QTest::addColumn<bool>("useEpoll");
+    QTest::addColumn<int>("notifierCount");
+
+    const int counts[] = { 1, 100, 1000, 10000, 20000 };
+    for (int count : counts) {
+        QTest::addRow("poll-%d", count) << false << count;
+#if QT_CONFIG(epoll)
+        QTest::addRow("epoll-%d", count) << true << count;
+#endif
+    }
+}
+
+// One descriptor becomes readable per iteration, while notifierCount - 1
+// other notifiers stay registered but idle.
+void tst_QSocketNotifier::activate()
+{
+    QFETCH(bool, useEpoll);
+    QFETCH(int, notifierCount);
+
+    if (fdLimit && rlim_t(notifierCount) + 64 > fdLimit)
+        QSKIP("Not enough file descriptors available");
+
+    qputenv("QT_EVENT_DISPATCHER_EPOLL", useEpoll ? "1" : "0");
+    QEventDispatcherUNIX dispatcher;
+    qunsetenv("QT_EVENT_DISPATCHER_EPOLL");
+
+    int activePipe[2];
+    int idlePipe[2];
+    QVERIFY(::pipe(activePipe) == 0);
+    QVERIFY(::pipe(idlePipe) == 0);
+
+    std::vector<QSocketNotifier *> notifiers;
+    notifiers.reserve(notifierCount);
+    auto addNotifier = [&](int fd) {
+        auto notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+        // detach it from the thread's dispatcher and drive it through ours
+        notifier->setEnabled(false);
+        dispatcher.registerSocketNotifier(notifier);
+        notifiers.push_back(notifier);
+        return notifier;
+    };
+
+    for (int i = 1; i < notifierCount; ++i) {
+        const int fd = ::dup(idlePipe[0]);
+        QVERIFY(fd >= 0);
+        addNotifier(fd);
+    }
+
+    int activations = 0;
+    QSocketNotifier *active = addNotifier(activePipe[0]);
+    connect(active, &QSocketNotifier::activated, this, [&](QSocketDescriptor socket) {
+        char c;
+        if (::read(socket, &c, 1) == 1)
+            ++activations;
+    });
+
+    QBENCHMARK {
+        const char c = 0;
+        QCOMPARE(::write(activePipe[1], &c, 1), 1);
+        dispatcher.processEvents(QEventLoop::AllEvents);
+    }
+    QVERIFY(activations > 0);
+
+    for (QSocketNotifier *notifier : notifiers) {
+        dispatcher.unregisterSocketNotifier(notifier);
+        if (notifier != active)
+            ::close(notifier->socket());
+        delete notifier;
+    }
+    ::close(activePipe[0]);
+    ::close(activePipe[1]);
+    ::close(idlePipe[0]);
+    ::close(idlePipe[1]);
+}
+
+QTEST_MAIN(tst_QSocketNotifier)
+
+#include "tst_bench_qsocketnotifier.moc"
@@ -0,0 +1,86 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QAbstractEventDispatcher>
+#include <QObject>
+#include <QTest>
+
+#include <vector>
+
+class tst_QTimer : public QObject
+{
+    Q_OBJECT
+private slots:
+    void armAndCancel_data();
+    void armAndCancel();
+    void restart_data() { armAndCancel_data(); }
+    void restart();
+};
+
+// The timers are registered with the event dispatcher directly, so that only
+// its bookkeeping is measured. The timeouts are spread like per-connection
+// timeouts would be.
+static int intervalFor(int i)
+{
+    return 1000 + (i * 7919) % 60000;
+}
+
+void tst_QTimer::armAndCancel_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<Qt::TimerType>("timerType");
+
+    const int counts[] = { 1000, 10000, 100000 };
+    for (int count : counts) {
+        QTest::addRow("precise-%d", count) << count << Qt::PreciseTimer;
+        QTest::addRow("coarse-%d", count) << count << Qt::CoarseTimer;
+        QTest::addRow("verycoarse-%d", count) << count << Qt::VeryCoarseTimer;
+    }
+}
+
+void tst_QTimer::armAndCancel()
+{
+    QFETCH(int, count);
+    QFETCH(Qt::TimerType, timerType);
+
+    QAbstractEventDispatcher *dispatcher = QAbstractEventDispatcher::instance();
+    QObject object;
+    std::vector<int> ids(count);
+
+    QBENCHMARK {
+        for (int i = 0; i < count; ++i)
+            ids[i] = dispatcher->registerTimer(intervalFor(i), timerType, &object);
+        // cancel in a different order than they were armed
+        for (int i = 0; i < count; i += 2)
+            dispatcher->unregisterTimer(ids[i]);
+        for (int i = 1; i < count; i += 2)
+            dispatcher->unregisterTimer(ids[i]);
+    }
+}
+
+// Keep count timers armed and re-arm each of them, like a connection
+// that pushes its idle timeout back whenever data arrives.
+void tst_QTimer::restart()
+{
+    QFETCH(int, count);
+    QFETCH(Qt::TimerType, timerType);
+
+    QAbstractEventDispatcher *dispatcher = QAbstractEventDispatcher::instance();
+    QObject object;
+    std::vector<int> ids(count);
+    for (int i = 0; i < count; ++i)
+        ids[i] = dispatcher->registerTimer(intervalFor(i), timerType, &object);
+
+    QBENCHMARK {
+        for (int i = 0; i < count; ++i) {
+            dispatcher->unregisterTimer(ids[i]);
+            ids[i] = dispatcher->registerTimer(intervalFor(i), timerType, &object);
+        }
+    }
+
+    dispatcher->unregisterTimers(&object);
+}
+
+QTEST_MAIN(tst_QTimer)
+
+#include "tst_bench_qtimer.moc"
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
 
 #include <QLocale>
+#include <QRandomGenerator>
 #include <QTest>
 
 class tst_QLocale : public QObject
@@ -29,6 +30,10 @@ private Q_SLOTS:
     void toUpper_QLocale_2();
     void toUpper_QString();
     void number_QString();
+    void formatDouble_data();
+    void formatDouble();
+    void parseDouble_data();
+    void parseDouble();
 };
 
 static QString data()
@@ -367,6 +372,92 @@ void tst_QLocale::number_QString()
     }
 }
 
+// Doubles of various magnitudes, with full-precision mantissas
+static QList<double> randomDoubles()
+{
+    QRandomGenerator rng(42);
+    QList<double> values(100000);
+    for (double &d : values)
+        d = std::ldexp(rng.generateDouble() - 0.5, int(rng.bounded(120)) - 60);
+    return values;
+}
+
+void tst_QLocale::formatDouble_data()
+{
+    QTest::addColumn<char>("format");
+    QTest::addColumn<int>("precision");
+    QTest::addColumn<bool>("byteArray");
+
+    QTest::newRow("QString-g-shortest") << 'g' << int(QLocale::FloatingPointShortest) << false;
+    QTest::newRow("QString-g-6") << 'g' << 6 << false;
+    QTest::newRow("QString-e-10") << 'e' << 10 << false;
+    QTest::newRow("QString-f-6") << 'f' << 6 << false;
+    QTest::newRow("QByteArray-g-shortest")
+            << 'g' << int(QLocale::FloatingPointShortest) << true;
+}
+
+void tst_QLocale::formatDouble()
+{
+    QFETCH(char, format);
+    QFETCH(int, precision);
+    QFETCH(bool, byteArray);
+    const QList<double> values = randomDoubles();
+
+    qsizetype total = 0;
+    if (byteArray) {
+        QBENCHMARK {
+            for (double d : values)
+                total += QByteArray::number(d, format, precision).size();
+        }
+    } else {
+        QBENCHMARK {
+            for (double d : values)
+                total += QString::number(d, format, precision).size();
+        }
+    }
+    QVERIFY(total > 0);
+}
+
+void tst_QLocale::parseDouble_data()
+{
+    QTest::addColumn<int>("method");
+    QTest::newRow("QString") << 0;
+    QTest::newRow("QLocale::c()") << 1;
+    QTest::newRow("QByteArray") << 2;
+}
+
+void tst_QLocale::parseDouble()
+{
+    QFETCH(int, method);
+    QStringList strings;
+    QByteArrayList byteArrays;
+    for (double d : randomDoubles()) {
+        strings.append(QString::number(d, 'g', QLocale::FloatingPointShortest));
+        byteArrays.append(strings.last().toLatin1());
+    }
+    const QLocale c = QLocale::c();
+
+    double sum = 0;
+    bool ok = true;
+    QBENCHMARK {
+        switch (method) {
+        case 0:
+            for (const QString &s : std::as_const(strings))
+                sum += s.toDouble(&ok);
+            break;
+        case 1:
+            for (const QString &s : std::as_const(strings))
+                sum += c.toDouble(s, &ok);
+            break;
+        case 2:
+            for (const QByteArray &s : std::as_const(byteArrays))
+                sum += s.toDouble(&ok);
+            break;
+        }
+    }
+    QVERIFY(ok);
+}
+
 QTEST_MAIN(tst_QLocale)
 
 #include "tst_bench_qlocale.moc"
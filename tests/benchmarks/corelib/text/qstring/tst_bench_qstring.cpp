@@ -32,7 +32,23 @@ private slots:
     void number_double_data();
     void number_double();
 
+    void indexOf_char_data() { largeText_data(); }
+    void indexOf_char();
+    void compare_data() { largeText_data(); }
+    void compare();
+    void compare_caseInsensitive_data() { largeText_data(); }
+    void compare_caseInsensitive();
+    void fromLatin1_data() { largeText_data(); }
+    void fromLatin1();
+    void toLatin1_data() { largeText_data(); }
+    void toLatin1();
+    void fromUtf8_data() { largeText_data(); }
+    void fromUtf8();
+    void toUtf8_data() { largeText_data(); }
+    void toUtf8();
+
 private:
+    void largeText_data();
     void section_data_impl(bool includeRegExOnly = true);
     template <typename RX> void section_impl();
     template <typename Integer> void number_impl();
@@ -294,6 +310,123 @@ void tst_QString::number_double()
     QCOMPARE(actual, expected);
 }
 
+// Builds text of \a size characters where every \a asciiRun US-ASCII
+// characters are followed by a word in Latin 1, Cyrillic or CJK.
+static QString mixedScriptText(qsizetype size, int asciiRun)
+{
+    static const char16_t words[][6] = {
+        u"Grün", u"слово", u"文字列", u"текст", u"Ærø"
+    };
+    static const char ascii[] = "The quick brown fox jumps over the lazy dog. ";
+
+    QString result;
+    result.reserve(size + 5);
+    for (qsizetype i = 0; result.size() < size; ++i) {
+        for (int j = 0; j < asciiRun && result.size() < size; ++j)
+            result += QLatin1Char(ascii[(i * asciiRun + j) % (sizeof(ascii) - 1)]);
+        if (asciiRun < std::numeric_limits<int>::max())
+            result += QStringView(words[i % std::size(words)]);
+    }
+    result.truncate(size);
+    return result;
+}
+
+void tst_QString::largeText_data()
+{
+    QTest::addColumn<QString>("text");
+
+    const int Ascii = std::numeric_limits<int>::max();
+    for (qsizetype size : {15, 100, 1000, 100000}) {
+        QTest::addRow("ascii-%lld", qlonglong(size)) << mixedScriptText(size, Ascii);
+        QTest::addRow("mostly-ascii-%lld", qlonglong(size)) << mixedScriptText(size, 200);
+        QTest::addRow("mixed-script-%lld", qlonglong(size)) << mixedScriptText(size, 4);
+        QTest::addRow("non-latin-%lld", qlonglong(size)) << mixedScriptText(size, 0);
+    }
+}
+
+void tst_QString::indexOf_char()
+{
+    QFETCH(QString, text);
+
+    // not found: scans the whole string
+    qsizetype result = 0;
+    QBENCHMARK {
+        result += text.indexOf(u'\x1');
+    }
+    QVERIFY(result < 0);
+}
+
+void tst_QString::compare()
+{
+    QFETCH(QString, text);
+
+    // a deep copy, so the comparison can't take a shortcut
+    const QString copy(text.constData(), text.size());
+    bool result = true;
+    QBENCHMARK {
+        result = result && text.compare(copy) == 0;
+    }
+    QVERIFY(result);
+}
+
+void tst_QString::compare_caseInsensitive()
+{
+    QFETCH(QString, text);
+
+    const QString upper = text.toUpper();
+    bool result = true;
+    QBENCHMARK {
+        result = result && text.compare(upper, Qt::CaseInsensitive) == 0;
+    }
+    QVERIFY(result);
+}
+
+void tst_QString::fromLatin1()
+{
+    QFETCH(QString, text);
+
+    const QByteArray latin1 = text.toLatin1();
+    QString result;
+    QBENCHMARK {
+        result = QString::fromLatin1(latin1);
+    }
+    QCOMPARE(result.size(), text.size());
+}
+
+void tst_QString::toLatin1()
+{
+    QFETCH(QString, text);
+
+    QByteArray result;
+    QBENCHMARK {
+        result = text.toLatin1();
+    }
+    QCOMPARE(result.size(), text.size());
+}
+
+void tst_QString::fromUtf8()
+{
+    QFETCH(QString, text);
+
+    const QByteArray utf8 = text.toUtf8();
+    QString result;
+    QBENCHMARK {
+        result = QString::fromUtf8(utf8);
+    }
+    QCOMPARE(result, text);
+}
+
+void tst_QString::toUtf8()
+{
+    QFETCH(QString, text);
+
+    QByteArray result;
+    QBENCHMARK {
+        result = text.toUtf8();
+    }
+    QCOMPARE(QString::fromUtf8(result), text);
+}
+
 QTEST_APPLESS_MAIN(tst_QString)
 
 #include "tst_bench_qstring.moc"
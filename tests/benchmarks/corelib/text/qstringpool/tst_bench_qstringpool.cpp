@@ -0,0 +1,84 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QTest>
+#include <QHash>
+#include <QStringPool>
+
+class tst_QStringPool : public QObject
+{
+    Q_OBJECT
+private slots:
+    void lookup_data();
+    void lookup();
+    void intern_data();
+    void intern();
+};
+
+// field names of a similar length and prefix, as in typical JSON documents
+static QStringList makeKeys(int count)
+{
+    QStringList keys;
+    for (int i = 0; i < count; ++i)
+        keys.append(QStringLiteral("application.settings.property_%1").arg(i));
+    return keys;
+}
+
+void tst_QStringPool::lookup_data()
+{
+    QTest::addColumn<bool>("interned");
+    QTest::newRow("copied") << false;
+    QTest::newRow("interned") << true;
+}
+
+void tst_QStringPool::lookup()
+{
+    QFETCH(bool, interned);
+    QStringPool pool;
+    const QStringList keys = makeKeys(1000);
+
+    QHash<QString, int> hash;
+    for (const QString &key : keys)
+        hash.insert(interned ? pool.intern(key) : QString(key.data(), key.size()), 0);
+
+    // the keys a parser would create for each document
+    QStringList lookups;
+    for (const QString &key : keys)
+        lookups.append(interned ? pool.intern(QStringView(key)) : QString(key.data(), key.size()));
+
+    int found = 0;
+    QBENCHMARK {
+        for (const QString &key : std::as_const(lookups))
+            found += hash.contains(key);
+    }
+    QVERIFY(found > 0);
+}
+
+void tst_QStringPool::intern_data()
+{
+    QTest::addColumn<bool>("hit");
+    QTest::newRow("miss") << false;
+    QTest::newRow("hit") << true;
+}
+
+void tst_QStringPool::intern()
+{
+    QFETCH(bool, hit);
+    const QStringList keys = makeKeys(1000);
+    QStringPool pool;
+    if (hit) {
+        for (const QString &key : keys)
+            pool.intern(key);
+    }
+
+    QBENCHMARK {
+        if (!hit)
+            pool.clear();
+        for (const QString &key : keys)
+            pool.intern(QStringView(key));
+    }
+}
+
+QTEST_MAIN(tst_QStringPool)
+
+#include "tst_bench_qstringpool.moc"
@@ -82,6 +82,8 @@ private slots:
     void readOnly();
     void writeOnly_data();
     void writeOnly();
+    void readScaling_data();
+    void readScaling();
     // void readWrite();
 };
 
@@ -294,5 +296,71 @@ void tst_QReadWriteLock::writeOnly()
     holder.value();
 }
 
+struct QShardedReadLocker
+{
+    QShardedReadLocker(QShardedReadWriteLock *lock) : lock(lock) { lock->lockForRead(); }
+    ~QShardedReadLocker() { lock->unlock_shared(); }
+    QShardedReadWriteLock *lock;
+};
+
+static int global_value;
+static QAtomicInt global_sum;
+
+// the same amount of very short reads, spread over a varying number of threads
+template <typename Mutex, typename Locker>
+void testReadScaling(int threads)
+{
+    const int iterationsPerThread = Iterations / threads;
+    Mutex lock;
+    std::vector<std::unique_ptr<QThread>> workers;
+    QBENCHMARK {
+        workers.clear();
+        for (int i = 0; i < threads; ++i) {
+            workers.emplace_back(QThread::create([&lock, iterationsPerThread] {
+                int sum = 0;
+                for (int j = 0; j < iterationsPerThread; ++j) {
+                    Locker locker(&lock);
+                    sum += global_value;
+                }
+                global_sum.fetchAndAddRelaxed(sum);
+            }));
+        }
+        for (auto &t : workers)
+            t->start();
+        for (auto &t : workers)
+            t->wait();
+    }
+}
+
+void tst_QReadWriteLock::readScaling_data()
+{
+    QTest::addColumn<FunctionPtrHolder>("holder");
+    QTest::addColumn<int>("threads");
+
+    for (int threads : {1, 2, 4, 8, 16, 32, 64}) {
+        QTest::addRow("QReadWriteLock, %d threads", threads)
+            << FunctionPtrHolder(QFunctionPointer(testReadScaling<QReadWriteLock, QReadLocker>))
+            << threads;
+        QTest::addRow("QShardedReadWriteLock, %d threads", threads)
+            << FunctionPtrHolder(QFunctionPointer(
+                       testReadScaling<QShardedReadWriteLock, QShardedReadLocker>))
+            << threads;
+#ifdef __cpp_lib_shared_mutex
+        QTest::addRow("std::shared_mutex, %d threads", threads)
+            << FunctionPtrHolder(QFunctionPointer(
+                       testReadScaling<std::shared_mutex,
+                                       LockerWrapper<std::shared_lock<std::shared_mutex>>>))
+            << threads;
+#endif
+    }
+}
+
+void tst_QReadWriteLock::readScaling()
+{
+    QFETCH(FunctionPtrHolder, holder);
+    QFETCH(int, threads);
+    reinterpret_cast<void (*)(int)>(holder.value)(threads);
+}
+
 QTEST_MAIN(tst_QReadWriteLock)
 #include "tst_bench_qreadwritelock.moc"
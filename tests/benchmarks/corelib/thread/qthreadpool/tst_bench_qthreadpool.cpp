@@ -15,6 +15,10 @@ public:
 private slots:
     void startRunnables();
     void activeThreadCount();
+    void spawnTree_data();
+    void spawnTree();
+    void startMany_data();
+    void startMany();
 };
 
 tst_QThreadPool::tst_QThreadPool()
@@ -50,6 +54,77 @@ void tst_QThreadPool::activeThreadCount()
     }
 }
 
+static void addSchedulingRows()
+{
+    QTest::addColumn<bool>("workStealing");
+    QTest::addColumn<int>("threadCount");
+
+    for (int threadCount = 1; threadCount <= 128; threadCount *= 2) {
+        QTest::addRow("queue-%d", threadCount) << false << threadCount;
+        QTest::addRow("stealing-%d", threadCount) << true << threadCount;
+    }
+}
+
+void tst_QThreadPool::spawnTree_data()
+{
+    addSchedulingRows();
+}
+
+// fine-grained divide and conquer: every runnable starts further runnables
+// from inside the pool
+void tst_QThreadPool::spawnTree()
+{
+    QFETCH(bool, workStealing);
+    QFETCH(int, threadCount);
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(threadCount);
+    threadPool.setWorkStealingEnabled(workStealing);
+
+    constexpr int leafCount = 1 << 16;
+    QAtomicInt leaves;
+    std::function<void(int)> split = [&](int size) {
+        while (size > 1) {
+            size /= 2;
+            threadPool.start([&split, size] { split(size); });
+        }
+        leaves.ref();
+    };
+
+    QBENCHMARK {
+        leaves.storeRelaxed(0);
+        threadPool.start([&split] { split(leafCount); });
+        threadPool.waitForDone();
+    }
+    QCOMPARE(leaves.loadRelaxed(), leafCount);
+}
+
+void tst_QThreadPool::startMany_data()
+{
+    addSchedulingRows();
+}
+
+// many tiny runnables started from outside the pool
+void tst_QThreadPool::startMany()
+{
+    QFETCH(bool, workStealing);
+    QFETCH(int, threadCount);
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(threadCount);
+    threadPool.setWorkStealingEnabled(workStealing);
+
+    constexpr int runnableCount = 1 << 16;
+    QAtomicInt runs;
+    QBENCHMARK {
+        runs.storeRelaxed(0);
+        for (int i = 0; i < runnableCount; ++i)
+            threadPool.start([&runs] { runs.ref(); });
+        threadPool.waitForDone();
+    }
+    QCOMPARE(runs.loadRelaxed(), runnableCount);
+}
+
 QTEST_MAIN(tst_QThreadPool)
 
 #include "tst_bench_qthreadpool.moc"
@@ -0,0 +1,116 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QTest>
+#include <QConcurrentHash>
+#include <QHash>
+#include <QReadWriteLock>
+#include <QThread>
+
+#include <memory>
+#include <vector>
+
+class tst_QConcurrentHash : public QObject
+{
+    Q_OBJECT
+private slots:
+    void mixed_data();
+    void mixed();
+};
+
+enum {
+    KeyCount = 10000,
+    Operations = 400000
+};
+
+// what applications write today
+class LockedHash
+{
+public:
+    QString value(const QString &key) const
+    {
+        QReadLocker locker(&lock);
+        return hash.value(key);
+    }
+    void insert(const QString &key, const QString &value)
+    {
+        QWriteLocker locker(&lock);
+        hash.insert(key, value);
+    }
+
+private:
+    mutable QReadWriteLock lock;
+    QHash<QString, QString> hash;
+};
+
+typedef QConcurrentHash<QString, QString> ConcurrentHash;
+
+static QAtomicInteger<qsizetype> totalFound;
+
+// the same number of operations, spread over a varying number of threads, with
+// writePercent of them being inserts and the rest lookups
+template <typename Table>
+static void runMixed(int threadCount, int writePercent)
+{
+    QStringList keys;
+    for (int i = 0; i < KeyCount; ++i)
+        keys.append(QStringLiteral("session-%1").arg(i));
+
+    Table table;
+    for (const QString &key : std::as_const(keys))
+        table.insert(key, key);
+
+    const int perThread = Operations / threadCount;
+    std::vector<std::unique_ptr<QThread>> threads;
+    QBENCHMARK {
+        threads.clear();
+        for (int t = 0; t < threadCount; ++t) {
+            threads.emplace_back(QThread::create([&, t] {
+                qsizetype found = 0;
+                for (int i = 0; i < perThread; ++i) {
+                    const QString &key = keys.at((qsizetype(i) * 7919 + t * 104729) % KeyCount);
+                    if (i % 100 < writePercent)
+                        table.insert(key, key);
+                    else
+                        found += table.value(key).size();
+                }
+                totalFound.fetchAndAddRelaxed(found);
+            }));
+        }
+        for (auto &thread : threads)
+            thread->start();
+        for (auto &thread : threads)
+            thread->wait();
+    }
+}
+
+void tst_QConcurrentHash::mixed_data()
+{
+    QTest::addColumn<bool>("concurrent");
+    QTest::addColumn<int>("threads");
+    QTest::addColumn<int>("writePercent");
+
+    for (int writePercent : {0, 10, 50}) {
+        for (int threads : {1, 4, 16}) {
+            QTest::addRow("QHash+QReadWriteLock, %d%% writes, %d threads", writePercent, threads)
+                << false << threads << writePercent;
+            QTest::addRow("QConcurrentHash, %d%% writes, %d threads", writePercent, threads)
+                << true << threads << writePercent;
+        }
+    }
+}
+
+void tst_QConcurrentHash::mixed()
+{
+    QFETCH(bool, concurrent);
+    QFETCH(int, threads);
+    QFETCH(int, writePercent);
+
+    if (concurrent)
+        runMixed<ConcurrentHash>(threads, writePercent);
+    else
+        runMixed<LockedHash>(threads, writePercent);
+}
+
+QTEST_MAIN(tst_QConcurrentHash)
+#include "tst_bench_qconcurrenthash.moc"
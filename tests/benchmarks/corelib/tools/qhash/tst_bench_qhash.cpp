@@ -6,6 +6,8 @@
 
 #include <QFile>
 #include <QHash>
+#include <QRandomGenerator>
+#include <QSet>
 #include <QString>
 #include <QStringList>
 #include <QUuid>
@@ -36,8 +38,24 @@ private slots:
     void hashing_javaString_data() { data(); }
     void hashing_javaString() { hashing_template<JavaString>(); }
 
+    void insert_int_data() { sizeData(); }
+    void insert_int() { insert_template<quint64>(); }
+    void insert_string_data() { sizeData(10000000); }
+    void insert_string() { insert_template<QString>(); }
+    void lookupHit_int_data() { sizeData(); }
+    void lookupHit_int() { lookup_template<quint64>(true); }
+    void lookupHit_string_data() { sizeData(10000000); }
+    void lookupHit_string() { lookup_template<QString>(true); }
+    void lookupMiss_int_data() { sizeData(); }
+    void lookupMiss_int() { lookup_template<quint64>(false); }
+    void lookupMiss_string_data() { sizeData(10000000); }
+    void lookupMiss_string() { lookup_template<QString>(false); }
+
 private:
     void data();
+    void sizeData(int limit = INT_MAX);
+    template <typename Key> void insert_template();
+    template <typename Key> void lookup_template(bool hit);
     template <typename String> void qhash_template();
     template <typename String> void hashing_template();
 
@@ -112,6 +130,68 @@ void tst_QHash::data()
     QTest::newRow("numbers") << numbers;
 }
 
+void tst_QHash::sizeData(int limit)
+{
+    QTest::addColumn<int>("size");
+    for (int size : { 1000, 10000, 100000, 1000000, 10000000 }) {
+        if (size >= limit)
+            break;
+        QTest::addRow("%d", size) << size;
+    }
+}
+
+template <typename Key> static Key makeKey(quint64 n);
+template <> quint64 makeKey<quint64>(quint64 n) { return n; }
+template <> QString makeKey<QString>(quint64 n) { return QString::number(n, 36); }
+
+// returns size distinct keys, the first half of which is used for the hits and
+// the second half for the misses
+template <typename Key> static QList<Key> makeKeys(int size)
+{
+    QRandomGenerator generator(size);
+    QSet<quint64> seen;
+    seen.reserve(2 * size);
+    QList<Key> keys;
+    keys.reserve(2 * size);
+    while (keys.size() < 2 * size) {
+        const quint64 n = generator.generate64();
+        if (!seen.contains(n)) {
+            seen.insert(n);
+            keys.append(makeKey<Key>(n));
+        }
+    }
+    return keys;
+}
+
+template <typename Key> void tst_QHash::insert_template()
+{
+    QFETCH(int, size);
+    const QList<Key> keys = makeKeys<Key>(size);
+
+    QBENCHMARK {
+        QHash<Key, int> hash;
+        for (int i = 0; i < size; ++i)
+            hash.insert(keys.at(i), i);
+    }
+}
+
+template <typename Key> void tst_QHash::lookup_template(bool hit)
+{
+    QFETCH(int, size);
+    const QList<Key> keys = makeKeys<Key>(size);
+    QHash<Key, int> hash;
+    for (int i = 0; i < size; ++i)
+        hash.insert(keys.at(i), i);
+
+    const int first = hit ? 0 : size;
+    int found = 0;
+    QBENCHMARK {
+        for (int i = first; i < first + size; ++i)
+            found += hash.contains(keys.at(i));
+    }
+    QCOMPARE(found > 0, hit);
+}
+
 template <typename String> void tst_QHash::qhash_template()
 {
     QFETCH(QStringList, items);
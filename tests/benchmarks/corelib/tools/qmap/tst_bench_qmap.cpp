@@ -1,8 +1,10 @@
 // Copyright (C) 2021 The Qt Company Ltd.
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
 
+#include <QBTreeMap>
 #include <QFile>
 #include <QMap>
+#include <QRandomGenerator>
 #include <QString>
 #include <QTest>
 #include <qdebug.h>
@@ -37,7 +39,17 @@ private slots:
 
     void insertMap();
 
+    void compareInsertion_data() { compare_data(); }
+    void compareInsertion();
+    void compareLookup_data() { compare_data(); }
+    void compareLookup();
+    void compareIteration_data() { compare_data(); }
+    void compareIteration();
+    void compareDetach_data() { compare_data(); }
+    void compareDetach();
+
 private:
+    void compare_data();
     QStringList helloEachWorld(int count);
 };
 
@@ -299,6 +311,114 @@ void tst_QMap::insertMap()
     }
 }
 
+// QMap compared with QBTreeMap, with the settings-like QString keys and
+// QVariant values of QVariantMap, inserted in random order
+
+void tst_QMap::compare_data()
+{
+    QTest::addColumn<bool>("btree");
+    QTest::addColumn<int>("size");
+
+    for (int size : {100, 10000, 1000000}) {
+        QTest::addRow("QMap:%d", size) << false << size;
+        QTest::addRow("QBTreeMap:%d", size) << true << size;
+    }
+}
+
+static QStringList shuffledKeys(int size)
+{
+    QStringList keys;
+    keys.reserve(size);
+    for (int i = 0; i < size; ++i)
+        keys.append(QStringLiteral("group%1/key%2").arg(i % 97).arg(i));
+    std::shuffle(keys.begin(), keys.end(), QRandomGenerator(size));
+    return keys;
+}
+
+template <typename Map>
+static Map filledMap(const QStringList &keys)
+{
+    Map map;
+    for (int i = 0; i < keys.size(); ++i)
+        map.insert(keys.at(i), QVariant(i));
+    return map;
+}
+
+template <typename Map>
+static void benchInsertion(const QStringList &keys)
+{
+    QBENCHMARK {
+        Map map = filledMap<Map>(keys);
+        QCOMPARE(map.size(), keys.size());
+    }
+}
+
+template <typename Map>
+static void benchLookup(const QStringList &keys)
+{
+    const Map map = filledMap<Map>(keys);
+    qsizetype found = 0;
+    QBENCHMARK {
+        for (const QString &key : keys)
+            found += map.contains(key);
+    }
+    QVERIFY(found >= keys.size());
+}
+
+template <typename Map>
+static void benchIteration(const QStringList &keys)
+{
+    const Map map = filledMap<Map>(keys);
+    qsizetype sum = 0;
+    QBENCHMARK {
+        for (auto it = map.cbegin(); it != map.cend(); ++it)
+            sum += it.key().size() + it.value().typeId();
+    }
+    QVERIFY(sum > 0);
+}
+
+template <typename Map>
+static void benchDetach(const QStringList &keys)
+{
+    const Map map = filledMap<Map>(keys);
+    QBENCHMARK {
+        Map copy = map;
+        copy.insert(QString(), QVariant());
+        QCOMPARE(copy.size(), map.size() + 1);
+    }
+}
+
+#define DISPATCH(function) \
+    QFETCH(bool, btree); \
+    QFETCH(int, size); \
+    const QStringList keys = shuffledKeys(size); \
+    if (btree) \
+        function<QBTreeMap<QString, QVariant>>(keys); \
+    else \
+        function<QMap<QString, QVariant>>(keys)
+
+void tst_QMap::compareInsertion()
+{
+    DISPATCH(benchInsertion);
+}
+
+void tst_QMap::compareLookup()
+{
+    DISPATCH(benchLookup);
+}
+
+void tst_QMap::compareIteration()
+{
+    DISPATCH(benchIteration);
+}
+
+void tst_QMap::compareDetach()
+{
+    DISPATCH(benchDetach);
+}
+
+#undef DISPATCH
+
 QTEST_MAIN(tst_QMap)
 
 #include "tst_bench_qmap.moc"